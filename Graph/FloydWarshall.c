@@ -17,6 +17,8 @@
 		}							\
 	} while (0)
 
+#include "apsp.h"
+
 typedef struct
 {
     int** matrix; /* Matricea de adiacenta a grafului */
@@ -129,6 +131,67 @@ void floydWarshall(matrix_graph_t* mg)
     free(dist);
 }
 
+/*
+ * Converteste matricea de adiacenta in formatul apsp_t (o celula nenula
+ * este o muchie cu costul respectiv).
+ */
+apsp_t *
+mg_to_apsp(matrix_graph_t* mg, int with_next)
+{
+    apsp_t *a = apsp_create(mg->nodes, with_next);
+
+    for (int i = 0; i < mg->nodes; i++)
+        for (int j = 0; j < mg->nodes; j++)
+            if (mg->matrix[i][j])
+                apsp_set_edge(a, i, j, mg->matrix[i][j]);
+
+    return a;
+}
+
+/*
+ * Varianta pe blocuri si pe mai multe thread-uri (apsp.h). Afiseaza matricea
+ * in acelasi format ca floydWarshall, cu diferenta ca distanta de la un nod
+ * la el insusi este 0.
+ */
+void floydWarshallBlocked(matrix_graph_t* mg)
+{
+    thread_pool_t *tp = tp_create(0);
+    apsp_t *a = mg_to_apsp(mg, 0);
+
+    apsp_solve(a, tp);
+
+    for (int i = 0; i < mg->nodes; i++) {
+        for (int j = 0; j < mg->nodes; j++)
+            printf("%d ", apsp_dist(a, i, j) == APSP_INF ? -1 : apsp_dist(a, i, j));
+        printf("\n");
+    }
+
+    apsp_free(a);
+    tp_free(tp);
+}
+
+/* Afiseaza drumul minim src -> dest, reconstruit din matricea next */
+void floydWarshallPath(matrix_graph_t* mg, int src, int dest)
+{
+    thread_pool_t *tp = tp_create(0);
+    apsp_t *a = mg_to_apsp(mg, 1);
+    int *path = malloc(mg->nodes * sizeof(int));
+    DIE(!path, "malloc() failed\n");
+
+    apsp_solve(a, tp);
+
+    int len = apsp_path(a, src, dest, path);
+    if (!len)
+        printf("No path found");
+    for (int i = 0; i < len; i++)
+        printf("%d ", path[i]);
+    printf("\n");
+
+    free(path);
+    apsp_free(a);
+    tp_free(tp);
+}
+
 int main()
 {
     
@@ -157,6 +220,27 @@ int main()
             }
         }
         
+        if (strncmp(command, "floyd_blocked", 13) == 0) {
+            if (mg != NULL) {
+                floydWarshallBlocked(mg);
+            } else {
+                printf("Create a graph first!\n");
+                exit(0);
+            }
+            continue;
+        }
+
+        if (strncmp(command, "floyd_path", 10) == 0) {
+            if (mg != NULL) {
+                scanf("%d %d", &nr1, &nr2);
+                floydWarshallPath(mg, nr1, nr2);
+            } else {
+                printf("Create a graph first!\n");
+                exit(0);
+            }
+            continue;
+        }
+
         if (strncmp(command, "floyd", 3) == 0) {
             if (mg != NULL) {
                 floydWarshall(mg);
@@ -0,0 +1,355 @@
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+#include "apsp.h"
+
+/*
+ * Aloca matricea pentru nodes noduri, fara muchii: dist[i][i] = 0 si
+ * APSP_INF in rest. Daca with_next este nenul se aloca si matricea next.
+ */
+apsp_t *
+apsp_create(int nodes, int with_next)
+{
+	apsp_t *a = malloc(sizeof(*a));
+	DIE(!a, "malloc() failed\n");
+
+	a->nodes = nodes;
+	a->stride = (nodes + APSP_TILE - 1) / APSP_TILE * APSP_TILE;
+	if (!a->stride)
+		a->stride = APSP_TILE;
+
+	size_t cells = (size_t)a->stride * a->stride;
+	a->dist = aligned_alloc(64, cells * sizeof(int));
+	DIE(!a->dist, "aligned_alloc() failed\n");
+	for (size_t c = 0; c < cells; c++)
+		a->dist[c] = APSP_INF;
+
+	a->next = NULL;
+	if (with_next) {
+		a->next = aligned_alloc(64, cells * sizeof(int));
+		DIE(!a->next, "aligned_alloc() failed\n");
+		memset(a->next, 0xff, cells * sizeof(int));
+	}
+
+	for (int i = 0; i < nodes; i++) {
+		a->dist[(size_t)i * a->stride + i] = 0;
+		if (a->next)
+			a->next[(size_t)i * a->stride + i] = i;
+	}
+
+	return a;
+}
+
+/* Construieste matricea din muchiile unui graf CSR (fara costuri: cost 1) */
+apsp_t *
+apsp_from_csr(const csr_graph_t *g, int with_next)
+{
+	apsp_t *a = apsp_create(g->nodes, with_next);
+
+	for (int u = 0; u < g->nodes; u++)
+		for (long e = g->offsets[u]; e < g->offsets[u + 1]; e++)
+			apsp_set_edge(a, u, g->targets[e], g->weights ? g->weights[e] : 1);
+
+	return a;
+}
+
+/* Adauga muchia src -> dest; dintre muchiile paralele o pastreaza pe cea mai
+ * ieftina */
+void
+apsp_set_edge(apsp_t *a, int src, int dest, int cost)
+{
+	DIE(src < 0 || src >= a->nodes || dest < 0 || dest >= a->nodes,
+		"node out of range\n");
+	DIE(cost < 0, "negative edge cost\n");
+
+	size_t c = (size_t)src * a->stride + dest;
+	if (cost >= APSP_INF || cost >= a->dist[c])
+		return;
+
+	a->dist[c] = cost;
+	if (a->next)
+		a->next[c] = dest;
+}
+
+/*
+ * c[j] = min(c[j], aik + b[j]) pentru j < APSP_TILE, cu adunare saturata la
+ * APSP_INF. Cum aik si b[j] sunt cel mult APSP_INF = INT_MAX / 2, suma nu
+ * depaseste int.
+ */
+static inline void
+min_plus_row(int *restrict c, const int *restrict b, int aik)
+{
+#if defined(__AVX2__)
+	__m256i va = _mm256_set1_epi32(aik);
+	__m256i inf = _mm256_set1_epi32(APSP_INF);
+
+	for (int j = 0; j < APSP_TILE; j += 8) {
+		__m256i vb = _mm256_load_si256((const __m256i *)(b + j));
+		__m256i vc = _mm256_load_si256((const __m256i *)(c + j));
+		__m256i s = _mm256_min_epi32(_mm256_add_epi32(va, vb), inf);
+		_mm256_store_si256((__m256i *)(c + j), _mm256_min_epi32(vc, s));
+	}
+#elif defined(__SSE4_1__)
+	__m128i va = _mm_set1_epi32(aik);
+	__m128i inf = _mm_set1_epi32(APSP_INF);
+
+	for (int j = 0; j < APSP_TILE; j += 4) {
+		__m128i vb = _mm_load_si128((const __m128i *)(b + j));
+		__m128i vc = _mm_load_si128((const __m128i *)(c + j));
+		__m128i s = _mm_min_epi32(_mm_add_epi32(va, vb), inf);
+		_mm_store_si128((__m128i *)(c + j), _mm_min_epi32(vc, s));
+	}
+#else
+	for (int j = 0; j < APSP_TILE; j++) {
+		int s = aik + b[j];
+		if (s > APSP_INF)
+			s = APSP_INF;
+		if (s < c[j])
+			c[j] = s;
+	}
+#endif
+}
+
+/*
+ * Ca min_plus_row, dar unde distanta scade se actualizeaza si next:
+ * drumul i -> j trece acum prin k, deci incepe ca drumul i -> k (nik).
+ */
+static inline void
+min_plus_row_next(int *restrict c, int *restrict nc, const int *restrict b,
+				  int aik, int nik)
+{
+#if defined(__AVX2__)
+	__m256i va = _mm256_set1_epi32(aik);
+	__m256i vn = _mm256_set1_epi32(nik);
+	__m256i inf = _mm256_set1_epi32(APSP_INF);
+
+	for (int j = 0; j < APSP_TILE; j += 8) {
+		__m256i vb = _mm256_load_si256((const __m256i *)(b + j));
+		__m256i vc = _mm256_load_si256((const __m256i *)(c + j));
+		__m256i s = _mm256_min_epi32(_mm256_add_epi32(va, vb), inf);
+		__m256i better = _mm256_cmpgt_epi32(vc, s);
+		__m256i old = _mm256_load_si256((const __m256i *)(nc + j));
+
+		_mm256_store_si256((__m256i *)(c + j), _mm256_min_epi32(vc, s));
+		_mm256_store_si256((__m256i *)(nc + j),
+						   _mm256_blendv_epi8(old, vn, better));
+	}
+#elif defined(__SSE4_1__)
+	__m128i va = _mm_set1_epi32(aik);
+	__m128i vn = _mm_set1_epi32(nik);
+	__m128i inf = _mm_set1_epi32(APSP_INF);
+
+	for (int j = 0; j < APSP_TILE; j += 4) {
+		__m128i vb = _mm_load_si128((const __m128i *)(b + j));
+		__m128i vc = _mm_load_si128((const __m128i *)(c + j));
+		__m128i s = _mm_min_epi32(_mm_add_epi32(va, vb), inf);
+		__m128i better = _mm_cmpgt_epi32(vc, s);
+		__m128i old = _mm_load_si128((const __m128i *)(nc + j));
+
+		_mm_store_si128((__m128i *)(c + j), _mm_min_epi32(vc, s));
+		_mm_store_si128((__m128i *)(nc + j), _mm_blendv_epi8(old, vn, better));
+	}
+#else
+	for (int j = 0; j < APSP_TILE; j++) {
+		int s = aik + b[j];
+		if (s > APSP_INF)
+			s = APSP_INF;
+		if (s < c[j]) {
+			c[j] = s;
+			nc[j] = nik;
+		}
+	}
+#endif
+}
+
+/*
+ * Actualizeaza blocul (ib, jb) cu nodurile intermediare din blocul kb:
+ * C = (ib, jb), A = (ib, kb), B = (kb, jb). Cu k in bucla exterioara
+ * rezultatul este corect si cand C coincide cu A sau B (linia si coloana k
+ * nu se schimba la pasul k, pentru ca dist[k][k] = 0).
+ */
+static void
+update_tile(apsp_t *a, int ib, int jb, int kb)
+{
+	long stride = a->stride;
+	int i_end = (ib + 1) * APSP_TILE < a->nodes ? (ib + 1) * APSP_TILE : a->nodes;
+	int k_end = (kb + 1) * APSP_TILE < a->nodes ? (kb + 1) * APSP_TILE : a->nodes;
+	long col = (long)jb * APSP_TILE;
+
+	for (int k = kb * APSP_TILE; k < k_end; k++) {
+		const int *b = a->dist + k * stride + col;
+
+		for (int i = ib * APSP_TILE; i < i_end; i++) {
+			int aik = a->dist[i * stride + k];
+
+			/* Linia k nu se schimba la pasul k */
+			if (aik >= APSP_INF || i == k)
+				continue;
+
+			if (a->next)
+				min_plus_row_next(a->dist + i * stride + col,
+								  a->next + i * stride + col, b, aik,
+								  a->next[i * stride + k]);
+			else
+				min_plus_row(a->dist + i * stride + col, b, aik);
+		}
+	}
+}
+
+/*
+ * update_tile pentru un bloc C diferit de A si B (faza 3, unde se face
+ * aproape toata munca). Ordinea buclelor nu mai conteaza, asa ca pentru
+ * fiecare linie i din C linia se tine in registre cat timp se parcurg toti
+ * k; se citesc doar liniile din B, iar C se scrie o singura data.
+ */
+static void
+update_tile_disjoint(apsp_t *a, int ib, int jb, int kb)
+{
+	long stride = a->stride;
+	int i_end = (ib + 1) * APSP_TILE < a->nodes ? (ib + 1) * APSP_TILE : a->nodes;
+	int k_begin = kb * APSP_TILE;
+	int k_end = k_begin + APSP_TILE < a->nodes ? k_begin + APSP_TILE : a->nodes;
+	long col = (long)jb * APSP_TILE;
+
+	if (a->next) {
+		update_tile(a, ib, jb, kb);
+		return;
+	}
+
+	for (int i = ib * APSP_TILE; i < i_end; i++) {
+		const int *arow = a->dist + i * stride;
+		int *c = a->dist + i * stride + col;
+#if defined(__AVX2__)
+		__m256i inf = _mm256_set1_epi32(APSP_INF);
+		__m256i acc[APSP_TILE / 8];
+
+		for (int j = 0; j < APSP_TILE / 8; j++)
+			acc[j] = _mm256_load_si256((const __m256i *)c + j);
+
+		for (int k = k_begin; k < k_end; k++) {
+			if (arow[k] >= APSP_INF)
+				continue;
+
+			__m256i va = _mm256_set1_epi32(arow[k]);
+			const __m256i *b = (const __m256i *)(a->dist + k * stride + col);
+			for (int j = 0; j < APSP_TILE / 8; j++) {
+				__m256i s = _mm256_add_epi32(va, _mm256_load_si256(b + j));
+				acc[j] = _mm256_min_epi32(acc[j], _mm256_min_epi32(s, inf));
+			}
+		}
+
+		for (int j = 0; j < APSP_TILE / 8; j++)
+			_mm256_store_si256((__m256i *)c + j, acc[j]);
+#else
+		for (int k = k_begin; k < k_end; k++)
+			if (arow[k] < APSP_INF)
+				min_plus_row(c, a->dist + k * stride + col, arow[k]);
+#endif
+	}
+}
+
+typedef struct apsp_phase_t apsp_phase_t;
+struct apsp_phase_t
+{
+	apsp_t *a;
+	int kb;
+	int tiles;
+};
+
+/*
+ * Faza 2: blocurile de pe linia kb (indicii 0 .. tiles - 2) si de pe
+ * coloana kb (indicii tiles - 1 .. 2 * tiles - 3), fara blocul diagonal.
+ */
+static void
+phase2_range(void *arg, long lo, long hi)
+{
+	apsp_phase_t *p = arg;
+
+	for (long t = lo; t < hi; t++) {
+		int other = t % (p->tiles - 1);
+		other += other >= p->kb;
+
+		if (t < p->tiles - 1)
+			update_tile(p->a, p->kb, other, p->kb);
+		else
+			update_tile(p->a, other, p->kb, p->kb);
+	}
+}
+
+/* Faza 3: toate blocurile care nu sunt pe linia sau coloana kb */
+static void
+phase3_range(void *arg, long lo, long hi)
+{
+	apsp_phase_t *p = arg;
+
+	for (long t = lo; t < hi; t++) {
+		int ib = t / (p->tiles - 1), jb = t % (p->tiles - 1);
+		ib += ib >= p->kb;
+		jb += jb >= p->kb;
+		update_tile_disjoint(p->a, ib, jb, p->kb);
+	}
+}
+
+/*
+ * Calculeaza toate distantele minime. tp poate fi NULL; atunci totul
+ * ruleaza pe thread-ul apelant.
+ */
+void
+apsp_solve(apsp_t *a, thread_pool_t *tp)
+{
+	apsp_phase_t p = {
+		.a = a,
+		.tiles = (a->nodes + APSP_TILE - 1) / APSP_TILE,
+	};
+	long side = p.tiles - 1;
+
+	for (p.kb = 0; p.kb < p.tiles; p.kb++) {
+		update_tile(a, p.kb, p.kb, p.kb);
+
+		if (!side)
+			continue;
+
+		if (tp) {
+			tp_parallel_for(tp, 0, 2 * side, 1, phase2_range, &p);
+			tp_parallel_for(tp, 0, side * side, 1, phase3_range, &p);
+		} else {
+			phase2_range(&p, 0, 2 * side);
+			phase3_range(&p, 0, side * side);
+		}
+	}
+}
+
+/*
+ * Scrie in path nodurile drumului minim src -> dest (inclusiv capetele) si
+ * intoarce numarul lor, 0 daca nu exista drum. Necesita matricea next;
+ * path trebuie sa aiba loc pentru a->nodes noduri.
+ */
+int
+apsp_path(const apsp_t *a, int src, int dest, int *path)
+{
+	DIE(!a->next, "next-hop matrix was not requested\n");
+
+	if (apsp_dist(a, src, dest) >= APSP_INF)
+		return 0;
+
+	int len = 0;
+	path[len++] = src;
+	while (src != dest) {
+		src = a->next[(long)src * a->stride + dest];
+		path[len++] = src;
+	}
+
+	return len;
+}
+
+void
+apsp_free(apsp_t *a)
+{
+	if (!a)
+		return;
+
+	free(a->dist);
+	free(a->next);
+	free(a);
+}
@@ -0,0 +1,66 @@
+#ifndef APSP_H
+#define APSP_H
+
+#include <limits.h>
+
+#include "csr_graph.h"
+#include "thread_pool.h"
+
+/*
+ * Drumuri minime intre toate perechile de noduri (Floyd-Warshall) pe blocuri.
+ *
+ * Matricea de distante este un singur vector row-major, aliniat la 64 de
+ * octeti, cu liniile completate pana la un multiplu de APSP_TILE. Pentru
+ * fiecare bloc de APSP_TILE noduri intermediare k se actualizeaza intai
+ * blocul diagonal, apoi blocurile de pe linia si coloana lui (independente
+ * intre ele) si apoi restul blocurilor (tot independente). Un bloc are
+ * APSP_TILE x APSP_TILE elemente si sta in cache cat timp este folosit,
+ * iar blocurile independente se impart pe thread-urile pool-ului.
+ *
+ * Adunarile sunt saturate: APSP_INF + x ramane APSP_INF, deci nu apar
+ * depasiri ca la INF + INF in FloydWarshall.c. Costurile trebuie sa fie
+ * nenegative, iar un drum mai lung de APSP_INF este considerat inexistent.
+ *
+ * Optional se construieste si matricea next: next[i][j] este primul nod
+ * dupa i pe drumul minim i -> j (-1 daca nu exista drum), din care
+ * apsp_path reconstruieste drumul.
+ */
+
+#define APSP_INF (INT_MAX / 2)
+#define APSP_TILE 64
+
+typedef struct apsp_t apsp_t;
+struct apsp_t
+{
+	int nodes;
+	int stride;         /* nodes rotunjit in sus la multiplu de APSP_TILE */
+	int *dist;          /* dist[i * stride + j] */
+	int *next;          /* La fel, sau NULL */
+};
+
+apsp_t *
+apsp_create(int nodes, int with_next);
+
+apsp_t *
+apsp_from_csr(const csr_graph_t *g, int with_next);
+
+void
+apsp_set_edge(apsp_t *a, int src, int dest, int cost);
+
+void
+apsp_solve(apsp_t *a, thread_pool_t *tp);
+
+int
+apsp_path(const apsp_t *a, int src, int dest, int *path);
+
+void
+apsp_free(apsp_t *a);
+
+/* Distanta minima src -> dest, APSP_INF daca nu exista drum */
+static inline int
+apsp_dist(const apsp_t *a, int src, int dest)
+{
+	return a->dist[(long)src * a->stride + dest];
+}
+
+#endif
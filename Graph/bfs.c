@@ -17,6 +17,12 @@
 		}							\
 	} while (0)
 
+#include "csr_graph.h"
+#include "bfs_parallel.h"
+#include "reorder.h"
+#include "compressed_graph.h"
+#include "graph_loader.h"
+
 typedef struct ll_node_t ll_node_t;
 struct ll_node_t
 {
@@ -348,6 +354,8 @@ lg_create(int nodes)
         graph->neighbors[i] = ll_create(sizeof(int));
     
     graph->nodes = nodes;
+
+    return graph;
 }
 
 /* Adauga o muchie intre nodurile primite ca parametri */
@@ -443,11 +451,138 @@ bfs_list_graph(list_graph_t* lg, int node)
     free(parent);
 }
 
-int main()
+/*
+ * Construieste reprezentarea CSR a grafului. Vecinii fiecarui nod raman in
+ * ordinea din lista de adiacenta.
+ */
+csr_graph_t*
+lg_to_csr(list_graph_t* lg)
+{
+	long edges = 0;
+
+	for (int i = 0; i < lg->nodes; i++)
+		edges += lg->neighbors[i]->size;
+
+	csr_graph_t* g = csr_alloc(lg->nodes, edges, 0);
+	for (int i = 0; i < lg->nodes; i++) {
+		long e = g->offsets[i];
+		g->offsets[i + 1] = e + lg->neighbors[i]->size;
+		for (ll_node_t* it = lg->neighbors[i]->head; it; it = it->next)
+			g->targets[e++] = *(int *)it->data;
+	}
+
+	return g;
+}
+
+/*
+ * Acelasi BFS ca bfs_list_graph, pe un graf CSR. Fiecare nod intra in coada
+ * cel mult o data, asa ca un vector de g->nodes int-uri e suficient drept
+ * coada, fara nicio alocare per element.
+ */
+void
+bfs_csr_graph(csr_graph_t* g, int node)
+{
+	int *queue = malloc(g->nodes * sizeof(int));
+	DIE(!queue, "malloc() failed\n");
+
+	char *status = calloc(g->nodes, sizeof(char));
+	DIE(!status, "calloc() failed\n");
+
+	int head = 0, tail = 0;
+
+	status[node] = 1;
+	queue[tail++] = node;
+
+	while (head < tail) {
+		int x = queue[head++];
+		printf("%d ", x);
+
+		const int *neigh = csr_neighbors(g, x);
+		for (long i = 0, deg = csr_degree(g, x); i < deg; i++) {
+			if (!status[neigh[i]]) {
+				status[neigh[i]] = 1;
+				queue[tail++] = neigh[i];
+			}
+		}
+	}
+
+	printf("\n");
+	free(queue);
+	free(status);
+}
+
+/*
+ * Afiseaza rezultatul unui BFS: nodurile atinse in ordinea nivelurilor (pe
+ * acelasi nivel, crescator), apoi pe cate o linie "nod nivel parinte".
+ * Nodurile se grupeaza pe niveluri printr-o sortare prin numarare, in
+ * O(nodes + adancime); level[v] < 0 pentru nodurile neatinse.
+ */
+static void
+print_bfs_levels(int nodes, const int *level, const int *parent)
+{
+	int depth = 0, reached = 0;
+
+	for (int v = 0; v < nodes; v++) {
+		if (level[v] >= depth)
+			depth = level[v] + 1;
+		reached += level[v] >= 0;
+	}
+
+	/* start[d] = pozitia primului nod de pe nivelul d in sorted */
+	int *start = calloc(depth + 1, sizeof(int));
+	int *sorted = malloc((nodes ? nodes : 1) * sizeof(int));
+	DIE(!start || !sorted, "malloc() failed\n");
+
+	for (int v = 0; v < nodes; v++)
+		if (level[v] >= 0)
+			start[level[v] + 1]++;
+	for (int d = 0; d < depth; d++)
+		start[d + 1] += start[d];
+	for (int v = 0; v < nodes; v++)
+		if (level[v] >= 0)
+			sorted[start[level[v]]++] = v;
+
+	for (int i = 0; i < reached; i++)
+		printf("%d ", sorted[i]);
+	printf("\n");
+
+	for (int v = 0; v < nodes; v++)
+		if (level[v] >= 0)
+			printf("%d %d %d\n", v, level[v], parent[v]);
+
+	free(start);
+	free(sorted);
+}
+
+/*
+ * "bfs file <cale> <nod>": graful orientat este incarcat cu gl_load (prima
+ * linie "n m", apoi muchiile, sau formatul binar) si se face BFS-ul paralel,
+ * afisat ca la bfs_par. Fara argumente se citesc comenzi de la intrarea
+ * standard.
+ */
+int main(int argc, char *argv[])
 {
 
 	list_graph_t *lg = NULL;
 
+	if (argc > 1 && strcmp(argv[1], "file") == 0) {
+		DIE(argc < 4, "usage: bfs file <path> <node>\n");
+		thread_pool_t *tp = tp_create(0);
+		csr_graph_t *g = gl_load(argv[2], GL_HEADER, tp);
+		int start_node = atoi(argv[3]);
+		DIE(start_node < 0 || start_node >= g->nodes, "node out of range\n");
+
+		csr_graph_t *gt = csr_transpose(g);
+		bfs_result_t *r = bfs_parallel(tp, g, gt, start_node);
+		print_bfs_levels(r->nodes, r->level, r->parent);
+
+		bfs_result_free(r);
+		csr_free(gt);
+		csr_free(g);
+		tp_free(tp);
+		return 0;
+	}
+
 	while (1) {
 		char command[MAX_STRING_SIZE];
 		int nr1, nr2;
@@ -471,6 +606,125 @@ int main()
 			}
 		}
 
+		/*
+		 * BFS paralel: afiseaza nodurile atinse in ordinea nivelurilor (pe
+		 * acelasi nivel, crescator), apoi pe cate o linie "nod nivel parinte"
+		 */
+		if (strncmp(command, "bfs_par", 7) == 0) {
+			if (lg != NULL) {
+				scanf("%d", &start_node);
+				DIE(start_node < 0 || start_node >= lg->nodes,
+					"node out of range\n");
+
+				csr_graph_t *g = lg_to_csr(lg);
+				csr_graph_t *gt = csr_transpose(g);
+				thread_pool_t *tp = tp_create(0);
+				bfs_result_t *r = bfs_parallel(tp, g, gt, start_node);
+
+				print_bfs_levels(r->nodes, r->level, r->parent);
+
+				bfs_result_free(r);
+				tp_free(tp);
+				csr_free(gt);
+				csr_free(g);
+			} else {
+				printf("Create a graph first!\n");
+				exit(0);
+			}
+			continue;
+		}
+
+		/*
+		 * "bfs_reorder rcm|degree|bfs nod": BFS paralel pe graful
+		 * renumerotat (reorder.h); nivelurile si parintii sunt traduse
+		 * inapoi, deci afisarea este ca la bfs_par
+		 */
+		if (strncmp(command, "bfs_reorder", 11) == 0) {
+			if (lg != NULL) {
+				char kind_name[MAX_STRING_SIZE];
+				reorder_kind_t kind;
+
+				scanf("%s %d", kind_name, &start_node);
+				DIE(!reorder_parse_kind(kind_name, &kind),
+					"unknown reordering\n");
+				DIE(start_node < 0 || start_node >= lg->nodes,
+					"node out of range\n");
+
+				csr_graph_t *g = lg_to_csr(lg);
+				reorder_t *ro = reorder_compute(g, kind);
+				csr_graph_t *h = reorder_apply(g, ro);
+				csr_graph_t *ht = csr_transpose(h);
+				thread_pool_t *tp = tp_create(0);
+				bfs_result_t *r = bfs_parallel(tp, h, ht,
+											   ro->new_id[start_node]);
+
+				int *level = malloc(g->nodes * sizeof(int));
+				int *parent = malloc(g->nodes * sizeof(int));
+				DIE(!level || !parent, "malloc() failed\n");
+				reorder_to_old(ro, r->level, level, 0);
+				reorder_to_old(ro, r->parent, parent, 1);
+
+				print_bfs_levels(g->nodes, level, parent);
+
+				free(level);
+				free(parent);
+				bfs_result_free(r);
+				tp_free(tp);
+				csr_free(ht);
+				csr_free(h);
+				reorder_free(ro);
+				csr_free(g);
+			} else {
+				printf("Create a graph first!\n");
+				exit(0);
+			}
+			continue;
+		}
+
+		/*
+		 * "bfs_compressed nod": BFS pe graful comprimat
+		 * (compressed_graph.h), afisat ca la bfs_par
+		 */
+		if (strncmp(command, "bfs_compressed", 14) == 0) {
+			if (lg != NULL) {
+				scanf("%d", &start_node);
+				DIE(start_node < 0 || start_node >= lg->nodes,
+					"node out of range\n");
+
+				csr_graph_t *g = lg_to_csr(lg);
+				compressed_graph_t *c = cg_from_csr(g);
+				int *level = malloc(g->nodes * sizeof(int));
+				int *parent = malloc(g->nodes * sizeof(int));
+				DIE(!level || !parent, "malloc() failed\n");
+
+				cg_bfs(c, start_node, level, parent);
+				print_bfs_levels(g->nodes, level, parent);
+
+				free(level);
+				free(parent);
+				cg_free(c);
+				csr_free(g);
+			} else {
+				printf("Create a graph first!\n");
+				exit(0);
+			}
+			continue;
+		}
+
+		if (strncmp(command, "bfs_csr", 7) == 0) {
+			if (lg != NULL) {
+				scanf("%d", &start_node);
+
+				csr_graph_t *g = lg_to_csr(lg);
+				bfs_csr_graph(g, start_node);
+				csr_free(g);
+			} else {
+				printf("Create a graph first!\n");
+				exit(0);
+			}
+			continue;
+		}
+
 		if (strncmp(command, "bfs", 3) == 0) {
 			int color[nr_nodes], parent[nr_nodes];
 			
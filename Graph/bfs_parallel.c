@@ -0,0 +1,313 @@
+#include "bfs_parallel.h"
+
+/* Nodurile descoperite se strang local si se copiaza in coada pe bucati */
+#define BFS_LOCAL_BUF 256
+/* Cate noduri (sau cuvinte din bitmap) primeste cel putin un task */
+#define BFS_GRAIN 1024
+#define BFS_WORD_GRAIN 64
+
+typedef _Atomic uint64_t bfs_word_t;
+
+typedef struct bfs_state_t bfs_state_t;
+struct bfs_state_t
+{
+	const csr_graph_t *g;
+	const csr_graph_t *gt;
+	int *parent;
+	int *level;
+	int depth;
+	long words;
+
+	/* Nodurile vizitate si frontiera (pentru bottom-up) */
+	bfs_word_t *visited;
+	bfs_word_t *front;
+	bfs_word_t *next;
+
+	/* Frontiera curenta si urmatoarea (pentru top-down) */
+	int *queue;
+	int *next_queue;
+	atomic_long next_size;
+
+	/* Suma gradelor nodurilor adaugate in frontiera urmatoare */
+	atomic_long next_edges;
+};
+
+static inline int
+test_bit(bfs_word_t *bm, int v)
+{
+	return (atomic_load_explicit(&bm[v >> 6], memory_order_relaxed) >> (v & 63))
+		   & 1;
+}
+
+/* Seteaza bitul v si intoarce 1 daca inainte nu era setat */
+static inline int
+claim_bit(bfs_word_t *bm, int v)
+{
+	uint64_t mask = (uint64_t)1 << (v & 63);
+
+	if (atomic_load_explicit(&bm[v >> 6], memory_order_relaxed) & mask)
+		return 0;
+	return !(atomic_fetch_or_explicit(&bm[v >> 6], mask, memory_order_relaxed)
+			 & mask);
+}
+
+/* Copiaza nodurile din buf la sfarsitul cozii pentru nivelul urmator */
+static void
+flush_local(bfs_state_t *s, const int *buf, int n, long edges)
+{
+	if (!n)
+		return;
+
+	long pos = atomic_fetch_add_explicit(&s->next_size, n,
+										 memory_order_relaxed);
+	memcpy(s->next_queue + pos, buf, n * sizeof(int));
+	atomic_fetch_add_explicit(&s->next_edges, edges, memory_order_relaxed);
+}
+
+/*
+ * Top-down pe queue[lo, hi): un vecin nevizitat este revendicat atomic in
+ * bitmap-ul visited, deci fiecare nod primeste un singur parinte.
+ */
+static void
+top_down_range(void *arg, long lo, long hi)
+{
+	bfs_state_t *s = arg;
+	int buf[BFS_LOCAL_BUF];
+	int n = 0;
+	long edges = 0;
+
+	for (long i = lo; i < hi; i++) {
+		int u = s->queue[i];
+		const int *neigh = csr_neighbors(s->g, u);
+
+		for (long j = 0, deg = csr_degree(s->g, u); j < deg; j++) {
+			int v = neigh[j];
+
+			if (!claim_bit(s->visited, v))
+				continue;
+
+			s->parent[v] = u;
+			s->level[v] = s->depth;
+			edges += csr_degree(s->g, v);
+			buf[n++] = v;
+			if (n == BFS_LOCAL_BUF) {
+				flush_local(s, buf, n, edges);
+				n = 0;
+				edges = 0;
+			}
+		}
+	}
+
+	flush_local(s, buf, n, edges);
+}
+
+/*
+ * Bottom-up pe cuvintele [lo, hi) din bitmap-uri. Fiecare task scrie doar in
+ * cuvintele lui din next, iar nodul v este scris doar de task-ul care il
+ * contine, deci nu e nevoie de operatii atomice costisitoare.
+ */
+static void
+bottom_up_range(void *arg, long lo, long hi)
+{
+	bfs_state_t *s = arg;
+	const csr_graph_t *gt = s->gt;
+	long awake = 0, edges = 0;
+
+	for (long w = lo; w < hi; w++) {
+		uint64_t seen = atomic_load_explicit(&s->visited[w],
+											 memory_order_relaxed);
+		uint64_t found = 0;
+		int base = (int)(w << 6);
+		int end = base + 64 < gt->nodes ? base + 64 : gt->nodes;
+
+		if (seen == UINT64_MAX) {
+			atomic_store_explicit(&s->next[w], 0, memory_order_relaxed);
+			continue;
+		}
+
+		for (int v = base; v < end; v++) {
+			if (seen >> (v - base) & 1)
+				continue;
+
+			const int *neigh = csr_neighbors(gt, v);
+			for (long j = 0, deg = csr_degree(gt, v); j < deg; j++) {
+				int u = neigh[j];
+
+				if (test_bit(s->front, u)) {
+					s->parent[v] = u;
+					s->level[v] = s->depth;
+					found |= (uint64_t)1 << (v - base);
+					edges += csr_degree(s->g, v);
+					awake++;
+					break;
+				}
+			}
+		}
+
+		atomic_store_explicit(&s->next[w], found, memory_order_relaxed);
+		if (found)
+			atomic_fetch_or_explicit(&s->visited[w], found,
+									 memory_order_relaxed);
+	}
+
+	atomic_fetch_add_explicit(&s->next_size, awake, memory_order_relaxed);
+	atomic_fetch_add_explicit(&s->next_edges, edges, memory_order_relaxed);
+}
+
+/* Frontiera vector -> bitmap */
+static void
+queue_to_bitmap_range(void *arg, long lo, long hi)
+{
+	bfs_state_t *s = arg;
+
+	for (long i = lo; i < hi; i++) {
+		int v = s->queue[i];
+		atomic_fetch_or_explicit(&s->front[v >> 6], (uint64_t)1 << (v & 63),
+								 memory_order_relaxed);
+	}
+}
+
+/* Frontiera bitmap -> vector (nodurile ajung in next_queue) */
+static void
+bitmap_to_queue_range(void *arg, long lo, long hi)
+{
+	bfs_state_t *s = arg;
+	int buf[BFS_LOCAL_BUF];
+	int n = 0;
+
+	for (long w = lo; w < hi; w++) {
+		uint64_t bits = atomic_load_explicit(&s->front[w],
+											 memory_order_relaxed);
+
+		while (bits) {
+			buf[n++] = (int)(w << 6) + __builtin_ctzll(bits);
+			bits &= bits - 1;
+			if (n == BFS_LOCAL_BUF) {
+				flush_local(s, buf, n, 0);
+				n = 0;
+			}
+		}
+	}
+
+	flush_local(s, buf, n, 0);
+}
+
+static void
+clear_range(void *arg, long lo, long hi)
+{
+	bfs_word_t *bm = arg;
+
+	for (long w = lo; w < hi; w++)
+		atomic_store_explicit(&bm[w], 0, memory_order_relaxed);
+}
+
+/*
+ * BFS din source pe graful g. gt trebuie sa fie transpusul lui g (se poate
+ * obtine cu csr_transpose) si este folosit de pasii bottom-up; pentru un
+ * graf neorientat (fiecare muchie pusa in ambele sensuri) se poate da NULL.
+ * Rezultatul se elibereaza cu bfs_result_free.
+ */
+bfs_result_t *
+bfs_parallel(thread_pool_t *tp, const csr_graph_t *g, const csr_graph_t *gt,
+			 int source)
+{
+	bfs_state_t s;
+	int n = g->nodes;
+
+	DIE(source < 0 || source >= n, "source out of range\n");
+
+	bfs_result_t *r = calloc(1, sizeof(*r));
+	DIE(!r, "calloc() failed\n");
+	r->nodes = n;
+	r->parent = malloc(n * sizeof(int));
+	r->level = malloc(n * sizeof(int));
+	DIE(!r->parent || !r->level, "malloc() failed\n");
+	for (int i = 0; i < n; i++)
+		r->parent[i] = r->level[i] = -1;
+
+	s.g = g;
+	s.gt = gt ? gt : g;
+	s.parent = r->parent;
+	s.level = r->level;
+	s.words = ((long)n + 63) / 64;
+	s.visited = calloc(s.words, sizeof(bfs_word_t));
+	s.front = calloc(s.words, sizeof(bfs_word_t));
+	s.next = calloc(s.words, sizeof(bfs_word_t));
+	s.queue = malloc(n * sizeof(int));
+	s.next_queue = malloc(n * sizeof(int));
+	DIE(!s.visited || !s.front || !s.next || !s.queue || !s.next_queue,
+		"malloc() failed\n");
+
+	claim_bit(s.visited, source);
+	r->parent[source] = source;
+	r->level[source] = 0;
+	s.queue[0] = source;
+
+	long frontier = 1;
+	long frontier_edges = csr_degree(g, source);
+	long unexplored_edges = g->edges - frontier_edges;
+	int bottom_up = 0;
+
+	s.depth = 0;
+	while (frontier) {
+		s.depth++;
+		atomic_store(&s.next_size, 0);
+		atomic_store(&s.next_edges, 0);
+
+		if (!bottom_up && frontier_edges > unexplored_edges / BFS_ALPHA) {
+			/* Trecere la bottom-up: frontiera devine bitmap */
+			tp_parallel_for(tp, 0, s.words, BFS_GRAIN, clear_range, s.front);
+			tp_parallel_for(tp, 0, frontier, BFS_GRAIN,
+							queue_to_bitmap_range, &s);
+			bottom_up = 1;
+		} else if (bottom_up && frontier < n / BFS_BETA) {
+			/* Frontiera s-a micsorat: inapoi la top-down, cu vector */
+			tp_parallel_for(tp, 0, s.words, BFS_WORD_GRAIN,
+							bitmap_to_queue_range, &s);
+			int *tmp = s.queue;
+			s.queue = s.next_queue;
+			s.next_queue = tmp;
+			atomic_store(&s.next_size, 0);
+			bottom_up = 0;
+		}
+
+		if (bottom_up) {
+			tp_parallel_for(tp, 0, s.words, BFS_WORD_GRAIN, bottom_up_range,
+							&s);
+			bfs_word_t *tmp = s.front;
+			s.front = s.next;
+			s.next = tmp;
+			r->bottom_up_steps++;
+		} else {
+			tp_parallel_for(tp, 0, frontier, BFS_GRAIN, top_down_range, &s);
+			int *tmp = s.queue;
+			s.queue = s.next_queue;
+			s.next_queue = tmp;
+			r->top_down_steps++;
+		}
+
+		frontier = atomic_load(&s.next_size);
+		frontier_edges = atomic_load(&s.next_edges);
+		unexplored_edges -= frontier_edges;
+	}
+	r->depth = s.depth;
+
+	free(s.visited);
+	free(s.front);
+	free(s.next);
+	free(s.queue);
+	free(s.next_queue);
+
+	return r;
+}
+
+void
+bfs_result_free(bfs_result_t *r)
+{
+	if (!r)
+		return;
+
+	free(r->parent);
+	free(r->level);
+	free(r);
+}
@@ -0,0 +1,51 @@
+#ifndef BFS_PARALLEL_H
+#define BFS_PARALLEL_H
+
+#include <stdint.h>
+
+#include "csr_graph.h"
+#include "thread_pool.h"
+
+/*
+ * BFS paralel "direction-optimizing" (Beamer, Asanovic, Patterson). Cat timp
+ * frontiera este mica, fiecare nod din frontiera isi viziteaza vecinii
+ * (top-down). Cand muchiile care pleaca din frontiera ajung sa fie o parte
+ * mare din muchiile nevizitate inca, se trece la bottom-up: fiecare nod
+ * nevizitat isi cauta un parinte printre vecinii lui din frontiera si se
+ * opreste la primul gasit. Pe grafuri cu diametru mic (retele sociale)
+ * nivelurile din mijloc contin aproape tot graful si bottom-up sare peste
+ * majoritatea muchiilor.
+ *
+ * Frontiera top-down este un vector de noduri, cea bottom-up si multimea
+ * nodurilor vizitate sunt bitmap-uri (un bit pe nod). Fiecare nivel se
+ * imparte pe thread-urile unui thread_pool_t.
+ */
+
+/* Parametrii euristicii din articol */
+#define BFS_ALPHA 15
+#define BFS_BETA 18
+
+typedef struct bfs_result_t bfs_result_t;
+struct bfs_result_t
+{
+	int nodes;
+	/* parent[v] = nodul din care a fost descoperit v, -1 daca v nu a fost
+	 * atins; parent[source] = source */
+	int *parent;
+	/* level[v] = distanta (in muchii) de la sursa, -1 daca v nu a fost atins */
+	int *level;
+	/* Numarul de niveluri (distanta maxima + 1) */
+	int depth;
+	/* Cate niveluri s-au facut top-down, respectiv bottom-up */
+	int top_down_steps;
+	int bottom_up_steps;
+};
+
+bfs_result_t *
+bfs_parallel(thread_pool_t *tp, const csr_graph_t *g, const csr_graph_t *gt,
+			 int source);
+
+void
+bfs_result_free(bfs_result_t *r);
+
+#endif
@@ -22,6 +22,10 @@
 		}                                           \
 	} while (0)
 
+#include "bipartite_parallel.h"
+#include "csr_graph.h"
+#include "graph_loader.h"
+
 typedef struct ll_node_t ll_node_t;
 typedef struct linked_list_t linked_list_t;
 typedef struct queue_t queue_t;
@@ -122,59 +126,190 @@ void print_bipartite(list_graph_t *graph)
 
 	for (int i = 0; i < graph->nodes; i++)
 		levels[i] = -1;
-	
-	levels[0] = 0;
 
-	for (int i = 0; i < graph->nodes; i++) {
-		ll_node_t *neigh = graph->neighbors[i]->head;
-		while (neigh) {
-			if (levels[*(int *)neigh->data] < 0) {
-				if (!levels[i])
-					levels[*(int *)neigh->data] = 1;
-				else
-					levels[*(int *)neigh->data] = 0;
-			} else if (levels[i] < 0) {
-				if (!levels[*(int *)neigh->data])
-					levels[i] = 1;
-				else
-					levels[i] = 0;
-			} else if (levels[i] == levels[*(int *)neigh->data]) {
-				printf("Graph is not bipartite\n");
-				free(levels);
-				return;
+	/* Un BFS din fiecare nod necolorat inca, ca sa fie acoperite toate
+	 * componentele */
+	queue_t *q = q_create(sizeof(int), graph->nodes ? graph->nodes : 1);
+	for (int s = 0; s < graph->nodes; s++) {
+		if (levels[s] >= 0)
+			continue;
+
+		levels[s] = EVEN;
+		q_enqueue(q, &s);
+
+		while (!q_is_empty(q)) {
+			int x = *(int *)q_front(q);
+			q_dequeue(q);
+
+			ll_node_t *neigh = graph->neighbors[x]->head;
+			for (; neigh; neigh = neigh->next) {
+				int y = *(int *)neigh->data;
+
+				if (levels[y] < 0) {
+					levels[y] = !levels[x];
+					q_enqueue(q, &y);
+				} else if (levels[y] == levels[x]) {
+					printf("Graph is not bipartite\n");
+					q_free(q);
+					free(levels);
+					return;
+				}
 			}
-			neigh = neigh->next;
 		}
 	}
+	q_free(q);
 
 	for (int i = 0; i < graph->nodes; i++) {
-		if (levels[i] < 0) {
-			printf("Graph is not bipartite\n");
-			free(levels);
-			return;
-		}
+		if (levels[i] == EVEN)
+			printf("%d ", i);
 	}
+	printf("\n");
 
 	for (int i = 0; i < graph->nodes; i++) {
-		if (levels[i] == 0)
+		if (levels[i] == ODD)
 			printf("%d ", i);
 	}
 	printf("\n");
 
-	for (int i = 0; i < graph->nodes; i++) {
-		if (levels[i] == 1)
+	free(levels);
+}
+
+/*
+ * Construieste reprezentarea CSR a grafului. Vecinii fiecarui nod raman in
+ * ordinea din lista de adiacenta.
+ */
+csr_graph_t* lg_to_csr(list_graph_t* lg)
+{
+	long edges = 0;
+
+	for (int i = 0; i < lg->nodes; i++)
+		edges += lg->neighbors[i]->size;
+
+	csr_graph_t* g = csr_alloc(lg->nodes, edges, 0);
+	for (int i = 0; i < lg->nodes; i++) {
+		long e = g->offsets[i];
+		g->offsets[i + 1] = e + lg->neighbors[i]->size;
+		for (ll_node_t* it = lg->neighbors[i]->head; it; it = it->next)
+			g->targets[e++] = *(int *)it->data;
+	}
+
+	return g;
+}
+
+/*
+ * Verificarea pe un graf CSR, cu un BFS din fiecare nod necolorat inca
+ * (deci merge si pentru grafuri neconexe). Nodurile de pe niveluri pare sunt
+ * pe prima linie, cele de pe niveluri impare pe a doua, ca in
+ * print_bipartite.
+ */
+void print_bipartite_csr(csr_graph_t *g)
+{
+	int *levels = malloc(g->nodes * sizeof(int));
+	int *queue = malloc(g->nodes * sizeof(int));
+	DIE(!levels || !queue, "malloc() failed\n");
+
+	for (int i = 0; i < g->nodes; i++)
+		levels[i] = -1;
+
+	for (int s = 0; s < g->nodes; s++) {
+		if (levels[s] >= 0)
+			continue;
+
+		int head = 0, tail = 0;
+		levels[s] = EVEN;
+		queue[tail++] = s;
+
+		while (head < tail) {
+			int x = queue[head++];
+			const int *neigh = csr_neighbors(g, x);
+
+			for (long i = 0, deg = csr_degree(g, x); i < deg; i++) {
+				int y = neigh[i];
+
+				if (levels[y] < 0) {
+					levels[y] = !levels[x];
+					queue[tail++] = y;
+				} else if (levels[y] == levels[x]) {
+					printf("Graph is not bipartite\n");
+					free(levels);
+					free(queue);
+					return;
+				}
+			}
+		}
+	}
+
+	for (int i = 0; i < g->nodes; i++) {
+		if (levels[i] == EVEN)
+			printf("%d ", i);
+	}
+	printf("\n");
+
+	for (int i = 0; i < g->nodes; i++) {
+		if (levels[i] == ODD)
 			printf("%d ", i);
 	}
 	printf("\n");
 
 	free(levels);
+	free(queue);
+}
+
+/*
+ * Ca print_bipartite_csr, dar cu bipartite_parallel; daca graful nu este
+ * bipartit se afiseaza si un ciclu impar.
+ */
+void print_bipartite_parallel(thread_pool_t *tp, csr_graph_t *g)
+{
+	bip_result_t *r = bipartite_parallel(tp, g);
+
+	if (!r->bipartite) {
+		printf("Graph is not bipartite\n");
+		printf("odd cycle:");
+		for (int i = 0; i < r->cycle_len; i++)
+			printf(" %d", r->cycle[i]);
+		printf("\n");
+		bip_result_free(r);
+		return;
+	}
+
+	for (int i = 0; i < g->nodes; i++) {
+		if (r->color[i] == EVEN)
+			printf("%d ", i);
+	}
+	printf("\n");
+
+	for (int i = 0; i < g->nodes; i++) {
+		if (r->color[i] == ODD)
+			printf("%d ", i);
+	}
+	printf("\n");
+
+	bip_result_free(r);
 }
 
-int main()
+/*
+ * Cu argumentul "csr" verificarea se face cu print_bipartite_csr, iar cu
+ * "par" cu print_bipartite_parallel. Cu "file fisier" graful este incarcat
+ * direct in format CSR cu gl_load (graph_loader.h, text sau binar) si
+ * verificat cu print_bipartite_parallel.
+ */
+int main(int argc, char *argv[])
 {
 	int n, m, src, dest;
 	list_graph_t *graph;
 
+	if (argc > 1 && strcmp(argv[1], "file") == 0) {
+		DIE(argc < 3, "usage: bipartite file <path>\n");
+		thread_pool_t *tp = tp_create(0);
+		csr_graph_t *g = gl_load(argv[2], GL_HEADER | GL_UNDIRECTED, tp);
+
+		print_bipartite_parallel(tp, g);
+		csr_free(g);
+		tp_free(tp);
+		return 0;
+	}
+
 	scanf("%d%d", &n, &m);
 
 	graph = lg_create(n);
@@ -186,7 +321,20 @@ int main()
 		lg_add_edge(graph, dest, src);
 	}
 
-	print_bipartite(graph);
+	if (argc > 1 && strcmp(argv[1], "csr") == 0) {
+		csr_graph_t *g = lg_to_csr(graph);
+		print_bipartite_csr(g);
+		csr_free(g);
+	} else if (argc > 1 && strcmp(argv[1], "par") == 0) {
+		thread_pool_t *tp = tp_create(0);
+		csr_graph_t *g = lg_to_csr(graph);
+		print_bipartite_parallel(tp, g);
+		csr_free(g);
+		tp_free(tp);
+	} else {
+		print_bipartite(graph);
+	}
+
 	lg_free(graph);
 	return 0;
 }
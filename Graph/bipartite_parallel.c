@@ -0,0 +1,264 @@
+#include <limits.h>
+
+#include "bipartite_parallel.h"
+#include "bfs_parallel.h"
+#include "union_find.h"
+
+/* Cate noduri primeste cel putin un task */
+#define BIP_GRAIN 4096
+/* Cate componente primeste cel putin un task */
+#define BIP_COMP_GRAIN 64
+/* O componenta este parcursa cu bfs_parallel daca are cel putin
+ * BIP_BIG_MIN noduri si cel putin 1 / BIP_BIG_DIV din graf (deci sunt cel
+ * mult BIP_BIG_DIV astfel de componente, iar costul O(noduri) al fiecarui
+ * apel ramane mic) */
+#define BIP_BIG_MIN (1 << 16)
+#define BIP_BIG_DIV 16
+
+typedef struct bip_state_t bip_state_t;
+struct bip_state_t
+{
+	const csr_graph_t *g;
+	cuf_t *uf;
+	const cc_result_t *cc;
+	const int *first;       /* first[c] = cel mai mic nod din componenta c */
+	const long *queue_at;   /* Bucata componentei c din queue */
+	int *queue;
+	int *color;
+	int *parent;
+	long big;               /* Componentele cu cel putin atatea noduri sunt
+							 * parcurse separat */
+	const bfs_result_t *bfs;
+	/* Prima muchie (in ordinea din CSR) intre doua noduri de aceeasi
+	 * culoare, LONG_MAX daca nu exista */
+	atomic_long bad;
+};
+
+static void
+run_range(thread_pool_t *tp, long lo, long hi, long grain, tp_range_fn body,
+		  bip_state_t *s)
+{
+	if (!tp || tp_get_threads(tp) == 1 || hi - lo <= grain)
+		body(s, lo, hi);
+	else
+		tp_parallel_for(tp, lo, hi, grain, body, s);
+}
+
+/* Fiecare muchie apare in ambele sensuri, deci ajunge sensul u < v */
+static void
+union_range(void *arg, long lo, long hi)
+{
+	bip_state_t *s = arg;
+	const csr_graph_t *g = s->g;
+
+	for (long u = lo; u < hi; u++)
+		for (long e = g->offsets[u]; e < g->offsets[u + 1]; e++)
+			if (u < g->targets[e])
+				cuf_union(s->uf, (int)u, g->targets[e]);
+}
+
+/* BFS serial in componenta c, cu coada in bucata ei din s->queue */
+static void
+color_component(bip_state_t *s, int c)
+{
+	const csr_graph_t *g = s->g;
+	int *queue = s->queue + s->queue_at[c];
+	int head = 0, tail = 0, root = s->first[c];
+
+	s->color[root] = 0;
+	s->parent[root] = root;
+	queue[tail++] = root;
+
+	while (head < tail) {
+		int x = queue[head++];
+		const int *neigh = csr_neighbors(g, x);
+
+		for (long i = 0, deg = csr_degree(g, x); i < deg; i++) {
+			int y = neigh[i];
+
+			if (s->color[y] < 0) {
+				s->color[y] = !s->color[x];
+				s->parent[y] = x;
+				queue[tail++] = y;
+			}
+		}
+	}
+}
+
+static void
+small_components_range(void *arg, long lo, long hi)
+{
+	bip_state_t *s = arg;
+
+	for (long c = lo; c < hi; c++)
+		if (s->cc->size[c] < s->big)
+			color_component(s, (int)c);
+}
+
+/* Copiaza culorile si parintii din rezultatul lui bfs_parallel */
+static void
+copy_bfs_range(void *arg, long lo, long hi)
+{
+	bip_state_t *s = arg;
+
+	for (long v = lo; v < hi; v++) {
+		if (s->bfs->level[v] < 0)
+			continue;
+
+		s->color[v] = s->bfs->level[v] & 1;
+		s->parent[v] = s->bfs->parent[v];
+	}
+}
+
+/* Retine in s->bad cea mai mica muchie gasita care nu respecta colorarea */
+static void
+check_range(void *arg, long lo, long hi)
+{
+	bip_state_t *s = arg;
+	const csr_graph_t *g = s->g;
+
+	for (long u = lo; u < hi; u++) {
+		long bad = atomic_load_explicit(&s->bad, memory_order_relaxed);
+		if (g->offsets[u] >= bad)
+			return;
+
+		for (long e = g->offsets[u]; e < g->offsets[u + 1]; e++) {
+			if (s->color[g->targets[e]] != s->color[u])
+				continue;
+
+			while (e < bad
+				   && !atomic_compare_exchange_weak_explicit(
+					   &s->bad, &bad, e, memory_order_relaxed,
+					   memory_order_relaxed))
+				;
+			return;
+		}
+	}
+}
+
+/*
+ * Ciclul inchis de muchia e = u - v, cu u si v pe acelasi nivel: urca din u
+ * si din v in acelasi timp pana la stramosul comun.
+ */
+static void
+odd_cycle(const csr_graph_t *g, const int *parent, long e, bip_result_t *r)
+{
+	int lo = 0, hi = g->nodes - 1;
+
+	/* u = nodul cu offsets[u] <= e < offsets[u + 1] */
+	while (lo < hi) {
+		int mid = lo + (hi - lo + 1) / 2;
+
+		if (g->offsets[mid] <= e)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+
+	int u = lo, v = g->targets[e], k = 0;
+	for (int a = u, b = v; a != b; a = parent[a], b = parent[b])
+		k++;
+
+	r->cycle_len = 2 * k + 1;
+	r->cycle = malloc(r->cycle_len * sizeof(int));
+	DIE(!r->cycle, "malloc() failed\n");
+
+	/* u, ..., stramosul comun, ..., v */
+	for (int i = 0, a = u, b = v; i <= k; i++, a = parent[a], b = parent[b]) {
+		r->cycle[i] = a;
+		if (i < k)
+			r->cycle[r->cycle_len - 1 - i] = b;
+	}
+}
+
+/*
+ * Coloreaza graful neorientat g (fiecare muchie pusa in ambele sensuri).
+ * tp poate fi NULL; atunci totul ruleaza pe thread-ul apelant. Rezultatul se
+ * elibereaza cu bip_result_free.
+ */
+bip_result_t *
+bipartite_parallel(thread_pool_t *tp, const csr_graph_t *g)
+{
+	int n = g->nodes;
+	int serial = !tp || tp_get_threads(tp) == 1;
+	bip_state_t s = { .g = g };
+	cc_result_t *cc;
+
+	if (serial) {
+		cc = cc_from_csr(g);
+	} else {
+		s.uf = cuf_create(n);
+		run_range(tp, 0, n, BIP_GRAIN, union_range, &s);
+		cc = cc_from_cuf(s.uf);
+		cuf_free(s.uf);
+	}
+
+	bip_result_t *r = calloc(1, sizeof(*r));
+	DIE(!r, "calloc() failed\n");
+	r->nodes = n;
+	r->components = cc->components;
+	r->color = malloc((n ? n : 1) * sizeof(int));
+	s.parent = malloc((n ? n : 1) * sizeof(int));
+	s.queue = malloc((n ? n : 1) * sizeof(int));
+	int *first = malloc((cc->components + 1) * sizeof(int));
+	long *queue_at = malloc((cc->components + 1) * sizeof(long));
+	DIE(!r->color || !s.parent || !s.queue || !first || !queue_at,
+		"malloc() failed\n");
+	memset(r->color, 0xff, n * sizeof(int));
+
+	/* Componentele sunt numerotate in ordinea celui mai mic nod */
+	for (int v = 0, c = 0; v < n; v++)
+		if (cc->label[v] == c)
+			first[c++] = v;
+	queue_at[0] = 0;
+	for (int c = 0; c < cc->components; c++)
+		queue_at[c + 1] = queue_at[c] + cc->size[c];
+
+	s.cc = cc;
+	s.first = first;
+	s.queue_at = queue_at;
+	s.color = r->color;
+	s.big = LONG_MAX;
+	if (!serial)
+		s.big = n / BIP_BIG_DIV > BIP_BIG_MIN ? n / BIP_BIG_DIV : BIP_BIG_MIN;
+
+	run_range(tp, 0, cc->components, BIP_COMP_GRAIN, small_components_range,
+			  &s);
+
+	for (int c = 0; c < cc->components; c++) {
+		if (cc->size[c] < s.big)
+			continue;
+
+		bfs_result_t *b = bfs_parallel(tp, g, NULL, first[c]);
+		s.bfs = b;
+		run_range(tp, 0, n, BIP_GRAIN, copy_bfs_range, &s);
+		bfs_result_free(b);
+	}
+
+	atomic_init(&s.bad, LONG_MAX);
+	run_range(tp, 0, n, BIP_GRAIN, check_range, &s);
+
+	long bad = atomic_load(&s.bad);
+	r->bipartite = bad == LONG_MAX;
+	if (!r->bipartite)
+		odd_cycle(g, s.parent, bad, r);
+
+	free(first);
+	free(queue_at);
+	free(s.parent);
+	free(s.queue);
+	cc_result_free(cc);
+
+	return r;
+}
+
+void
+bip_result_free(bip_result_t *r)
+{
+	if (!r)
+		return;
+
+	free(r->color);
+	free(r->cycle);
+	free(r);
+}
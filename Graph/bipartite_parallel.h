@@ -0,0 +1,50 @@
+#ifndef BIPARTITE_PARALLEL_H
+#define BIPARTITE_PARALLEL_H
+
+#include "csr_graph.h"
+#include "thread_pool.h"
+
+/*
+ * Verificarea ca un graf neorientat este bipartit (2-colorare), pentru
+ * grafuri oricat de mari si neconexe.
+ *
+ * Intai se afla componentele conexe (union-find concurent, union_find.h).
+ * Fiecare componenta este apoi colorata cu un BFS din cel mai mic nod al ei,
+ * care primeste culoarea 0; nodul v primeste paritatea distantei pana la
+ * radacina. Componentele mici sunt parcurse simultan, fiecare de un singur
+ * thread, cu coada in propria bucata dintr-un vector comun; cele foarte mari
+ * sunt parcurse pe rand cu bfs_parallel, care imparte fiecare nivel pe
+ * thread-uri. La sfarsit toate muchiile sunt verificate in paralel: graful
+ * este bipartit daca nicio muchie nu uneste doua noduri de aceeasi culoare.
+ *
+ * Daca exista o astfel de muchie u - v, u si v sunt pe acelasi nivel al
+ * arborelui BFS, iar drumurile lor pana la primul stramos comun, impreuna cu
+ * muchia, formeaza un ciclu impar, intors ca dovada.
+ *
+ * Colorarea nu depinde de numarul de thread-uri; ciclul intors poate sa
+ * difere, pentru ca bfs_parallel poate alege alti parinti.
+ */
+
+typedef struct bip_result_t bip_result_t;
+struct bip_result_t
+{
+	int nodes;
+	int components;
+	int bipartite;
+	/* color[v] = 0 sau 1; daca graful este bipartit, orice muchie uneste
+	 * doua culori diferite */
+	int *color;
+	/* Daca graful nu este bipartit: un ciclu de lungime impara
+	 * cycle[0] - cycle[1] - ... - cycle[cycle_len - 1] - cycle[0];
+	 * altfel NULL */
+	int *cycle;
+	int cycle_len;
+};
+
+bip_result_t *
+bipartite_parallel(thread_pool_t *tp, const csr_graph_t *g);
+
+void
+bip_result_free(bip_result_t *r);
+
+#endif
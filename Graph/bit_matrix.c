@@ -0,0 +1,159 @@
+#include "bit_matrix.h"
+
+/* Cuvinte pe linie de cache */
+#define BM_LINE_WORDS 8
+
+bit_matrix_t *
+bm_create(int nodes)
+{
+	bit_matrix_t *bm = malloc(sizeof(*bm));
+	DIE(!bm, "malloc() failed\n");
+
+	bm->nodes = nodes;
+	bm->row_words = ((long)nodes + 511) / 512 * BM_LINE_WORDS;
+	if (!bm->row_words)
+		bm->row_words = BM_LINE_WORDS;
+
+	size_t bytes = (size_t)nodes * bm->row_words * sizeof(uint64_t);
+	bm->bits = aligned_alloc(64, bytes ? bytes : 64);
+	DIE(!bm->bits, "aligned_alloc() failed\n");
+	memset(bm->bits, 0, bytes);
+
+	return bm;
+}
+
+bit_matrix_t *
+bm_clone(const bit_matrix_t *bm)
+{
+	bit_matrix_t *copy = bm_create(bm->nodes);
+
+	memcpy(copy->bits, bm->bits,
+		   (size_t)bm->nodes * bm->row_words * sizeof(uint64_t));
+
+	return copy;
+}
+
+/*
+ * Aloca o multime de noduri (frontiera, noduri vizitate) de aceeasi
+ * dimensiune si aliniere ca o linie, initial vida. Se elibereaza cu free.
+ */
+uint64_t *
+bm_alloc_row(const bit_matrix_t *bm)
+{
+	uint64_t *row = aligned_alloc(64, bm->row_words * sizeof(uint64_t));
+	DIE(!row, "aligned_alloc() failed\n");
+	memset(row, 0, bm->row_words * sizeof(uint64_t));
+
+	return row;
+}
+
+/* dst |= src, pe words cuvinte */
+void
+bm_row_or(uint64_t *dst, const uint64_t *src, long words)
+{
+	uint64_t *d = __builtin_assume_aligned(dst, 64);
+	const uint64_t *s = __builtin_assume_aligned(src, 64);
+
+	for (long w = 0; w < words; w++)
+		d[w] |= s[w];
+}
+
+/* dst &= src, pe words cuvinte */
+void
+bm_row_and(uint64_t *dst, const uint64_t *src, long words)
+{
+	uint64_t *d = __builtin_assume_aligned(dst, 64);
+	const uint64_t *s = __builtin_assume_aligned(src, 64);
+
+	for (long w = 0; w < words; w++)
+		d[w] &= s[w];
+}
+
+/* Numarul de biti setati din row */
+int
+bm_popcount(const uint64_t *row, long words)
+{
+	int count = 0;
+
+	for (long w = 0; w < words; w++)
+		count += __builtin_popcountll(row[w]);
+
+	return count;
+}
+
+/* Gradul exterior al nodului */
+int
+bm_degree(const bit_matrix_t *bm, int node)
+{
+	return bm_popcount(bm_row(bm, node), bm->row_words);
+}
+
+/*
+ * Un pas de BFS: next = (reuniunea liniilor nodurilor din frontier) fara
+ * nodurile din visited. visited poate fi NULL. Intoarce numarul de noduri
+ * din next.
+ */
+long
+bm_expand(const bit_matrix_t *bm, const uint64_t *frontier,
+		  const uint64_t *visited, uint64_t *next)
+{
+	memset(next, 0, bm->row_words * sizeof(uint64_t));
+
+	for (long w = 0; w < bm->row_words; w++) {
+		uint64_t bits = frontier[w];
+
+		while (bits) {
+			int u = (int)(w << 6) + __builtin_ctzll(bits);
+			bm_row_or(next, bm_row(bm, u), bm->row_words);
+			bits &= bits - 1;
+		}
+	}
+
+	long count = 0;
+	for (long w = 0; w < bm->row_words; w++) {
+		if (visited)
+			next[w] &= ~visited[w];
+		count += __builtin_popcountll(next[w]);
+	}
+
+	return count;
+}
+
+/*
+ * Inchiderea tranzitiva (Warshall) pe loc: dupa apel bitul (i, j) este setat
+ * daca exista un drum de cel putin o muchie de la i la j. Pentru fiecare k,
+ * orice nod i care ajunge in k ajunge si unde ajunge k: linia i |= linia k,
+ * 64 de coloane pe operatie, deci O(n^3 / 64).
+ */
+void
+bm_transitive_closure(bit_matrix_t *bm)
+{
+	for (int k = 0; k < bm->nodes; k++) {
+		const uint64_t *row_k = bm_row(bm, k);
+
+		for (int i = 0; i < bm->nodes; i++)
+			if (bm_test(bm, i, k))
+				bm_row_or(bm_row(bm, i), row_k, bm->row_words);
+	}
+}
+
+/* Printeaza matricea, in acelasi format ca print_matrix_graph */
+void
+bm_print(const bit_matrix_t *bm)
+{
+	for (int i = 0; i < bm->nodes; i++) {
+		for (int j = 0; j < bm->nodes; j++)
+			printf("%d ", bm_test(bm, i, j));
+		printf("\n");
+	}
+}
+
+void
+bm_free(bit_matrix_t *bm)
+{
+	if (!bm)
+		return;
+
+	free(bm->bits);
+	free(bm);
+}
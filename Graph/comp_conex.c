@@ -18,6 +18,14 @@
         }                                           \
     } while (0)
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "csr_graph.h"
+#include "dfs_engine.h"
+#include "graph_loader.h"
+#include "union_find.h"
+
 typedef struct ll_node_t ll_node_t;
 typedef struct linked_list_t linked_list_t;
 typedef struct stack_t stack_t;
@@ -57,6 +65,10 @@ struct list_graph_t
 {
 	linked_list_t** neighbors;
 	int nodes;
+	/* Componentele conexe, actualizate la fiecare muchie (NULL daca nu sunt
+	 * urmarite); conn_stale = 1 dupa o stergere, pana la reconstruire */
+	uf_t* conn;
+	int conn_stale;
 };
 
 linked_list_t* ll_create(unsigned int data_size);
@@ -89,11 +101,18 @@ void q_free(queue_t* q);
 list_graph_t* lg_create(int nodes);
 void lg_add_edge(list_graph_t* graph, int src, int dest);
 static ll_node_t *find_node(linked_list_t *ll, int node, unsigned int *pos);
+static int is_node_in_graph(int n, int nodes);
 int lg_has_edge(list_graph_t* graph, int src, int dest);
 linked_list_t* lg_get_neighbours(list_graph_t* graph, int node);
 void lg_remove_edge(list_graph_t* graph, int src, int dest);
 void lg_free(list_graph_t* graph);
 
+void lg_track_connectivity(list_graph_t* graph);
+void lg_add_edges(list_graph_t* graph, const int* edges, int count);
+int lg_connected(list_graph_t* graph, int u, int v);
+int lg_components(list_graph_t* graph);
+cc_result_t* lg_cc_snapshot(list_graph_t* graph);
+
 /*
     Output format:
     
@@ -207,14 +226,227 @@ void print_connected_components(list_graph_t* graph)
 	ll_free(&list);
 }
 
-int main()
+/*
+ * Construieste reprezentarea CSR a grafului. Vecinii fiecarui nod raman in
+ * ordinea din lista de adiacenta.
+ */
+csr_graph_t* lg_to_csr(list_graph_t* lg)
+{
+	long edges = 0;
+
+	for (int i = 0; i < lg->nodes; i++)
+		edges += lg->neighbors[i]->size;
+
+	csr_graph_t* g = csr_alloc(lg->nodes, edges, 0);
+	for (int i = 0; i < lg->nodes; i++) {
+		long e = g->offsets[i];
+		g->offsets[i + 1] = e + lg->neighbors[i]->size;
+		for (ll_node_t* it = lg->neighbors[i]->head; it; it = it->next)
+			g->targets[e++] = *(int *)it->data;
+	}
+
+	return g;
+}
+
+/* Nodurile sunt adaugate in order in ordinea in care se termina vizitarea */
+static int cc_post(void *arg, int node, int parent)
+{
+    int **order = arg;
+
+    (void)parent;
+    *(*order)++ = node;
+    return 0;
+}
+
+/*
+ * Acelasi rezultat ca print_connected_components, pe un graf CSR, cu DFS-ul
+ * iterativ din dfs_engine.h. Nodurile fiecarei componente sunt consecutive
+ * in order; comp_start[c] marcheaza inceputul componentei c.
+ */
+void print_connected_components_csr(csr_graph_t* g)
+{
+    int *order = malloc((g->nodes ? g->nodes : 1) * sizeof(int));
+    int *comp_start = malloc((g->nodes + 1) * sizeof(int));
+    DIE(!order || !comp_start, "malloc() failed\n");
+
+    int *next = order;
+    dfs_visitor_t vis = { NULL, cc_post, NULL, &next };
+    dfs_t *d = dfs_create(g);
+    int cc = 0;
+
+    for (int i = 0; i < g->nodes; i++) {
+        if (!dfs_visited(d, i)) {
+            comp_start[cc++] = next - order;
+            dfs_visit(d, i, &vis);
+        }
+    }
+    comp_start[cc] = next - order;
+
+    printf("%d\n", cc);
+    for (int c = 0; c < cc; c++) {
+        for (int i = comp_start[c]; i < comp_start[c + 1]; i++)
+            printf(i + 1 < comp_start[c + 1] ? "%d " : "%d", order[i]);
+        printf("\n");
+    }
+
+    dfs_free(d);
+    free(order);
+    free(comp_start);
+}
+
+/*
+ * Afiseaza componentele calculate cu union-find: numarul lor, apoi nodurile
+ * fiecarei componente pe cate o linie, in ordine crescatoare. Nodurile sunt
+ * grupate pe componente cu o sortare prin numarare dupa etichete.
+ */
+void print_cc_result(cc_result_t *cc)
+{
+    int *start = malloc((cc->components + 1) * sizeof(int));
+    int *order = malloc((cc->nodes ? cc->nodes : 1) * sizeof(int));
+    DIE(!start || !order, "malloc() failed\n");
+
+    start[0] = 0;
+    for (int c = 0; c < cc->components; c++)
+        start[c + 1] = start[c] + cc->size[c];
+    for (int v = 0; v < cc->nodes; v++)
+        order[start[cc->label[v]]++] = v;
+
+    printf("%d\n", cc->components);
+    for (int c = 0, i = 0; c < cc->components; c++) {
+        for (int j = 0; j < cc->size[c]; j++, i++)
+            printf(j + 1 < cc->size[c] ? "%d " : "%d", order[i]);
+        printf("\n");
+    }
+
+    free(start);
+    free(order);
+}
+
+/*
+ * Operatii citite pana la sfarsitul intrarii, dupa graf:
+ *
+ *     add u v                  adauga muchia u - v
+ *     batch k u1 v1 ... uk vk  adauga k muchii deodata
+ *     conn u v                 afiseaza 1 daca u si v sunt conectate, 0 altfel
+ *     count                    afiseaza numarul de componente
+ *     snap                     retine componentele din acest moment
+ *     snap_conn u v            ca "conn", dar pe ultimul instantaneu
+ *     print                    afiseaza ultimul instantaneu ca mai sus
+ */
+void run_dynamic_queries(list_graph_t* graph)
+{
+    cc_result_t *snap = lg_cc_snapshot(graph);
+    int *batch = NULL;
+    char op[16];
+    int u, v, k;
+
+    while (scanf("%15s", op) == 1) {
+        if (strcmp(op, "add") == 0) {
+            DIE(scanf("%d%d", &u, &v) != 2, "bad add\n");
+            int edge[2] = { u, v };
+            lg_add_edges(graph, edge, 1);
+        } else if (strcmp(op, "batch") == 0) {
+            DIE(scanf("%d", &k) != 1 || k < 0, "bad batch\n");
+            batch = realloc(batch, (2 * k + 1) * sizeof(int));
+            DIE(!batch, "realloc() failed\n");
+            for (int i = 0; i < 2 * k; i++)
+                DIE(scanf("%d", &batch[i]) != 1, "bad batch\n");
+            lg_add_edges(graph, batch, k);
+        } else if (strcmp(op, "conn") == 0) {
+            DIE(scanf("%d%d", &u, &v) != 2, "bad conn\n");
+            printf("%d\n", lg_connected(graph, u, v));
+        } else if (strcmp(op, "count") == 0) {
+            printf("%d\n", lg_components(graph));
+        } else if (strcmp(op, "snap") == 0) {
+            cc_result_free(snap);
+            snap = lg_cc_snapshot(graph);
+        } else if (strcmp(op, "snap_conn") == 0) {
+            DIE(scanf("%d%d", &u, &v) != 2, "bad snap_conn\n");
+            printf("%d\n", is_node_in_graph(u, snap->nodes)
+                   && is_node_in_graph(v, snap->nodes)
+                   && cc_connected(snap, u, v));
+        } else if (strcmp(op, "print") == 0) {
+            print_cc_result(snap);
+        } else {
+            DIE(1, "unknown operation\n");
+        }
+    }
+
+    free(batch);
+    cc_result_free(snap);
+}
+
+/*
+ * Cu argumentul "csr" graful este convertit in format CSR inainte de
+ * parcurgere. Iesirea este aceeasi.
+ *
+ * Cu argumentul "uf" muchiile sunt citite de la intrarea standard si reunite
+ * pe masura ce sunt citite (union_find.h), fara sa se construiasca graful,
+ * deci merge si pentru fisiere cu foarte multe muchii. Cu "uf_bin fisier n"
+ * muchiile sunt perechi de int32 dintr-un fisier binar. In ambele cazuri
+ * nodurile unei componente sunt afisate in ordine crescatoare.
+ *
+ * Cu argumentul "dyn", dupa graf urmeaza operatii (vezi run_dynamic_queries)
+ * la care se raspunde fara sa se parcurga graful din nou.
+ *
+ * Cu "file fisier" graful este incarcat direct in format CSR cu gl_load
+ * (graph_loader.h), dintr-un fisier text in formatul de mai sus sau dintr-un
+ * fisier binar; "to_bin text binar" face conversia (fiecare muchie apare o
+ * singura data, in ordinea din fisierul text, deci "file" afiseaza acelasi
+ * rezultat pentru ambele fisiere).
+ */
+int main(int argc, char *argv[])
 {
     int n, m, src, dest;
     list_graph_t* graph;
 
+    if (argc > 1 && strncmp(argv[1], "uf", 2) == 0) {
+        thread_pool_t *tp = tp_create(0);
+        cc_result_t *cc;
+
+        if (strcmp(argv[1], "uf_bin") == 0) {
+            DIE(argc < 4, "usage: comp_conex uf_bin <file> <nodes>\n");
+            int fd = open(argv[2], O_RDONLY);
+            DIE(fd < 0, "open() failed\n");
+            cc = cc_stream_binary(fd, atoi(argv[3]), tp);
+            close(fd);
+        } else {
+            cc = cc_stream_text(STDIN_FILENO, tp);
+        }
+
+        print_cc_result(cc);
+        cc_result_free(cc);
+        tp_free(tp);
+        return 0;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "file") == 0) {
+        DIE(argc < 3, "usage: comp_conex file <path>\n");
+        thread_pool_t *tp = tp_create(0);
+        csr_graph_t *g = gl_load(argv[2], GL_HEADER | GL_UNDIRECTED, tp);
+
+        print_connected_components_csr(g);
+        csr_free(g);
+        tp_free(tp);
+        return 0;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "to_bin") == 0) {
+        DIE(argc < 4, "usage: comp_conex to_bin <text> <binary>\n");
+        thread_pool_t *tp = tp_create(0);
+
+        gl_convert_text(argv[2], argv[3], GL_HEADER, tp);
+        tp_free(tp);
+        return 0;
+    }
+
     scanf("%d%d", &n, &m);
     graph = lg_create(n);
 
+    int dynamic = argc > 1 && strcmp(argv[1], "dyn") == 0;
+    if (dynamic)
+        lg_track_connectivity(graph);
+
 	// Read graph edges
     for(int i = 0; i < m; ++i) {
         scanf("%d%d", &src, &dest);
@@ -222,7 +454,15 @@ int main()
         lg_add_edge(graph, dest, src);
     }
 
-    print_connected_components(graph);
+    if (argc > 1 && strcmp(argv[1], "csr") == 0) {
+        csr_graph_t *g = lg_to_csr(graph);
+        print_connected_components_csr(g);
+        csr_free(g);
+    } else if (dynamic) {
+        run_dynamic_queries(graph);
+    } else {
+        print_connected_components(graph);
+    }
 
     lg_free(graph);
     return 0;
@@ -548,21 +788,33 @@ lg_create(int nodes)
 		g->neighbors[i] = ll_create(sizeof(int));
 
 	g->nodes = nodes;
+	g->conn = NULL;
+	g->conn_stale = 0;
 
 	return g;
 }
 
-void
-lg_add_edge(list_graph_t* graph, int src, int dest)
+/* Adauga dest in lista lui src, fara sa actualizeze componentele; intoarce 0
+ * daca muchia nu este valida */
+static int
+lg_link(list_graph_t* graph, int src, int dest)
 {
 	if (
 		!graph || !graph->neighbors
 		|| !is_node_in_graph(src, graph->nodes)
 		|| !is_node_in_graph(dest, graph->nodes)
 	)
-		return;
+		return 0;
 
 	ll_add_nth_node(graph->neighbors[src], graph->neighbors[src]->size, &dest);
+	return 1;
+}
+
+void
+lg_add_edge(list_graph_t* graph, int src, int dest)
+{
+	if (lg_link(graph, src, dest) && graph->conn && !graph->conn_stale)
+		uf_union(graph->conn, src, dest);
 }
 
 static ll_node_t *find_node(linked_list_t *ll, int node, unsigned int *pos)
@@ -625,6 +877,11 @@ lg_remove_edge(list_graph_t* graph, int src, int dest)
 		return;
 
 	ll_remove_nth_node(graph->neighbors[src], pos);
+
+	/* Union-find nu poate separa multimi: componentele se recalculeaza la
+	 * urmatoarea interogare */
+	if (graph->conn)
+		graph->conn_stale = 1;
 }
 
 void
@@ -636,5 +893,90 @@ lg_free(list_graph_t* graph)
 		ll_free(graph->neighbors + i);
 	
 	free(graph->neighbors);
+	uf_free(graph->conn);
 	free(graph);
 }
+
+/* --- Conectivitate incrementala --- */
+
+/* Reface componentele din toate muchiile existente, O(n + m) */
+static void
+lg_rebuild_connectivity(list_graph_t* graph)
+{
+	uf_free(graph->conn);
+	graph->conn = uf_create(graph->nodes);
+	graph->conn_stale = 0;
+
+	for (int i = 0; i != graph->nodes; ++i)
+		for (ll_node_t* it = graph->neighbors[i]->head; it; it = it->next)
+			uf_union(graph->conn, i, *(int *)it->data);
+}
+
+/*
+ * De acum inainte fiecare lg_add_edge actualizeaza si componentele conexe
+ * (o reuniune, O(alpha(n)) amortizat), deci lg_connected si lg_components
+ * nu mai parcurg graful. Muchiile sunt considerate neorientate.
+ */
+void
+lg_track_connectivity(list_graph_t* graph)
+{
+	if (!graph->conn)
+		lg_rebuild_connectivity(graph);
+}
+
+/*
+ * Adauga count muchii neorientate, date ca perechi (src, dest) in edges.
+ * Componentele se actualizeaza o singura data pentru tot lotul, cu
+ * uf_union_batch.
+ */
+void
+lg_add_edges(list_graph_t* graph, const int* edges, int count)
+{
+	if (!graph || !graph->neighbors)
+		return;
+
+	for (int e = 0; e < count; e++) {
+		lg_link(graph, edges[2 * e], edges[2 * e + 1]);
+		lg_link(graph, edges[2 * e + 1], edges[2 * e]);
+	}
+
+	if (graph->conn && !graph->conn_stale)
+		uf_union_batch(graph->conn, edges, count);
+}
+
+static uf_t*
+lg_conn(list_graph_t* graph)
+{
+	if (!graph->conn || graph->conn_stale)
+		lg_rebuild_connectivity(graph);
+
+	return graph->conn;
+}
+
+int
+lg_connected(list_graph_t* graph, int u, int v)
+{
+	if (
+		!is_node_in_graph(u, graph->nodes)
+		|| !is_node_in_graph(v, graph->nodes)
+	)
+		return 0;
+
+	return uf_connected(lg_conn(graph), u, v);
+}
+
+int
+lg_components(list_graph_t* graph)
+{
+	return lg_conn(graph)->components;
+}
+
+/*
+ * Copie a componentelor din acest moment: interogarile pe ea (cc_connected)
+ * dau aceleasi raspunsuri oricate muchii s-ar adauga intre timp.
+ */
+cc_result_t*
+lg_cc_snapshot(list_graph_t* graph)
+{
+	return cc_from_uf(lg_conn(graph));
+}
@@ -0,0 +1,209 @@
+#include "compressed_graph.h"
+
+/* Bucatile mai scurte sunt sortate prin insertie */
+#define CG_SMALL_SORT 16
+
+static int
+cmp_int(const void *a, const void *b)
+{
+	int x = *(const int *)a, y = *(const int *)b;
+
+	return (x > y) - (x < y);
+}
+
+/* Listele deja sortate (de exemplu dupa reorder_apply) raman neatinse */
+static void
+sort_ints(int *a, long count)
+{
+	long i = 1;
+
+	while (i < count && a[i - 1] <= a[i])
+		i++;
+	if (i >= count)
+		return;
+
+	if (count > CG_SMALL_SORT) {
+		qsort(a, count, sizeof(int), cmp_int);
+		return;
+	}
+
+	for (; i < count; i++) {
+		int k = a[i];
+		long j = i;
+
+		for (; j > 0 && a[j - 1] > k; j--)
+			a[j] = a[j - 1];
+		a[j] = k;
+	}
+}
+
+static inline uint8_t *
+write_varint(uint8_t *p, uint32_t x)
+{
+	while (x >= 0x80) {
+		*p++ = (uint8_t)(x | 0x80);
+		x >>= 7;
+	}
+	*p++ = (uint8_t)x;
+
+	return p;
+}
+
+/*
+ * Comprima g; vecinii fiecarui nod sunt sortati (g ramane neschimbat).
+ * Listele se scriu una dupa alta intr-un buffer care se dubleaza cand nu mai
+ * are loc pentru lista urmatoare (cel mult 5 octeti pe numar).
+ */
+compressed_graph_t *
+cg_from_csr(const csr_graph_t *g)
+{
+	int n = g->nodes;
+	long blocks = (n + CG_BLOCK - 1) / CG_BLOCK, max_degree = 0;
+
+	for (int v = 0; v < n; v++)
+		if (csr_degree(g, v) > max_degree)
+			max_degree = csr_degree(g, v);
+	DIE(max_degree > UINT32_MAX, "degree too large\n");
+
+	compressed_graph_t *c = malloc(sizeof(*c));
+	DIE(!c, "malloc() failed\n");
+
+	c->nodes = n;
+	c->edges = g->edges;
+	c->block_start = malloc((blocks ? blocks : 1) * sizeof(long));
+	c->offset = malloc((n ? n : 1) * sizeof(uint32_t));
+	int *neigh = malloc((max_degree ? max_degree : 1) * sizeof(int));
+	DIE(!c->block_start || !c->offset || !neigh, "malloc() failed\n");
+
+	long capacity = 2 * (long)n + g->edges + 16, used = 0;
+	c->data = malloc(capacity);
+	DIE(!c->data, "malloc() failed\n");
+
+	for (int v = 0; v < n; v++) {
+		long deg = csr_degree(g, v);
+
+		if (used + 5 * (deg + 1) > capacity) {
+			while (used + 5 * (deg + 1) > capacity)
+				capacity *= 2;
+			c->data = realloc(c->data, capacity);
+			DIE(!c->data, "realloc() failed\n");
+		}
+
+		if (v % CG_BLOCK == 0)
+			c->block_start[v / CG_BLOCK] = used;
+		DIE(used - c->block_start[v / CG_BLOCK] > UINT32_MAX,
+			"block too large\n");
+		c->offset[v] = (uint32_t)(used - c->block_start[v / CG_BLOCK]);
+
+		memcpy(neigh, csr_neighbors(g, v), deg * sizeof(int));
+		sort_ints(neigh, deg);
+
+		uint8_t *p = c->data + used;
+		p = write_varint(p, (uint32_t)deg);
+		if (deg) {
+			int32_t first = neigh[0] - v;
+
+			/* zigzag: 0, -1, 1, -2, ... -> 0, 1, 2, 3, ... */
+			p = write_varint(p, ((uint32_t)first << 1) ^ (uint32_t)(first >> 31));
+		}
+		for (long i = 1; i < deg; i++)
+			p = write_varint(p, (uint32_t)(neigh[i] - neigh[i - 1]));
+
+		used = p - c->data;
+	}
+
+	/* cg_read_varint nu citeste niciodata dupa sfarsitul unui numar, deci
+	 * nu e nevoie de octeti in plus la final */
+	c->bytes = used;
+	c->data = realloc(c->data, used ? used : 1);
+	DIE(!c->data, "realloc() failed\n");
+
+	free(neigh);
+	return c;
+}
+
+/* Graful CSR echivalent, cu vecinii sortati */
+csr_graph_t *
+cg_to_csr(const compressed_graph_t *g)
+{
+	csr_graph_t *h = csr_alloc(g->nodes, g->edges, 0);
+	long e = 0;
+
+	for (int v = 0; v < g->nodes; v++) {
+		cg_iter_t it;
+		int w;
+
+		cg_iter_init(g, v, &it);
+		while (cg_iter_next(&it, &w))
+			h->targets[e++] = w;
+		h->offsets[v + 1] = e;
+	}
+
+	return h;
+}
+
+/* Memoria ocupata de graf, in octeti: listele si indexul */
+long
+cg_memory(const compressed_graph_t *g)
+{
+	long blocks = (g->nodes + CG_BLOCK - 1) / CG_BLOCK;
+
+	return sizeof(*g) + g->bytes + blocks * sizeof(long)
+		   + (long)g->nodes * sizeof(uint32_t);
+}
+
+void
+cg_free(compressed_graph_t *g)
+{
+	if (!g)
+		return;
+
+	free(g->block_start);
+	free(g->offset);
+	free(g->data);
+	free(g);
+}
+
+/*
+ * BFS din source. level[v] = distanta in muchii, parent[v] = nodul din care a
+ * fost descoperit v (parent[source] = source); -1 pentru nodurile neatinse.
+ * parent poate fi NULL. Intoarce numarul de noduri atinse.
+ */
+int
+cg_bfs(const compressed_graph_t *g, int source, int *level, int *parent)
+{
+	int *queue = malloc((g->nodes ? g->nodes : 1) * sizeof(int));
+	DIE(!queue, "malloc() failed\n");
+
+	for (int v = 0; v < g->nodes; v++) {
+		level[v] = -1;
+		if (parent)
+			parent[v] = -1;
+	}
+
+	int head = 0, tail = 0;
+
+	level[source] = 0;
+	if (parent)
+		parent[source] = source;
+	queue[tail++] = source;
+
+	while (head < tail) {
+		int x = queue[head++], y;
+		cg_iter_t it;
+
+		cg_iter_init(g, x, &it);
+		while (cg_iter_next(&it, &y)) {
+			if (level[y] >= 0)
+				continue;
+
+			level[y] = level[x] + 1;
+			if (parent)
+				parent[y] = x;
+			queue[tail++] = y;
+		}
+	}
+
+	free(queue);
+	return tail;
+}
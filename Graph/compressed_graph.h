@@ -0,0 +1,142 @@
+#ifndef COMPRESSED_GRAPH_H
+#define COMPRESSED_GRAPH_H
+
+#include <stdint.h>
+
+#include "csr_graph.h"
+
+/*
+ * Graf ORIENTAT, imutabil, comprimat: pentru grafurile care nu incap in
+ * memorie ca list_graph_t (~40 de octeti pe muchie) sau ca CSR (4).
+ *
+ * Lista nodului v este un sir de octeti: gradul, apoi vecinii crescator,
+ * fiecare ca diferenta fata de cel dinainte (primul fata de v, cu semn,
+ * codificat zigzag). Toate numerele sunt varint: 7 biti pe octet, bitul de
+ * sus marcheaza ca urmeaza alt octet. Pe grafurile cu localitate (pagini web
+ * in ordinea URL-urilor, grafuri renumerotate cu reorder.h) diferentele sunt
+ * mici si majoritatea incap intr-un singur octet.
+ *
+ * Inceputul listei lui v este block_start[v / CG_BLOCK] + offset[v], deci
+ * indexul costa putin peste 4 octeti pe nod. Muchiile nu au costuri; muchiile
+ * duble sunt pastrate (diferenta 0).
+ *
+ * Listele se parcurg cu un cg_iter_t, decodificand cate un vecin pe rand,
+ * fara sa se construiasca vreun vector. cg_bfs este BFS-ul construit pe el;
+ * DFS-ul este cel din dfs_engine.h, creat cu dfs_create_compressed.
+ * bfs_parallel ramane doar pe CSR: pasii lui bottom-up au nevoie si de
+ * graful transpus, care ar trebui comprimat separat, deci cg_bfs este
+ * varianta top-down, pe un singur thread.
+ *
+ * Nodurile sunt indexate de la 0.
+ */
+
+#define CG_BLOCK 64
+
+typedef struct compressed_graph_t compressed_graph_t;
+struct compressed_graph_t
+{
+	int nodes;
+	long edges;
+	long bytes;             /* Lungimea lui data */
+	long *block_start;      /* (nodes + CG_BLOCK - 1) / CG_BLOCK elemente */
+	uint32_t *offset;       /* nodes elemente */
+	uint8_t *data;
+};
+
+/* Pozitia in lista unui nod; vecinii se obtin cu cg_iter_next */
+typedef struct cg_iter_t cg_iter_t;
+struct cg_iter_t
+{
+	const uint8_t *p;
+	uint32_t left;          /* Vecini ramasi, inclusiv next */
+	int next;               /* Urmatorul vecin, daca left > 0 */
+};
+
+compressed_graph_t *
+cg_from_csr(const csr_graph_t *g);
+
+csr_graph_t *
+cg_to_csr(const compressed_graph_t *g);
+
+long
+cg_memory(const compressed_graph_t *g);
+
+void
+cg_free(compressed_graph_t *g);
+
+int
+cg_bfs(const compressed_graph_t *g, int source, int *level, int *parent);
+
+static inline const uint8_t *
+cg_read_varint(const uint8_t *p, uint32_t *x)
+{
+	uint32_t v = *p++;
+
+	if (v < 0x80) {
+		*x = v;
+		return p;
+	}
+
+	v &= 0x7f;
+	for (int shift = 7;; shift += 7) {
+		uint32_t b = *p++;
+
+		v |= (b & 0x7f) << shift;
+		if (b < 0x80)
+			break;
+	}
+
+	*x = v;
+	return p;
+}
+
+static inline const uint8_t *
+cg_list(const compressed_graph_t *g, int v)
+{
+	return g->data + g->block_start[v / CG_BLOCK] + g->offset[v];
+}
+
+/* Gradul exterior al nodului v */
+static inline long
+cg_degree(const compressed_graph_t *g, int v)
+{
+	uint32_t deg;
+
+	cg_read_varint(cg_list(g, v), &deg);
+	return deg;
+}
+
+static inline void
+cg_iter_init(const compressed_graph_t *g, int v, cg_iter_t *it)
+{
+	const uint8_t *p = cg_read_varint(cg_list(g, v), &it->left);
+
+	it->next = 0;
+	if (it->left) {
+		uint32_t z;
+
+		p = cg_read_varint(p, &z);
+		it->next = v + (int)((z >> 1) ^ -(z & 1));
+	}
+	it->p = p;
+}
+
+/* Pune in *v urmatorul vecin; intoarce 0 daca lista s-a terminat */
+static inline int
+cg_iter_next(cg_iter_t *it, int *v)
+{
+	if (!it->left)
+		return 0;
+
+	*v = it->next;
+	if (--it->left) {
+		uint32_t gap;
+
+		it->p = cg_read_varint(it->p, &gap);
+		it->next += (int)gap;
+	}
+
+	return 1;
+}
+
+#endif
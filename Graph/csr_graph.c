@@ -0,0 +1,180 @@
+#include "csr_graph.h"
+
+/*
+ * Aloca un graf CSR cu nodes noduri si loc pentru edges muchii. offsets[] este
+ * initializat cu 0; targets[] (si weights[]) trebuie completate de apelant.
+ */
+csr_graph_t *
+csr_alloc(int nodes, long edges, int weighted)
+{
+	csr_graph_t *g = malloc(sizeof(*g));
+	DIE(!g, "malloc() failed\n");
+
+	g->nodes = nodes;
+	g->edges = edges;
+
+	g->offsets = calloc((size_t)nodes + 1, sizeof(*g->offsets));
+	DIE(!g->offsets, "calloc() failed\n");
+
+	g->targets = malloc((edges ? edges : 1) * sizeof(*g->targets));
+	DIE(!g->targets, "malloc() failed\n");
+
+	g->weights = NULL;
+	if (weighted) {
+		g->weights = malloc((edges ? edges : 1) * sizeof(*g->weights));
+		DIE(!g->weights, "malloc() failed\n");
+	}
+
+	return g;
+}
+
+/*
+ * Construieste graful din muchiile (src[i], dst[i]) cu costurile weights[i]
+ * (weights poate fi NULL). O trecere numara gradele, sumele partiale dau
+ * offsets[], iar a doua trecere pune fiecare muchie la locul ei. Muchiile
+ * cu acelasi nod sursa isi pastreaza ordinea relativa.
+ */
+csr_graph_t *
+csr_create_from_edges(int nodes, long edges, const int *src, const int *dst,
+					  const int *weights)
+{
+	csr_graph_t *g = csr_alloc(nodes, edges, weights != NULL);
+
+	for (long i = 0; i < edges; i++) {
+		DIE(src[i] < 0 || src[i] >= nodes || dst[i] < 0 || dst[i] >= nodes,
+			"edge endpoint out of range\n");
+		g->offsets[src[i] + 1]++;
+	}
+
+	for (int v = 0; v < nodes; v++)
+		g->offsets[v + 1] += g->offsets[v];
+
+	long *pos = malloc(((size_t)nodes + 1) * sizeof(*pos));
+	DIE(!pos, "malloc() failed\n");
+	memcpy(pos, g->offsets, ((size_t)nodes + 1) * sizeof(*pos));
+
+	for (long i = 0; i < edges; i++) {
+		long p = pos[src[i]]++;
+		g->targets[p] = dst[i];
+		if (weights)
+			g->weights[p] = weights[i];
+	}
+
+	free(pos);
+	return g;
+}
+
+csr_builder_t *
+csr_builder_create(int nodes, int weighted)
+{
+	csr_builder_t *b = calloc(1, sizeof(*b));
+	DIE(!b, "calloc() failed\n");
+
+	b->nodes = nodes;
+	b->capacity = 1024;
+	b->src = malloc(b->capacity * sizeof(*b->src));
+	b->dst = malloc(b->capacity * sizeof(*b->dst));
+	DIE(!b->src || !b->dst, "malloc() failed\n");
+
+	if (weighted) {
+		b->weights = malloc(b->capacity * sizeof(*b->weights));
+		DIE(!b->weights, "malloc() failed\n");
+	}
+
+	return b;
+}
+
+/* Adauga muchia src -> dst (weight este ignorat daca graful nu are costuri) */
+void
+csr_builder_add(csr_builder_t *b, int src, int dst, int weight)
+{
+	if (b->edges == b->capacity) {
+		b->capacity *= 2;
+		b->src = realloc(b->src, b->capacity * sizeof(*b->src));
+		b->dst = realloc(b->dst, b->capacity * sizeof(*b->dst));
+		DIE(!b->src || !b->dst, "realloc() failed\n");
+		if (b->weights) {
+			b->weights = realloc(b->weights,
+								 b->capacity * sizeof(*b->weights));
+			DIE(!b->weights, "realloc() failed\n");
+		}
+	}
+
+	b->src[b->edges] = src;
+	b->dst[b->edges] = dst;
+	if (b->weights)
+		b->weights[b->edges] = weight;
+	b->edges++;
+}
+
+/*
+ * Construieste graful din muchiile colectate si elibereaza builder-ul.
+ */
+csr_graph_t *
+csr_builder_finish(csr_builder_t *b)
+{
+	csr_graph_t *g = csr_create_from_edges(b->nodes, b->edges, b->src, b->dst,
+										   b->weights);
+
+	free(b->src);
+	free(b->dst);
+	free(b->weights);
+	free(b);
+
+	return g;
+}
+
+/*
+ * Intoarce graful transpus (toate muchiile inversate). Vecinii fiecarui nod
+ * din transpus apar in ordinea crescatoare a nodului sursa original.
+ */
+csr_graph_t *
+csr_transpose(const csr_graph_t *g)
+{
+	csr_graph_t *t = csr_alloc(g->nodes, g->edges, g->weights != NULL);
+
+	for (long e = 0; e < g->edges; e++)
+		t->offsets[g->targets[e] + 1]++;
+	for (int v = 0; v < g->nodes; v++)
+		t->offsets[v + 1] += t->offsets[v];
+
+	long *pos = malloc(((size_t)g->nodes + 1) * sizeof(*pos));
+	DIE(!pos, "malloc() failed\n");
+	memcpy(pos, t->offsets, ((size_t)g->nodes + 1) * sizeof(*pos));
+
+	for (int u = 0; u < g->nodes; u++)
+		for (long e = g->offsets[u]; e < g->offsets[u + 1]; e++) {
+			long p = pos[g->targets[e]]++;
+			t->targets[p] = u;
+			if (g->weights)
+				t->weights[p] = g->weights[e];
+		}
+
+	free(pos);
+	return t;
+}
+
+/* Printeaza listele de adiacenta, in acelasi format ca lg_print_graph */
+void
+csr_print_graph(const csr_graph_t *g)
+{
+	for (int v = 0; v < g->nodes; v++) {
+		printf("%d: ", v);
+		for (long e = g->offsets[v]; e < g->offsets[v + 1]; e++)
+			printf("%d ", g->targets[e]);
+		printf("\n");
+	}
+}
+
+/* Elibereaza memoria folosita de graf */
+void
+csr_free(csr_graph_t *g)
+{
+	if (!g)
+		return;
+
+	free(g->offsets);
+	free(g->targets);
+	free(g->weights);
+	free(g);
+}
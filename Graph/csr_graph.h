@@ -0,0 +1,94 @@
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#ifndef DIE
+#define DIE(assertion, call_description)				\
+	do {								\
+		if (assertion) {					\
+			fprintf(stderr, "(%s, %d): ",			\
+					__FILE__, __LINE__);		\
+			perror(call_description);			\
+			exit(errno);				        \
+		}							\
+	} while (0)
+#endif
+
+/*
+ * Graf ORIENTAT, imutabil, in format CSR (compressed sparse row). Vecinii
+ * nodului v sunt targets[offsets[v]] ... targets[offsets[v + 1] - 1], in
+ * ordinea in care au fost adaugate muchiile, deci parcurgerile dau aceeasi
+ * ordine ca pe list_graph_t. Toate muchiile stau intr-un singur vector, asa
+ * ca parcurgerea vecinilor nu mai sare prin memorie din nod in nod.
+ *
+ * Nodurile sunt indexate de la 0.
+ */
+typedef struct csr_graph_t csr_graph_t;
+struct csr_graph_t
+{
+	int nodes;          /* Numarul de noduri din graf */
+	long edges;         /* Numarul de muchii */
+	long *offsets;      /* nodes + 1 elemente */
+	int *targets;       /* edges elemente */
+	int *weights;       /* edges elemente sau NULL daca graful nu are costuri */
+};
+
+/*
+ * Colecteaza muchii intr-o ordine oarecare; csr_builder_finish le grupeaza
+ * pe noduri sursa cu o sortare prin numarare (stabila).
+ */
+typedef struct csr_builder_t csr_builder_t;
+struct csr_builder_t
+{
+	int nodes;
+	long edges;
+	long capacity;
+	int *src;
+	int *dst;
+	int *weights;
+};
+
+csr_graph_t *
+csr_alloc(int nodes, long edges, int weighted);
+
+csr_graph_t *
+csr_create_from_edges(int nodes, long edges, const int *src, const int *dst,
+					  const int *weights);
+
+csr_builder_t *
+csr_builder_create(int nodes, int weighted);
+
+void
+csr_builder_add(csr_builder_t *b, int src, int dst, int weight);
+
+csr_graph_t *
+csr_builder_finish(csr_builder_t *b);
+
+csr_graph_t *
+csr_transpose(const csr_graph_t *g);
+
+void
+csr_print_graph(const csr_graph_t *g);
+
+void
+csr_free(csr_graph_t *g);
+
+/* Gradul exterior al nodului v */
+static inline long
+csr_degree(const csr_graph_t *g, int v)
+{
+	return g->offsets[v + 1] - g->offsets[v];
+}
+
+/* Primul vecin al nodului v; sunt csr_degree(g, v) vecini consecutivi */
+static inline const int *
+csr_neighbors(const csr_graph_t *g, int v)
+{
+	return g->targets + g->offsets[v];
+}
+
+#endif
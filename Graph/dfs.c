@@ -18,6 +18,8 @@
 		}							\
 	} while (0)
 
+#include "bit_matrix.h"
+
 /* --- LINKED LIST SUPPORT START --- */
 
 typedef struct ll_node_t
@@ -332,8 +334,8 @@ st_free(stack* st)
 
 typedef struct
 {
-    int** matrix; /* Matricea de adiacenta a grafului */
-    int nodes;    /* Numarul de noduri din graf. */
+    bit_matrix_t* matrix; /* Matricea de adiacenta, un bit pe muchie */
+    int nodes;            /* Numarul de noduri din graf. */
 } matrix_graph_t;
 
 /**
@@ -349,12 +351,7 @@ mg_create(int nodes)
     matrix_graph_t* graph = malloc(sizeof(matrix_graph_t));
     DIE(!graph, "malloc() failed\n");
 
-    graph->matrix = (int **)calloc(nodes, sizeof(int *));
-    DIE(!graph->matrix, "calloc() failed\n");
-    for (int i = 0; i < nodes; i++) {
-        graph->matrix[i] = (int *)calloc(nodes, sizeof(int));
-        DIE(!graph->matrix[i], "calloc() failed\n");
-    }
+    graph->matrix = bm_create(nodes);
 
     graph->nodes = nodes;
 
@@ -365,16 +362,14 @@ mg_create(int nodes)
 void
 mg_add_edge(matrix_graph_t* graph, int src, int dest)
 {
-    graph->matrix[src][dest] = 1;
+    bm_set(graph->matrix, src, dest);
 }
 
 /* Elibereaza memoria folosita de matricea de adiacenta a grafului */
 void
 mg_free(matrix_graph_t* graph)
 {
-    for (int i = 0; i < graph->nodes; i++)
-        free(graph->matrix[i]);
-    free(graph->matrix);
+    bm_free(graph->matrix);
     free(graph);
 }
 
@@ -405,12 +400,20 @@ dfs_matrix_graph(matrix_graph_t* mg,
         printf("%d ", x);
         st_pop(stack);
 
-        for (int i = mg->nodes - 1; i >= 0; i--) {
-			if (t_desc[i] == 0 && mg->matrix[x][i]) {
-				t_desc[i] = 1;
-				st_push(stack, &i);
-			}
-		}
+        /* Vecinii sunt bitii setati din linia lui x; se pun pe stiva de la
+         * cel mai mare la cel mai mic, sarind peste cuvintele nule */
+        uint64_t *row = bm_row(mg->matrix, x);
+        for (long w = mg->matrix->row_words - 1; w >= 0; w--) {
+            uint64_t bits = row[w];
+            while (bits) {
+                int i = (int)(w << 6) + 63 - __builtin_clzll(bits);
+                bits &= ~((uint64_t)1 << (i & 63));
+                if (t_desc[i] == 0) {
+                    t_desc[i] = 1;
+                    st_push(stack, &i);
+                }
+            }
+        }
 		t_fin[x] = 1;
     }
     
@@ -0,0 +1,302 @@
+#include "dfs_engine.h"
+
+static inline void
+bit_set(uint64_t *bits, int v)
+{
+	bits[v >> 6] |= (uint64_t)1 << (v & 63);
+}
+
+static inline int
+bit_test(const uint64_t *bits, int v)
+{
+	return (bits[v >> 6] >> (v & 63)) & 1;
+}
+
+static dfs_t *
+dfs_alloc(const csr_graph_t *g, const compressed_graph_t *cg, int nodes)
+{
+	dfs_t *d = malloc(sizeof(*d));
+	DIE(!d, "malloc() failed\n");
+
+	int n = nodes ? nodes : 1;
+
+	d->g = g;
+	d->cg = cg;
+	d->nodes = nodes;
+	d->words = (n + 63) / 64;
+	d->visited = malloc(d->words * sizeof(uint64_t));
+	d->finished = malloc(d->words * sizeof(uint64_t));
+	d->disc = malloc(n * sizeof(int));
+	d->stack = malloc(n * sizeof(dfs_frame_t));
+	d->iters = cg ? malloc(n * sizeof(cg_iter_t)) : NULL;
+	DIE(!d->visited || !d->finished || !d->disc || !d->stack
+		|| (cg && !d->iters), "malloc() failed\n");
+
+	dfs_reset(d);
+	return d;
+}
+
+dfs_t *
+dfs_create(const csr_graph_t *g)
+{
+	return dfs_alloc(g, NULL, g->nodes);
+}
+
+dfs_t *
+dfs_create_compressed(const compressed_graph_t *g)
+{
+	return dfs_alloc(NULL, g, g->nodes);
+}
+
+/* Marcheaza toate nodurile ca nevizitate */
+void
+dfs_reset(dfs_t *d)
+{
+	memset(d->visited, 0, d->words * sizeof(uint64_t));
+	memset(d->finished, 0, d->words * sizeof(uint64_t));
+	d->time = 0;
+	d->depth = 0;
+}
+
+/*
+ * Parcurgerea este scrisa o singura data, pentru ambele tipuri de graf:
+ * compressed este o constanta la fiecare apel, deci compilatorul genereaza
+ * cate o copie a buclei fara niciun test pe tipul grafului.
+ */
+static inline __attribute__((always_inline)) int
+dfs_push(dfs_t *d, int node, int parent, const dfs_visitor_t *vis,
+		 int compressed)
+{
+	int i = d->depth++;
+
+	bit_set(d->visited, node);
+	d->disc[node] = d->time++;
+	d->stack[i].node = node;
+	if (compressed)
+		cg_iter_init(d->cg, node, &d->iters[i]);
+	else
+		d->stack[i].cursor = d->g->offsets[node];
+
+	return vis->pre && vis->pre(vis->arg, node, parent);
+}
+
+/* Pune in *v urmatorul vecin al nodului din cadrul i; intoarce 0 la
+ * sfarsit */
+static inline int
+dfs_next(dfs_t *d, int i, int *v, int compressed)
+{
+	dfs_frame_t *f = &d->stack[i];
+
+	if (compressed)
+		return cg_iter_next(&d->iters[i], v);
+
+	if (f->cursor == d->g->offsets[f->node + 1])
+		return 0;
+	*v = d->g->targets[f->cursor++];
+	return 1;
+}
+
+static inline dfs_edge_kind_t
+dfs_classify(const dfs_t *d, int u, int v)
+{
+	if (!bit_test(d->visited, v))
+		return DFS_TREE;
+	if (!bit_test(d->finished, v))
+		return DFS_BACK;
+	return d->disc[u] < d->disc[v] ? DFS_FORWARD : DFS_CROSS;
+}
+
+static inline __attribute__((always_inline)) int
+dfs_visit_core(dfs_t *d, int root, const dfs_visitor_t *vis, int compressed)
+{
+	d->depth = 0;
+	if (dfs_push(d, root, -1, vis, compressed))
+		return 1;
+
+	while (d->depth) {
+		int top = d->depth - 1;
+		int u = d->stack[top].node, v, descended = 0;
+
+		/* Vecinii deja vizitati sunt sariti pe loc, fara sa se revina in
+		 * bucla exterioara pentru fiecare */
+		while (dfs_next(d, top, &v, compressed)) {
+			if (vis->edge && vis->edge(vis->arg, u, v, dfs_classify(d, u, v)))
+				return 1;
+			if (!bit_test(d->visited, v)) {
+				if (dfs_push(d, v, u, vis, compressed))
+					return 1;
+				descended = 1;
+				break;
+			}
+		}
+
+		if (descended)
+			continue;
+
+		d->depth--;
+		bit_set(d->finished, u);
+		if (vis->post && vis->post(vis->arg, u,
+								   d->depth ? d->stack[d->depth - 1].node : -1))
+			return 1;
+	}
+
+	return 0;
+}
+
+/*
+ * Parcurge nodurile accesibile din root care nu au fost vizitate inca
+ * (nimic, daca root este deja vizitat). Intoarce 1 daca un callback a
+ * oprit parcurgerea; nodurile ramase atunci pe stiva sunt vizitate, dar
+ * neterminate, si ar trebui apelat dfs_reset inainte de o noua parcurgere.
+ */
+int
+dfs_visit(dfs_t *d, int root, const dfs_visitor_t *vis)
+{
+	if (bit_test(d->visited, root))
+		return 0;
+
+	if (d->cg)
+		return dfs_visit_core(d, root, vis, 1);
+	return dfs_visit_core(d, root, vis, 0);
+}
+
+/* dfs_visit din fiecare nod nevizitat, in ordinea 0 .. nodes - 1 */
+int
+dfs_run(dfs_t *d, const dfs_visitor_t *vis)
+{
+	for (int v = 0; v < d->nodes; v++)
+		if (dfs_visit(d, v, vis))
+			return 1;
+
+	return 0;
+}
+
+void
+dfs_free(dfs_t *d)
+{
+	if (!d)
+		return;
+
+	free(d->visited);
+	free(d->finished);
+	free(d->disc);
+	free(d->stack);
+	free(d->iters);
+	free(d);
+}
+
+/* --- Algoritmi construiti pe dfs_t --- */
+
+typedef struct top_sort_state_t top_sort_state_t;
+struct top_sort_state_t
+{
+	int *order;
+	int left;           /* Nodurile se scriu de la sfarsitul lui order */
+	int acyclic;
+};
+
+static int
+top_sort_post(void *arg, int node, int parent)
+{
+	top_sort_state_t *s = arg;
+
+	(void)parent;
+	s->order[--s->left] = node;
+	return 0;
+}
+
+static int
+top_sort_edge(void *arg, int u, int v, dfs_edge_kind_t kind)
+{
+	top_sort_state_t *s = arg;
+
+	(void)u;
+	(void)v;
+	if (kind == DFS_BACK)
+		s->acyclic = 0;
+	return 0;
+}
+
+/*
+ * Sortarea topologica: ordinea inversa a terminarii vizitarii, cu radacinile
+ * luate in ordinea 0 .. nodes - 1 (aceeasi ordine ca DFS-ul recursiv din
+ * top_sort.c). order trebuie sa aiba g->nodes elemente. Intoarce 1 daca
+ * graful este aciclic; altfel ordinea este completa, dar nu topologica.
+ */
+int
+dfs_top_sort(const csr_graph_t *g, int *order)
+{
+	top_sort_state_t s = { order, g->nodes, 1 };
+	dfs_visitor_t vis = { NULL, top_sort_post, top_sort_edge, &s };
+	dfs_t *d = dfs_create(g);
+
+	dfs_run(d, &vis);
+	dfs_free(d);
+
+	return s.acyclic;
+}
+
+typedef struct cycle_state_t cycle_state_t;
+struct cycle_state_t
+{
+	int *parent;
+	int from;           /* Muchia inapoi gasita: from -> to */
+	int to;
+};
+
+static int
+cycle_pre(void *arg, int node, int parent)
+{
+	cycle_state_t *s = arg;
+
+	s->parent[node] = parent;
+	return 0;
+}
+
+static int
+cycle_edge(void *arg, int u, int v, dfs_edge_kind_t kind)
+{
+	cycle_state_t *s = arg;
+
+	if (kind != DFS_BACK)
+		return 0;
+
+	s->from = u;
+	s->to = v;
+	return 1;
+}
+
+/*
+ * Cauta un ciclu intr-un graf orientat. Daca exista, scrie in cycle nodurile
+ * lui in ordinea muchiilor (cycle[0] -> cycle[1] -> ... -> cycle[0]) si
+ * intoarce lungimea lui; altfel intoarce 0. cycle trebuie sa aiba g->nodes
+ * elemente.
+ */
+int
+dfs_find_cycle(const csr_graph_t *g, int *cycle)
+{
+	cycle_state_t s = { NULL, -1, -1 };
+	dfs_visitor_t vis = { cycle_pre, NULL, cycle_edge, &s };
+	dfs_t *d = dfs_create(g);
+	int len = 0;
+
+	s.parent = malloc((g->nodes ? g->nodes : 1) * sizeof(int));
+	DIE(!s.parent, "malloc() failed\n");
+
+	if (dfs_run(d, &vis)) {
+		/* to este stramos al lui from: drumul din arbore, inversat */
+		for (int v = s.from; v != s.to; v = s.parent[v])
+			cycle[len++] = v;
+		cycle[len++] = s.to;
+
+		for (int i = 0, j = len - 1; i < j; i++, j--) {
+			int tmp = cycle[i];
+			cycle[i] = cycle[j];
+			cycle[j] = tmp;
+		}
+	}
+
+	free(s.parent);
+	dfs_free(d);
+	return len;
+}
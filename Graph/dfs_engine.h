@@ -0,0 +1,106 @@
+#ifndef DFS_ENGINE_H
+#define DFS_ENGINE_H
+
+#include <stdint.h>
+
+#include "csr_graph.h"
+#include "compressed_graph.h"
+
+/*
+ * DFS iterativ pe un graf CSR, fara recursivitate: adancimea nu mai este
+ * limitata de stiva thread-ului, ci doar de memorie.
+ *
+ * Stiva este un vector de cadre (nod, cursor), unde cursor este indicele in
+ * targets[] al urmatorului vecin de examinat, deci un nod este continuat
+ * exact de unde a ramas cand se revine la el. Un nod apare o singura data pe
+ * stiva, asa ca stiva are cel mult nodes cadre si se aloca o singura data.
+ * Nodurile vizitate si cele terminate sunt tinute in bitset-uri.
+ *
+ * Ordinea de vizitare este aceeasi ca la varianta recursiva: vecinii sunt
+ * parcursi in ordinea din targets[].
+ *
+ * Acelasi motor merge si pe un graf comprimat (compressed_graph.h), creat cu
+ * dfs_create_compressed: atunci pozitia fiecarui cadru in lista nodului este
+ * un cg_iter_t, tinut intr-un vector paralel cu stiva (iters), iar vecinii
+ * sunt parcursi crescator. Cadrele de pe CSR raman (nod, cursor).
+ *
+ * Callback-urile primesc arg din dfs_visitor_t si opresc parcurgerea daca
+ * intorc o valoare nenula. Oricare dintre ele poate fi NULL.
+ */
+
+/* Tipul unei muchii u -> v, fata de arborele DFS */
+typedef enum dfs_edge_kind_t dfs_edge_kind_t;
+enum dfs_edge_kind_t
+{
+	DFS_TREE,           /* v este descoperit acum, prin u */
+	DFS_BACK,           /* v este un stramos al lui u, inca pe stiva */
+	DFS_FORWARD,        /* v este un descendent deja terminat al lui u */
+	DFS_CROSS           /* v este terminat si nu este descendent al lui u */
+};
+
+typedef struct dfs_visitor_t dfs_visitor_t;
+struct dfs_visitor_t
+{
+	/* La descoperirea nodului; parent = -1 pentru radacina */
+	int (*pre)(void *arg, int node, int parent);
+	/* Dupa ce toti vecinii nodului au fost examinati */
+	int (*post)(void *arg, int node, int parent);
+	/* Pentru fiecare muchie examinata, inainte de a cobori pe ea */
+	int (*edge)(void *arg, int u, int v, dfs_edge_kind_t kind);
+	void *arg;
+};
+
+typedef struct dfs_frame_t dfs_frame_t;
+struct dfs_frame_t
+{
+	int node;
+	long cursor;
+};
+
+typedef struct dfs_t dfs_t;
+struct dfs_t
+{
+	const csr_graph_t *g;
+	const compressed_graph_t *cg;   /* Graful parcurs, daca g este NULL */
+	int nodes;
+	long words;         /* Cuvinte de 64 de biti in fiecare bitset */
+	uint64_t *visited;
+	uint64_t *finished;
+	int *disc;          /* Momentul descoperirii, pentru DFS_FORWARD / CROSS */
+	int time;
+	dfs_frame_t *stack;
+	cg_iter_t *iters;   /* iters[i] pentru stack[i], doar daca cg != NULL */
+	int depth;
+};
+
+dfs_t *
+dfs_create(const csr_graph_t *g);
+
+dfs_t *
+dfs_create_compressed(const compressed_graph_t *g);
+
+void
+dfs_reset(dfs_t *d);
+
+int
+dfs_visit(dfs_t *d, int root, const dfs_visitor_t *vis);
+
+int
+dfs_run(dfs_t *d, const dfs_visitor_t *vis);
+
+void
+dfs_free(dfs_t *d);
+
+int
+dfs_top_sort(const csr_graph_t *g, int *order);
+
+int
+dfs_find_cycle(const csr_graph_t *g, int *cycle);
+
+static inline int
+dfs_visited(const dfs_t *d, int v)
+{
+	return (d->visited[v >> 6] >> (v & 63)) & 1;
+}
+
+#endif
@@ -0,0 +1,158 @@
+#include "dheap.h"
+
+/* Elementul i este entries[i]; fiii lui sunt 4i + 1 .. 4i + 4 */
+#define DHEAP_ARITY 4
+/*
+ * entries[] incepe la al 3-lea element din zona alocata (aliniata la 64), deci
+ * entries[4i + 1] este la un multiplu de 64 de octeti.
+ */
+#define DHEAP_SHIFT 3
+
+dheap_t *
+dheap_create(int capacity)
+{
+	dheap_t *h = malloc(sizeof(*h));
+	DIE(!h, "malloc() failed\n");
+
+	h->capacity = capacity;
+	h->size = 0;
+
+	size_t bytes = ((size_t)capacity + DHEAP_SHIFT + 1) * sizeof(dheap_entry_t);
+	bytes = (bytes + 63) / 64 * 64;
+	dheap_entry_t *raw = aligned_alloc(64, bytes);
+	DIE(!raw, "aligned_alloc() failed\n");
+	h->entries = raw + DHEAP_SHIFT;
+
+	h->pos = malloc((capacity ? capacity : 1) * sizeof(int));
+	DIE(!h->pos, "malloc() failed\n");
+	for (int i = 0; i < capacity; i++)
+		h->pos[i] = DHEAP_ABSENT;
+
+	return h;
+}
+
+/* Urca elementul de pe pozitia i cat timp este mai mic decat parintele */
+static void
+sift_up(dheap_t *h, int i)
+{
+	dheap_entry_t e = h->entries[i];
+
+	while (i > 0) {
+		int parent = (i - 1) / DHEAP_ARITY;
+
+		if (h->entries[parent].key <= e.key)
+			break;
+
+		h->entries[i] = h->entries[parent];
+		h->pos[h->entries[i].node] = i;
+		i = parent;
+	}
+
+	h->entries[i] = e;
+	h->pos[e.node] = i;
+}
+
+/* Coboara elementul de pe pozitia i spre cel mai mic fiu */
+static void
+sift_down(dheap_t *h, int i)
+{
+	dheap_entry_t e = h->entries[i];
+
+	for (;;) {
+		int first = DHEAP_ARITY * i + 1;
+		if (first >= h->size)
+			break;
+
+		int last = first + DHEAP_ARITY < h->size ? first + DHEAP_ARITY : h->size;
+		int best = first;
+		for (int c = first + 1; c < last; c++)
+			if (h->entries[c].key < h->entries[best].key)
+				best = c;
+
+		if (h->entries[best].key >= e.key)
+			break;
+
+		h->entries[i] = h->entries[best];
+		h->pos[h->entries[i].node] = i;
+		i = best;
+	}
+
+	h->entries[i] = e;
+	h->pos[e.node] = i;
+}
+
+/* Adauga nodul cu cheia data; nodul nu trebuie sa fie deja in heap */
+void
+dheap_push(dheap_t *h, int node, long long key)
+{
+	DIE(node < 0 || node >= h->capacity, "node out of range\n");
+	DIE(h->pos[node] != DHEAP_ABSENT, "node already in heap\n");
+
+	int i = h->size++;
+	h->entries[i].key = key;
+	h->entries[i].node = node;
+	sift_up(h, i);
+}
+
+/*
+ * Micsoreaza cheia unui nod din heap. O cheie mai mare sau egala cu cea
+ * curenta este ignorata.
+ */
+void
+dheap_decrease_key(dheap_t *h, int node, long long key)
+{
+	int i = h->pos[node];
+
+	DIE(i == DHEAP_ABSENT, "node not in heap\n");
+	if (key >= h->entries[i].key)
+		return;
+
+	h->entries[i].key = key;
+	sift_up(h, i);
+}
+
+/*
+ * Scoate nodul cu cheia minima si il intoarce; cheia lui se pune in *key
+ * (daca key nu este NULL). Intoarce -1 daca heap-ul este gol.
+ */
+int
+dheap_pop(dheap_t *h, long long *key)
+{
+	if (!h->size)
+		return -1;
+
+	dheap_entry_t top = h->entries[0];
+	h->pos[top.node] = DHEAP_ABSENT;
+
+	if (--h->size) {
+		h->entries[0] = h->entries[h->size];
+		sift_down(h, 0);
+	}
+
+	if (key)
+		*key = top.key;
+	return top.node;
+}
+
+/*
+ * Goleste heap-ul in O(size), nu O(capacity), ca sa poata fi refolosit intre
+ * interogari care ating doar o parte din graf.
+ */
+void
+dheap_clear(dheap_t *h)
+{
+	for (int i = 0; i < h->size; i++)
+		h->pos[h->entries[i].node] = DHEAP_ABSENT;
+	h->size = 0;
+}
+
+void
+dheap_free(dheap_t *h)
+{
+	if (!h)
+		return;
+
+	free(h->entries - DHEAP_SHIFT);
+	free(h->pos);
+	free(h);
+}
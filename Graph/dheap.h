@@ -0,0 +1,87 @@
+#ifndef DHEAP_H
+#define DHEAP_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#ifndef DIE
+#define DIE(assertion, call_description)				\
+	do {								\
+		if (assertion) {					\
+			fprintf(stderr, "(%s, %d): ",			\
+					__FILE__, __LINE__);		\
+			perror(call_description);			\
+			exit(errno);				        \
+		}							\
+	} while (0)
+#endif
+
+/*
+ * Min-heap 4-ar indexat dupa nod, pentru Dijkstra / A*. Fiecare element este
+ * o pereche (cheie, nod) de 16 octeti, iar vectorul este decalat astfel incat
+ * cei 4 fii ai unui element sa stea in aceeasi linie de cache de 64 de octeti.
+ * Fata de un heap binar, arborele are jumatate din inaltime, deci
+ * decrease-key (cea mai frecventa operatie) urca prin mai putine niveluri.
+ *
+ * pos[v] este pozitia nodului v in heap (sau DHEAP_ABSENT), asa ca
+ * decrease-key si verificarea apartenentei sunt O(1) + urcarea in heap.
+ */
+
+#define DHEAP_ABSENT (-1)
+
+typedef struct dheap_entry_t dheap_entry_t;
+struct dheap_entry_t
+{
+	long long key;
+	int node;
+};
+
+typedef struct dheap_t dheap_t;
+struct dheap_t
+{
+	int capacity;       /* Nodurile sunt 0 .. capacity - 1 */
+	int size;
+	dheap_entry_t *entries;
+	int *pos;
+};
+
+dheap_t *
+dheap_create(int capacity);
+
+void
+dheap_push(dheap_t *h, int node, long long key);
+
+void
+dheap_decrease_key(dheap_t *h, int node, long long key);
+
+int
+dheap_pop(dheap_t *h, long long *key);
+
+void
+dheap_clear(dheap_t *h);
+
+void
+dheap_free(dheap_t *h);
+
+static inline int
+dheap_is_empty(const dheap_t *h)
+{
+	return h->size == 0;
+}
+
+static inline int
+dheap_contains(const dheap_t *h, int node)
+{
+	return h->pos[node] != DHEAP_ABSENT;
+}
+
+/* Cheia minima; heap-ul nu trebuie sa fie gol */
+static inline long long
+dheap_min_key(const dheap_t *h)
+{
+	return h->entries[0].key;
+}
+
+#endif
@@ -0,0 +1,105 @@
+#include "dijkstra.h"
+
+/*
+ * Aloca rezultatul pentru un graf cu nodes noduri: toate distantele sunt
+ * SP_INF, in afara de dist[source] = 0.
+ */
+sp_result_t *
+sp_result_create(int nodes, int source)
+{
+	DIE(source < 0 || source >= nodes, "source out of range\n");
+
+	sp_result_t *r = malloc(sizeof(*r));
+	DIE(!r, "malloc() failed\n");
+
+	r->nodes = nodes;
+	r->source = source;
+	r->dist = malloc(nodes * sizeof(*r->dist));
+	r->pred = malloc(nodes * sizeof(*r->pred));
+	DIE(!r->dist || !r->pred, "malloc() failed\n");
+
+	for (int i = 0; i < nodes; i++) {
+		r->dist[i] = SP_INF;
+		r->pred[i] = -1;
+	}
+	r->dist[source] = 0;
+
+	return r;
+}
+
+/*
+ * Scrie in path nodurile drumului minim source -> dest (inclusiv capetele),
+ * in ordine, si intoarce cate sunt. path trebuie sa aiba loc pentru
+ * r->nodes noduri. Intoarce 0 daca dest nu este accesibil din sursa.
+ */
+int
+sp_path(const sp_result_t *r, int dest, int *path)
+{
+	if (dest < 0 || dest >= r->nodes || r->dist[dest] == SP_INF)
+		return 0;
+
+	int len = 0;
+	for (int v = dest; v != -1; v = r->pred[v])
+		path[len++] = v;
+
+	for (int i = 0, j = len - 1; i < j; i++, j--) {
+		int tmp = path[i];
+		path[i] = path[j];
+		path[j] = tmp;
+	}
+
+	return len;
+}
+
+void
+sp_result_free(sp_result_t *r)
+{
+	if (!r)
+		return;
+
+	free(r->dist);
+	free(r->pred);
+	free(r);
+}
+
+/*
+ * Dijkstra pe un graf CSR. Daca graful nu are costuri, fiecare muchie costa 1.
+ * Pentru dest >= 0 cautarea se opreste cand dest este scos din heap (distanta
+ * lui este atunci finala); doar nodurile scoase pana atunci au distante
+ * finale. Pentru dest < 0 se calculeaza drumurile minime spre toate nodurile.
+ */
+sp_result_t *
+dijkstra_csr(const csr_graph_t *g, int source, int dest)
+{
+	sp_result_t *r = sp_result_create(g->nodes, source);
+	dheap_t *h = dheap_create(g->nodes);
+	long long d;
+
+	dheap_push(h, source, 0);
+
+	while (!dheap_is_empty(h)) {
+		int u = dheap_pop(h, &d);
+
+		if (u == dest)
+			break;
+
+		for (long e = g->offsets[u]; e < g->offsets[u + 1]; e++) {
+			int v = g->targets[e];
+			long long w = g->weights ? g->weights[e] : 1;
+
+			DIE(w < 0, "negative edge cost\n");
+			if (d + w >= r->dist[v])
+				continue;
+
+			r->dist[v] = d + w;
+			r->pred[v] = u;
+			if (dheap_contains(h, v))
+				dheap_decrease_key(h, v, d + w);
+			else
+				dheap_push(h, v, d + w);
+		}
+	}
+
+	dheap_free(h);
+	return r;
+}
@@ -0,0 +1,42 @@
+#ifndef DIJKSTRA_H
+#define DIJKSTRA_H
+
+#include <limits.h>
+
+#include "csr_graph.h"
+#include "dheap.h"
+
+/*
+ * Drumuri minime de la o sursa pe grafuri cu costuri nenegative. Distantele
+ * sunt long long, ca sumele de costuri int sa nu depaseasca. Pentru fiecare
+ * nod atins se retine predecesorul de pe drumul minim, din care se
+ * reconstruieste drumul cu sp_path.
+ */
+
+#define SP_INF LLONG_MAX
+
+typedef struct sp_result_t sp_result_t;
+struct sp_result_t
+{
+	int nodes;
+	int source;
+	/* dist[v] = costul drumului minim source -> v, SP_INF daca nu exista */
+	long long *dist;
+	/* pred[v] = nodul dinaintea lui v pe drumul minim, -1 pentru sursa si
+	 * pentru nodurile neatinse */
+	int *pred;
+};
+
+sp_result_t *
+sp_result_create(int nodes, int source);
+
+int
+sp_path(const sp_result_t *r, int dest, int *path);
+
+void
+sp_result_free(sp_result_t *r);
+
+sp_result_t *
+dijkstra_csr(const csr_graph_t *g, int source, int dest);
+
+#endif
@@ -0,0 +1,212 @@
+#include <stdint.h>
+
+#include "dyn_graph.h"
+
+static inline int
+slot_of(const dg_adj_t *a, int node)
+{
+	uint32_t h = (uint32_t)node * 0x9e3779b1u;
+
+	return (int)((h ^ (h >> 15)) & (uint32_t)a->mask);
+}
+
+/* Slotul in care este (sau ar trebui inserat) node */
+static inline int
+find_slot(const dg_adj_t *a, int node)
+{
+	int i = slot_of(a, node);
+
+	while (a->slots[i].node >= 0 && a->slots[i].node != node)
+		i = (i + 1) & a->mask;
+
+	return i;
+}
+
+/* (Re)construieste tabela pentru vecinii din nodes, cu factor de incarcare
+ * de cel mult 1/4 */
+static void
+build_slots(dg_adj_t *a)
+{
+	int count = 4;
+	while (count < 4 * a->size)
+		count *= 2;
+
+	free(a->slots);
+	a->slots = malloc(count * sizeof(dg_slot_t));
+	DIE(!a->slots, "malloc() failed\n");
+	a->mask = count - 1;
+
+	for (int i = 0; i < count; i++)
+		a->slots[i].node = -1;
+	for (int k = 0; k < a->size; k++) {
+		int i = find_slot(a, a->nodes[k]);
+		a->slots[i].node = a->nodes[k];
+		a->slots[i].index = k;
+	}
+}
+
+/*
+ * Sterge slotul i fara sa lase "morminte": elementele care urmeaza in
+ * acelasi grup sunt mutate inapoi daca pozitia lor ideala nu este intre i si
+ * ele.
+ */
+static void
+erase_slot(dg_adj_t *a, int i)
+{
+	for (int j = (i + 1) & a->mask; a->slots[j].node >= 0;
+		 j = (j + 1) & a->mask) {
+		int k = slot_of(a, a->slots[j].node);
+
+		if (((j - k) & a->mask) >= ((j - i) & a->mask)) {
+			a->slots[i] = a->slots[j];
+			i = j;
+		}
+	}
+
+	a->slots[i].node = -1;
+}
+
+/* Pozitia lui node printre vecini, -1 daca nu este vecin */
+static inline int
+find_index(const dg_adj_t *a, int node)
+{
+	if (a->slots) {
+		const dg_slot_t *sl = &a->slots[find_slot(a, node)];
+		return sl->node >= 0 ? sl->index : -1;
+	}
+
+	for (int k = 0; k < a->size; k++)
+		if (a->nodes[k] == node)
+			return k;
+
+	return -1;
+}
+
+dyn_graph_t *
+dg_create(int nodes)
+{
+	dyn_graph_t *g = malloc(sizeof(*g));
+	DIE(!g, "malloc() failed\n");
+
+	g->nodes = nodes;
+	g->edges = 0;
+	g->adj = calloc(nodes ? nodes : 1, sizeof(dg_adj_t));
+	DIE(!g->adj, "calloc() failed\n");
+
+	return g;
+}
+
+static inline void
+check_nodes(const dyn_graph_t *g, int src, int dest)
+{
+	DIE(src < 0 || src >= g->nodes || dest < 0 || dest >= g->nodes,
+		"node out of range\n");
+}
+
+/* Adauga muchia src -> dest; intoarce 0 daca exista deja */
+int
+dg_add_edge(dyn_graph_t *g, int src, int dest)
+{
+	check_nodes(g, src, dest);
+
+	dg_adj_t *a = &g->adj[src];
+	if (find_index(a, dest) >= 0)
+		return 0;
+
+	if (a->size == a->capacity) {
+		a->capacity = a->capacity ? 2 * a->capacity : 4;
+		a->nodes = realloc(a->nodes, a->capacity * sizeof(int));
+		DIE(!a->nodes, "realloc() failed\n");
+	}
+	a->nodes[a->size++] = dest;
+	g->edges++;
+
+	if (a->slots && 2 * a->size <= a->mask + 1) {
+		int i = find_slot(a, dest);
+		a->slots[i].node = dest;
+		a->slots[i].index = a->size - 1;
+	} else if (a->slots || a->size > DG_HASH_MIN) {
+		build_slots(a);
+	}
+
+	return 1;
+}
+
+/* 1 daca exista muchia src -> dest */
+int
+dg_has_edge(const dyn_graph_t *g, int src, int dest)
+{
+	check_nodes(g, src, dest);
+
+	return find_index(&g->adj[src], dest) >= 0;
+}
+
+/* Sterge muchia src -> dest; intoarce 0 daca nu exista */
+int
+dg_remove_edge(dyn_graph_t *g, int src, int dest)
+{
+	check_nodes(g, src, dest);
+
+	dg_adj_t *a = &g->adj[src];
+	int k;
+
+	if (a->slots) {
+		int i = find_slot(a, dest);
+		if (a->slots[i].node < 0)
+			return 0;
+		k = a->slots[i].index;
+		erase_slot(a, i);
+	} else {
+		k = find_index(a, dest);
+		if (k < 0)
+			return 0;
+	}
+
+	/* Ultimul vecin ia locul celui sters */
+	int last = a->nodes[--a->size];
+	if (k != a->size) {
+		a->nodes[k] = last;
+		if (a->slots)
+			a->slots[find_slot(a, last)].index = k;
+	}
+	g->edges--;
+
+	if (a->slots && a->size < DG_HASH_MIN / 4) {
+		free(a->slots);
+		a->slots = NULL;
+	} else if (a->slots && 16 * a->size < a->mask + 1) {
+		build_slots(a);
+	}
+
+	return 1;
+}
+
+/* Instantaneu CSR al grafului, cu vecinii in ordinea din dg_neighbors */
+csr_graph_t *
+dg_to_csr(const dyn_graph_t *g)
+{
+	csr_graph_t *c = csr_alloc(g->nodes, g->edges, 0);
+
+	for (int v = 0; v < g->nodes; v++) {
+		const dg_adj_t *a = &g->adj[v];
+
+		c->offsets[v + 1] = c->offsets[v] + a->size;
+		memcpy(c->targets + c->offsets[v], a->nodes, a->size * sizeof(int));
+	}
+
+	return c;
+}
+
+void
+dg_free(dyn_graph_t *g)
+{
+	if (!g)
+		return;
+
+	for (int v = 0; v < g->nodes; v++) {
+		free(g->adj[v].nodes);
+		free(g->adj[v].slots);
+	}
+	free(g->adj);
+	free(g);
+}
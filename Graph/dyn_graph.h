@@ -0,0 +1,81 @@
+#ifndef DYN_GRAPH_H
+#define DYN_GRAPH_H
+
+#include "csr_graph.h"
+
+/*
+ * Graf ORIENTAT cu muchii adaugate si sterse des, fara muchii duble.
+ *
+ * Vecinii unui nod stau intr-un vector contiguu. Pentru nodurile cu grad mic
+ * (cel mult DG_HASH_MIN) cautarea este o parcurgere a vectorului, care incape
+ * in cateva linii de cache. Cand gradul depaseste DG_HASH_MIN, nodul
+ * primeste si o tabela de dispersie (adresare deschisa, sondare liniara) din
+ * vecin in pozitia lui in vector, deci cautarea, adaugarea si stergerea sunt
+ * O(1) in medie oricat de mare ar fi gradul. La stergere ultimul vecin ia
+ * locul celui sters, asa ca vectorul ramane compact si poate fi parcurs
+ * direct (dg_neighbors), dar ordinea vecinilor se schimba. Tabela este
+ * eliberata cand gradul scade sub DG_HASH_MIN / 4.
+ *
+ * Nodurile sunt indexate de la 0.
+ */
+
+#define DG_HASH_MIN 32
+
+typedef struct dg_slot_t dg_slot_t;
+struct dg_slot_t
+{
+	int node;           /* -1 = slot liber */
+	int index;          /* Pozitia lui node in dg_adj_t.nodes */
+};
+
+typedef struct dg_adj_t dg_adj_t;
+struct dg_adj_t
+{
+	int *nodes;
+	int size;
+	int capacity;
+	dg_slot_t *slots;   /* NULL cat timp gradul este mic */
+	int mask;           /* Numarul de sloturi - 1 (putere a lui 2) */
+};
+
+typedef struct dyn_graph_t dyn_graph_t;
+struct dyn_graph_t
+{
+	int nodes;
+	long edges;
+	dg_adj_t *adj;
+};
+
+dyn_graph_t *
+dg_create(int nodes);
+
+int
+dg_add_edge(dyn_graph_t *g, int src, int dest);
+
+int
+dg_has_edge(const dyn_graph_t *g, int src, int dest);
+
+int
+dg_remove_edge(dyn_graph_t *g, int src, int dest);
+
+csr_graph_t *
+dg_to_csr(const dyn_graph_t *g);
+
+void
+dg_free(dyn_graph_t *g);
+
+static inline int
+dg_degree(const dyn_graph_t *g, int node)
+{
+	return g->adj[node].size;
+}
+
+/* Vecinii nodului, dg_degree(g, node) elemente; pointerul ramane valid pana
+ * la urmatoarea modificare a nodului */
+static inline const int *
+dg_neighbors(const dyn_graph_t *g, int node)
+{
+	return g->adj[node].nodes;
+}
+
+#endif
@@ -0,0 +1,426 @@
+#include <limits.h>
+
+#include "dyn_topo.h"
+
+static void
+adj_push(dt_adj_t *a, int node)
+{
+	if (a->size == a->capacity) {
+		a->capacity = a->capacity ? 2 * a->capacity : 4;
+		a->nodes = realloc(a->nodes, a->capacity * sizeof(int));
+		DIE(!a->nodes, "realloc() failed\n");
+	}
+
+	a->nodes[a->size++] = node;
+}
+
+/* Graf fara muchii; ordinea initiala este 0, 1, ..., nodes - 1 */
+dyn_topo_t *
+dt_create(int nodes)
+{
+	dyn_topo_t *t = malloc(sizeof(*t));
+	DIE(!t, "malloc() failed\n");
+
+	int n = nodes ? nodes : 1;
+
+	t->nodes = nodes;
+	t->edges = 0;
+	t->out = calloc(n, sizeof(dt_adj_t));
+	t->in = calloc(n, sizeof(dt_adj_t));
+	t->ord = malloc(n * sizeof(int));
+	t->node_at = malloc(n * sizeof(int));
+	t->mark = calloc(n, sizeof(int));
+	t->parent = malloc(n * sizeof(int));
+	t->stack = malloc(n * sizeof(int));
+	t->delta_f = malloc(n * sizeof(int));
+	t->delta_b = malloc(n * sizeof(int));
+	t->merged = malloc(n * sizeof(int));
+	t->moved = malloc(n * sizeof(int));
+	t->indeg = malloc(n * sizeof(int));
+	t->mark_b = calloc(n, sizeof(int));
+	DIE(!t->out || !t->in || !t->ord || !t->node_at || !t->mark
+		|| !t->parent || !t->stack || !t->delta_f || !t->delta_b
+		|| !t->merged || !t->moved || !t->indeg || !t->mark_b,
+		"malloc() failed\n");
+	t->stamp = 0;
+
+	for (int i = 0; i < nodes; i++) {
+		t->ord[i] = i;
+		t->node_at[i] = i;
+	}
+
+	return t;
+}
+
+/* Un stamp nou pentru mark[]; la depasire mark[] se goleste */
+static int
+next_stamp(dyn_topo_t *t)
+{
+	if (t->stamp == INT_MAX) {
+		memset(t->mark, 0, (t->nodes ? t->nodes : 1) * sizeof(int));
+		memset(t->mark_b, 0, (t->nodes ? t->nodes : 1) * sizeof(int));
+		t->stamp = 0;
+	}
+
+	return ++t->stamp;
+}
+
+/*
+ * Nodurile accesibile din start pe muchiile din adj, cu pozitia in
+ * [lo, hi]. Pozitiile lor se scriu in delta. Daca se ajunge in stop,
+ * cautarea se opreste si se intoarce -1; altfel numarul de noduri gasite.
+ */
+static int
+bounded_dfs(dyn_topo_t *t, const dt_adj_t *adj, int start, int stop, int lo,
+			int hi, int *delta)
+{
+	int stamp = next_stamp(t);
+	int top = 0, found = 0;
+
+	t->mark[start] = stamp;
+	t->parent[start] = -1;
+	t->stack[top++] = start;
+
+	while (top) {
+		int x = t->stack[--top];
+
+		delta[found++] = t->ord[x];
+		for (int i = 0; i < adj[x].size; i++) {
+			int y = adj[x].nodes[i];
+
+			if (t->mark[y] == stamp || t->ord[y] < lo || t->ord[y] > hi)
+				continue;
+
+			t->mark[y] = stamp;
+			t->parent[y] = x;
+			if (y == stop)
+				return -1;
+			t->stack[top++] = y;
+		}
+	}
+
+	return found;
+}
+
+static int
+cmp_int(const void *a, const void *b)
+{
+	int x = *(const int *)a, y = *(const int *)b;
+
+	return (x > y) - (x < y);
+}
+
+/*
+ * Nodurile de pe pozitiile delta_b (cele din care se ajunge in u) trebuie sa
+ * ajunga inaintea celor de pe pozitiile delta_f (accesibile din v). Ambele
+ * grupuri isi pastreaza ordinea relativa si ocupa impreuna exact aceleasi
+ * pozitii ca inainte, deci restul ordinii ramane neatins.
+ */
+static void
+reorder(dyn_topo_t *t, int nb, int nf)
+{
+	qsort(t->delta_b, nb, sizeof(int), cmp_int);
+	qsort(t->delta_f, nf, sizeof(int), cmp_int);
+
+	for (int i = 0; i < nb; i++)
+		t->moved[i] = t->node_at[t->delta_b[i]];
+	for (int i = 0; i < nf; i++)
+		t->moved[nb + i] = t->node_at[t->delta_f[i]];
+
+	/* Interclasarea pozitiilor (multimile sunt disjuncte) */
+	int i = 0, j = 0, k = 0;
+	while (i < nb || j < nf)
+		t->merged[k++] = j == nf || (i < nb && t->delta_b[i] < t->delta_f[j])
+						 ? t->delta_b[i++] : t->delta_f[j++];
+
+	for (k = 0; k < nb + nf; k++) {
+		t->ord[t->moved[k]] = t->merged[k];
+		t->node_at[t->merged[k]] = t->moved[k];
+	}
+}
+
+/*
+ * Adauga muchia u -> v si actualizeaza ordinea. Intoarce 1 daca muchia a
+ * fost adaugata, 0 daca ar fi inchis un ciclu; atunci graful ramane
+ * neschimbat, iar daca cycle nu este NULL (cu loc pentru nodes noduri) in el
+ * se scrie ciclul v -> ... -> u -> v, cu lungimea in *cycle_len.
+ */
+int
+dt_add_edge(dyn_topo_t *t, int u, int v, int *cycle, int *cycle_len)
+{
+	DIE(u < 0 || u >= t->nodes || v < 0 || v >= t->nodes,
+		"edge endpoint out of range\n");
+
+	int lb = t->ord[v], ub = t->ord[u];
+
+	if (lb > ub) {
+		adj_push(&t->out[u], v);
+		adj_push(&t->in[v], u);
+		t->edges++;
+		return 1;
+	}
+
+	int nf = u == v ? -1 : bounded_dfs(t, t->out, v, u, lb, ub, t->delta_f);
+	if (nf < 0) {
+		if (cycle) {
+			/* Drumul u <- ... <- v din arborele DFS, inversat */
+			int len = 0;
+
+			t->parent[v] = -1;
+			for (int x = u; x != -1; x = t->parent[x])
+				cycle[len++] = x;
+			for (int i = 0, j = len - 1; i < j; i++, j--) {
+				int tmp = cycle[i];
+				cycle[i] = cycle[j];
+				cycle[j] = tmp;
+			}
+			*cycle_len = len;
+		}
+		return 0;
+	}
+
+	int nb = bounded_dfs(t, t->in, u, -1, lb, ub, t->delta_b);
+	reorder(t, nb, nf);
+
+	adj_push(&t->out[u], v);
+	adj_push(&t->in[v], u);
+	t->edges++;
+	return 1;
+}
+
+/*
+ * Adauga la found nodurile nemarcate accesibile din start pe muchiile din
+ * adj, cu pozitia in [lo, hi], si le marcheaza in mark cu stamp. Intoarce
+ * noul numar de noduri din found.
+ */
+static int
+reach(dyn_topo_t *t, const dt_adj_t *adj, int *mark, int stamp, int start,
+	  int lo, int hi, int *found, int count)
+{
+	int top = 0;
+
+	if (mark[start] == stamp)
+		return count;
+
+	mark[start] = stamp;
+	t->stack[top++] = start;
+
+	while (top) {
+		int x = t->stack[--top];
+
+		found[count++] = x;
+		for (int i = 0; i < adj[x].size; i++) {
+			int y = adj[x].nodes[i];
+
+			if (mark[y] == stamp || t->ord[y] < lo || t->ord[y] > hi)
+				continue;
+
+			mark[y] = stamp;
+			t->stack[top++] = y;
+		}
+	}
+
+	return count;
+}
+
+/* Inlocuieste nodurile a[0, count) cu aceleasi noduri in ordinea pozitiilor */
+static void
+sort_by_ord(dyn_topo_t *t, int *a, int count)
+{
+	for (int i = 0; i < count; i++)
+		a[i] = t->ord[a[i]];
+	qsort(a, count, sizeof(int), cmp_int);
+	for (int i = 0; i < count; i++)
+		a[i] = t->node_at[a[i]];
+}
+
+/*
+ * Rearanjarea pentru muchiile windows[first, last) ale lotului, ale caror
+ * intervale s-au unit in fereastra [lo, hi]. Ca la dt_add_edge, F sunt
+ * nodurile accesibile din capetele v, iar B cele din care se ajunge in
+ * capetele u, limitate la fereastra. Pozitiile lor se redistribuie in
+ * ordinea: B \ F (ordinea relativa pastrata, deci nodurile doar coboara),
+ * F intersectat cu B (sortate topologic, Kahn) si F \ B (doar urca). Un nod
+ * din afara lor nu are muchii spre B \ F sau dinspre F \ B in fereastra,
+ * deci ramane valid. Orice ciclu nou trece doar prin F intersectat cu B;
+ * atunci se intoarce 0, fara sa se schimbe ordinea.
+ */
+static int
+reorder_batch(dyn_topo_t *t, const int *edges, const int *windows, int first,
+			  int last, int lo, int hi)
+{
+	int stamp = next_stamp(t);
+	int nf = 0, nb = 0, k = 0, pool = 0;
+
+	for (int i = first; i < last; i++) {
+		int e = windows[3 * i + 2];
+
+		nf = reach(t, t->out, t->mark, stamp, edges[2 * e + 1], lo, hi,
+				   t->delta_f, nf);
+		nb = reach(t, t->in, t->mark_b, stamp, edges[2 * e], lo, hi,
+				   t->delta_b, nb);
+	}
+
+	/* moved = B \ F, apoi F intersectat cu B, apoi F \ B */
+	for (int i = 0; i < nb; i++)
+		if (t->mark[t->delta_b[i]] != stamp)
+			t->moved[k++] = t->delta_b[i];
+	sort_by_ord(t, t->moved, k);
+
+	int mid = k, tail = k;
+
+	for (int i = 0; i < nf; i++) {
+		int x = t->delta_f[i];
+
+		if (t->mark_b[x] != stamp)
+			continue;
+
+		t->indeg[x] = 0;
+		for (int j = 0; j < t->in[x].size; j++) {
+			int w = t->in[x].nodes[j];
+
+			t->indeg[x] += t->mark[w] == stamp && t->mark_b[w] == stamp;
+		}
+		if (!t->indeg[x])
+			t->moved[tail++] = x;
+		pool++;
+	}
+
+	for (int head = mid; head < tail; head++) {
+		int x = t->moved[head];
+
+		for (int j = 0; j < t->out[x].size; j++) {
+			int y = t->out[x].nodes[j];
+
+			if (t->mark[y] == stamp && t->mark_b[y] == stamp && !--t->indeg[y])
+				t->moved[tail++] = y;
+		}
+	}
+	if (tail - mid < pool)
+		return 0;
+
+	k = tail;
+	for (int i = 0; i < nf; i++)
+		if (t->mark_b[t->delta_f[i]] != stamp)
+			t->moved[k++] = t->delta_f[i];
+	sort_by_ord(t, t->moved + tail, k - tail);
+
+	for (int i = 0; i < k; i++)
+		t->merged[i] = t->ord[t->moved[i]];
+	qsort(t->merged, k, sizeof(int), cmp_int);
+
+	for (int i = 0; i < k; i++) {
+		t->ord[t->moved[i]] = t->merged[i];
+		t->node_at[t->merged[i]] = t->moved[i];
+	}
+	return 1;
+}
+
+/* Intervalele (ord[v], ord[u], muchie), dupa inceput */
+static int
+cmp_window(const void *a, const void *b)
+{
+	const int *x = a, *y = b;
+
+	return (x[0] > y[0]) - (x[0] < y[0]);
+}
+
+/*
+ * Adauga count muchii date ca perechi (u, v) in edges, cu o singura
+ * rearanjare pentru fiecare grup de muchii cu intervale suprapuse. Daca lotul
+ * ar inchide un ciclu, muchiile se adauga pe rand cu dt_add_edge: cele care
+ * ar inchide un ciclu sunt sarite si, daca reject nu este NULL, raportate
+ * prin reject(arg, indicele muchiei, ciclul v -> ... -> u, lungimea lui).
+ * Intoarce numarul de muchii adaugate.
+ */
+int
+dt_add_edges(dyn_topo_t *t, const int *edges, int count, dt_reject_fn reject,
+			 void *arg)
+{
+	int *windows = malloc((count ? count : 1) * 3 * sizeof(int));
+	int nw = 0, acyclic = 1;
+	DIE(!windows, "malloc() failed\n");
+
+	for (int e = 0; e < count; e++) {
+		int u = edges[2 * e], v = edges[2 * e + 1];
+
+		DIE(u < 0 || u >= t->nodes || v < 0 || v >= t->nodes,
+			"edge endpoint out of range\n");
+
+		if (t->ord[v] <= t->ord[u]) {
+			windows[3 * nw] = t->ord[v];
+			windows[3 * nw + 1] = t->ord[u];
+			windows[3 * nw + 2] = e;
+			nw++;
+		}
+		adj_push(&t->out[u], v);
+		adj_push(&t->in[v], u);
+	}
+
+	/* Ordinea curenta ramane valida pentru muchiile vechi si pentru cele care
+	 * o respecta; se rearanjeaza doar ferestrele, unite cand se suprapun.
+	 * O fereastra deja rearanjata ramane valida si daca una urmatoare
+	 * esueaza */
+	qsort(windows, nw, 3 * sizeof(int), cmp_window);
+	for (int i = 0; i < nw && acyclic;) {
+		int first = i, lo = windows[3 * i], hi = windows[3 * i + 1];
+
+		for (i++; i < nw && windows[3 * i] <= hi; i++)
+			if (windows[3 * i + 1] > hi)
+				hi = windows[3 * i + 1];
+		acyclic = reorder_batch(t, edges, windows, first, i, lo, hi);
+	}
+	free(windows);
+
+	if (acyclic) {
+		t->edges += count;
+		return count;
+	}
+
+	/* Fiecare muchie a fost adaugata la sfarsitul listelor, deci se scot in
+	 * ordine inversa */
+	for (int e = count - 1; e >= 0; e--) {
+		t->out[edges[2 * e]].size--;
+		t->in[edges[2 * e + 1]].size--;
+	}
+
+	int *cycle = reject ? malloc((t->nodes ? t->nodes : 1) * sizeof(int)) : NULL;
+	int added = 0, len;
+	DIE(reject && !cycle, "malloc() failed\n");
+
+	for (int e = 0; e < count; e++) {
+		if (dt_add_edge(t, edges[2 * e], edges[2 * e + 1], cycle, &len))
+			added++;
+		else if (reject)
+			reject(arg, e, cycle, len);
+	}
+
+	free(cycle);
+	return added;
+}
+
+void
+dt_free(dyn_topo_t *t)
+{
+	if (!t)
+		return;
+
+	for (int i = 0; i < t->nodes; i++) {
+		free(t->out[i].nodes);
+		free(t->in[i].nodes);
+	}
+	free(t->out);
+	free(t->in);
+	free(t->ord);
+	free(t->node_at);
+	free(t->mark);
+	free(t->parent);
+	free(t->stack);
+	free(t->delta_f);
+	free(t->delta_b);
+	free(t->merged);
+	free(t->moved);
+	free(t->indeg);
+	free(t->mark_b);
+	free(t);
+}
@@ -0,0 +1,92 @@
+#ifndef DYN_TOPO_H
+#define DYN_TOPO_H
+
+#include "csr_graph.h"
+
+/*
+ * Ordine topologica mentinuta pe masura ce se adauga muchii (algoritmul
+ * Pearce-Kelly).
+ *
+ * ord[v] este pozitia nodului v, iar node_at[] este inversa lui. O muchie
+ * u -> v cu ord[u] < ord[v] nu schimba nimic. Altfel doar nodurile cu
+ * pozitii intre ord[v] si ord[u] pot fi afectate: se cauta (DFS inainte)
+ * nodurile accesibile din v si (DFS inapoi) cele din care se ajunge in u,
+ * limitate la aceasta fereastra, iar pozitiile lor se redistribuie astfel
+ * incat cele din urma sa ajunga inaintea celor dintai. Costul depinde doar
+ * de regiunea afectata, nu de marimea grafului. Daca DFS-ul inainte ajunge
+ * in u, muchia ar inchide un ciclu si este refuzata.
+ *
+ * dt_add_edges adauga un lot de muchii: muchiile care contrazic ordinea
+ * definesc intervale [ord[v], ord[u]], iar intervalele care se suprapun se
+ * unesc. Pentru fiecare fereastra rezultata se cauta o singura data, din
+ * toate capetele, nodurile accesibile inainte si inapoi, si doar ele sunt
+ * rearanjate, ca la o singura muchie. Costul ramane cel al regiunii
+ * afectate, iar muchiile cu regiuni comune nu o parcurg de mai multe ori.
+ *
+ * Muchiile se tin in vectori care cresc la nevoie, cate unul de iesire si
+ * unul de intrare pentru fiecare nod. Nodurile sunt indexate de la 0.
+ */
+
+typedef struct dt_adj_t dt_adj_t;
+struct dt_adj_t
+{
+	int *nodes;
+	int size;
+	int capacity;
+};
+
+typedef struct dyn_topo_t dyn_topo_t;
+struct dyn_topo_t
+{
+	int nodes;
+	long edges;
+	dt_adj_t *out;
+	dt_adj_t *in;
+	int *ord;           /* ord[v] = pozitia lui v in ordine */
+	int *node_at;       /* node_at[ord[v]] = v */
+
+	/* Memorie de lucru pentru o insertie, alocata o singura data */
+	int *mark;          /* mark[v] == stamp: v vizitat la insertia curenta */
+	int stamp;
+	int *parent;        /* Pentru reconstruirea ciclului */
+	int *stack;
+	int *delta_f;       /* Pozitiile nodurilor gasite inainte / inapoi */
+	int *delta_b;
+	int *merged;
+	int *moved;
+	int *indeg;         /* Pentru dt_add_edges: gradul interior in regiune */
+	int *mark_b;        /* mark_b[v] == stamp: v gasit de DFS-ul inapoi */
+};
+
+/* Apelata pentru fiecare muchie refuzata de dt_add_edges, cu ciclul pe care
+ * l-ar fi inchis (ca la dt_add_edge) */
+typedef void (*dt_reject_fn)(void *arg, int edge, const int *cycle, int len);
+
+dyn_topo_t *
+dt_create(int nodes);
+
+int
+dt_add_edge(dyn_topo_t *t, int u, int v, int *cycle, int *cycle_len);
+
+int
+dt_add_edges(dyn_topo_t *t, const int *edges, int count, dt_reject_fn reject,
+			 void *arg);
+
+void
+dt_free(dyn_topo_t *t);
+
+/* Nodul de pe pozitia pos in ordinea topologica curenta */
+static inline int
+dt_node_at(const dyn_topo_t *t, int pos)
+{
+	return t->node_at[pos];
+}
+
+/* 1 daca u este inaintea lui v in ordinea curenta */
+static inline int
+dt_before(const dyn_topo_t *t, int u, int v)
+{
+	return t->ord[u] < t->ord[v];
+}
+
+#endif
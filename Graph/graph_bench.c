@@ -0,0 +1,1498 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "csr_graph.h"
+#include "bfs_parallel.h"
+#include "dfs_engine.h"
+#include "union_find.h"
+#include "bipartite_parallel.h"
+#include "dijkstra.h"
+#include "apsp.h"
+#include "bit_matrix.h"
+#include "dyn_graph.h"
+#include "compressed_graph.h"
+
+/*
+ * Masoara algoritmii din Graph/ pe grafuri generate, pentru fiecare
+ * reprezentare: liste inlantuite (list_graph_t, ca in programele de
+ * laborator), matrice de costuri (int **, ca in FloydWarshall.c), matrice de
+ * biti (bit_matrix.h), CSR cu motoarele din *_parallel.h / dfs_engine.h /
+ * dijkstra.h / apsp.h, graful dinamic din dyn_graph.h si graful comprimat din
+ * compressed_graph.h.
+ *
+ * Grafurile sunt NEORIENTATE (fiecare muchie este pusa in ambele sensuri),
+ * cu costuri intre 1 si BENCH_MAX_COST. Sortarea topologica se face pe DAG-ul
+ * obtinut orientand fiecare muchie de la nodul mai mic la cel mai mare.
+ *
+ *   rmat   R-MAT (Chakrabarti et al.) cu parametrii din Graph500: putine
+ *          noduri cu grad foarte mare, diametru mic
+ *   er     Erdos-Renyi G(n, m): capete alese uniform
+ *   grid   grila 2^(scale/2) x 2^(scale - scale/2)
+ *   chain  lant 0 - 1 - ... - n-1
+ *   star   nodul 0 legat de toate celelalte
+ *
+ * Fiecare reprezentare este testata intr-un proces copil separat, deci
+ * varful de memorie (ru_maxrss) este al ei, plus lista de muchii generata,
+ * comuna tuturor. Matricele si Floyd-Warshall ruleaza doar pe grafurile
+ * destul de mici (BENCH_*_MAX_NODES).
+ *
+ * Rezultatul este in format CSV, un rand pe faza:
+ *   graph,scale,nodes,edges,repr,phase,seconds,medges_per_sec,peak_rss_kb,result
+ * medges_per_sec este numarul de muchii orientate (2 * edges, respectiv
+ * edges pe DAG) impartit la durata, in milioane pe secunda; pentru
+ * Floyd-Warshall lipseste. result este o suma de control care trebuie sa fie
+ * aceeasi pentru toate reprezentarile:
+ *   bfs        suma (nivel + 1) pe nodurile atinse din 0
+ *   dfs        numarul de noduri atinse din 0
+ *   components numarul de componente conexe
+ *   bipartite  1 daca graful este bipartit
+ *   minpath    suma distantelor minime din 0 spre nodurile atinse
+ *   fw         suma distantelor finite intre toate perechile
+ *   topsort    1 daca ordinea gasita respecta toate muchiile DAG-ului
+ * La build pentru compressed, result este memoria ocupata de graf, in
+ * octeti.
+ *
+ * Utilizare: ./graph_bench [graf|all] [scale] [degree] [seed]
+ *   noduri = 2^scale, muchii = degree * noduri pentru rmat si er
+ */
+
+#define BENCH_MAX_COST 100
+#define BENCH_MATRIX_MAX_NODES 4096
+#define BENCH_BIT_MATRIX_MAX_NODES 16384
+#define BENCH_FW_MAX_NODES 1024
+#define BENCH_INF (INT_MAX / 2)
+
+/* Probabilitatile cadranelor pentru R-MAT (d = 1 - a - b - c) */
+#define RMAT_A 0.57
+#define RMAT_B 0.19
+#define RMAT_C 0.19
+
+/* --- generatoare --- */
+
+/* Muchii orientate; graful neorientat are fiecare muchie de doua ori */
+typedef struct edge_list_t edge_list_t;
+struct edge_list_t
+{
+	int nodes;
+	long edges;
+	long capacity;
+	int *src;
+	int *dst;
+	int *weight;
+};
+
+static uint64_t rng_state;
+
+/* splitmix64 */
+static uint64_t
+rng_next(void)
+{
+	uint64_t z = (rng_state += 0x9e3779b97f4a7c15ull);
+
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+	return z ^ (z >> 31);
+}
+
+static inline int
+rng_below(int n)
+{
+	return (int)(rng_next() % (uint64_t)n);
+}
+
+static inline double
+rng_double(void)
+{
+	return (rng_next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static edge_list_t *
+el_create(int nodes, long capacity)
+{
+	edge_list_t *el = calloc(1, sizeof(*el));
+	DIE(!el, "calloc() failed\n");
+
+	el->nodes = nodes;
+	el->capacity = capacity ? capacity : 1;
+	el->src = malloc(el->capacity * sizeof(int));
+	el->dst = malloc(el->capacity * sizeof(int));
+	el->weight = malloc(el->capacity * sizeof(int));
+	DIE(!el->src || !el->dst || !el->weight, "malloc() failed\n");
+
+	return el;
+}
+
+static void
+el_add(edge_list_t *el, int u, int v, int w)
+{
+	DIE(el->edges == el->capacity, "edge list full\n");
+
+	el->src[el->edges] = u;
+	el->dst[el->edges] = v;
+	el->weight[el->edges] = w;
+	el->edges++;
+}
+
+/* Muchia neorientata u - v, cu un cost aleator */
+static void
+el_add_pair(edge_list_t *el, int u, int v)
+{
+	int w = 1 + rng_below(BENCH_MAX_COST);
+
+	el_add(el, u, v, w);
+	el_add(el, v, u, w);
+}
+
+static void
+el_free(edge_list_t *el)
+{
+	free(el->src);
+	free(el->dst);
+	free(el->weight);
+	free(el);
+}
+
+static void
+rmat_pair(int scale, int *u, int *v)
+{
+	int x = 0, y = 0;
+
+	for (int b = 0; b < scale; b++) {
+		double r = rng_double();
+
+		x <<= 1;
+		y <<= 1;
+		if (r < RMAT_A)
+			continue;
+		if (r < RMAT_A + RMAT_B)
+			y |= 1;
+		else if (r < RMAT_A + RMAT_B + RMAT_C)
+			x |= 1;
+		else
+			x |= 1, y |= 1;
+	}
+
+	*u = x;
+	*v = y;
+}
+
+/* Fara bucle; muchiile duble sunt pastrate */
+static edge_list_t *
+gen_rmat(int scale, int degree)
+{
+	int n = 1 << scale;
+	long m = (long)degree * n;
+	edge_list_t *el = el_create(n, 2 * m);
+
+	for (long i = 0; i < m; i++) {
+		int u, v;
+
+		do
+			rmat_pair(scale, &u, &v);
+		while (u == v);
+		el_add_pair(el, u, v);
+	}
+
+	return el;
+}
+
+static edge_list_t *
+gen_er(int scale, int degree)
+{
+	int n = 1 << scale;
+	long m = n > 1 ? (long)degree * n : 0;
+	edge_list_t *el = el_create(n, 2 * m);
+
+	for (long i = 0; i < m; i++) {
+		int u = rng_below(n), v;
+
+		do
+			v = rng_below(n);
+		while (u == v);
+		el_add_pair(el, u, v);
+	}
+
+	return el;
+}
+
+static edge_list_t *
+gen_grid(int scale)
+{
+	int rows = 1 << (scale / 2), cols = 1 << (scale - scale / 2);
+	edge_list_t *el = el_create(rows * cols, 4L * rows * cols);
+
+	for (int r = 0; r < rows; r++)
+		for (int c = 0; c < cols; c++) {
+			int v = r * cols + c;
+
+			if (c + 1 < cols)
+				el_add_pair(el, v, v + 1);
+			if (r + 1 < rows)
+				el_add_pair(el, v, v + cols);
+		}
+
+	return el;
+}
+
+static edge_list_t *
+gen_chain(int scale)
+{
+	int n = 1 << scale;
+	edge_list_t *el = el_create(n, 2L * n);
+
+	for (int v = 0; v + 1 < n; v++)
+		el_add_pair(el, v, v + 1);
+
+	return el;
+}
+
+static edge_list_t *
+gen_star(int scale)
+{
+	int n = 1 << scale;
+	edge_list_t *el = el_create(n, 2L * n);
+
+	for (int v = 1; v < n; v++)
+		el_add_pair(el, 0, v);
+
+	return el;
+}
+
+/* DAG-ul grafului: fiecare muchie neorientata, de la capatul mai mic */
+static edge_list_t *
+el_to_dag(const edge_list_t *el)
+{
+	edge_list_t *dag = el_create(el->nodes, el->edges / 2);
+
+	for (long i = 0; i < el->edges; i++)
+		if (el->src[i] < el->dst[i])
+			el_add(dag, el->src[i], el->dst[i], el->weight[i]);
+
+	return dag;
+}
+
+/* 1 daca order[] (o permutare a nodurilor) respecta toate muchiile */
+static int
+check_top_order(const edge_list_t *dag, const int *order)
+{
+	int *pos = malloc((dag->nodes ? dag->nodes : 1) * sizeof(int));
+	DIE(!pos, "malloc() failed\n");
+
+	for (int i = 0; i < dag->nodes; i++)
+		pos[order[i]] = i;
+
+	int ok = 1;
+	for (long i = 0; i < dag->edges && ok; i++)
+		ok = pos[dag->src[i]] < pos[dag->dst[i]];
+
+	free(pos);
+	return ok;
+}
+
+/* --- raportare --- */
+
+typedef struct bench_t bench_t;
+struct bench_t
+{
+	const char *graph;
+	int scale;
+	const edge_list_t *el;
+	const edge_list_t *dag;
+	const char *repr;
+	double start;
+	double seconds;
+};
+
+static double
+now_sec(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static long
+peak_rss_kb(void)
+{
+	struct rusage ru;
+
+	getrusage(RUSAGE_SELF, &ru);
+	return ru.ru_maxrss;
+}
+
+static void
+phase_start(bench_t *b)
+{
+	b->start = now_sec();
+}
+
+/* Opreste ceasul; sumele de control calculate dupa nu intra in durata */
+static void
+phase_stop(bench_t *b)
+{
+	b->seconds = now_sec() - b->start;
+}
+
+/* Randul fazei oprite cu phase_stop; work = muchiile parcurse, 0 daca
+ * debitul nu are sens */
+static void
+phase_report(bench_t *b, const char *phase, long work, long long result)
+{
+	printf("%s,%d,%d,%ld,%s,%s,%.6f,", b->graph, b->scale, b->el->nodes,
+		   b->el->edges / 2, b->repr, phase, b->seconds);
+	if (work && b->seconds > 0)
+		printf("%.2f", work / b->seconds / 1e6);
+	printf(",%ld,%lld\n", peak_rss_kb(), result);
+	fflush(stdout);
+}
+
+static void
+phase_end(bench_t *b, const char *phase, long work, long long result)
+{
+	phase_stop(b);
+	phase_report(b, phase, work, result);
+}
+
+/* Vectori folositi de mai multe parcurgeri */
+static int *
+alloc_nodes(int nodes)
+{
+	int *a = malloc((nodes ? nodes : 1) * sizeof(int));
+	DIE(!a, "malloc() failed\n");
+
+	return a;
+}
+
+static int *
+alloc_marks(int nodes)
+{
+	int *a = alloc_nodes(nodes);
+
+	for (int v = 0; v < nodes; v++)
+		a[v] = -1;
+
+	return a;
+}
+
+/* --- liste de adiacenta --- */
+
+typedef struct ll_node_t ll_node_t;
+struct ll_node_t
+{
+	void* data;
+	ll_node_t* next;
+};
+
+typedef struct linked_list_t linked_list_t;
+struct linked_list_t
+{
+	ll_node_t* head;
+	unsigned int data_size;
+	unsigned int size;
+};
+
+/* Muchie cu cost; node este primul camp, ca in minpath.c */
+typedef struct wedge_t wedge_t;
+struct wedge_t
+{
+	int node;
+	int cost;
+};
+
+typedef struct
+{
+	linked_list_t** neighbors; /* Listele de adiacenta ale grafului */
+	int nodes;                 /* Numarul de noduri din graf. */
+} list_graph_t;
+
+static linked_list_t*
+ll_create(unsigned int data_size)
+{
+	linked_list_t* ll = calloc(1, sizeof(*ll));
+	DIE(!ll, "calloc() failed\n");
+	ll->data_size = data_size;
+
+	return ll;
+}
+
+/* Adauga un nod la inceputul listei */
+static void
+ll_add_first(linked_list_t* list, const void* new_data)
+{
+	ll_node_t* node = malloc(sizeof(*node));
+	DIE(!node, "malloc() failed\n");
+	node->data = malloc(list->data_size);
+	DIE(!node->data, "malloc() failed\n");
+	memcpy(node->data, new_data, list->data_size);
+
+	node->next = list->head;
+	list->head = node;
+	++list->size;
+}
+
+static void
+ll_free(linked_list_t** pp_list)
+{
+	ll_node_t* node = (*pp_list)->head;
+
+	while (node) {
+		ll_node_t* next = node->next;
+		free(node->data);
+		free(node);
+		node = next;
+	}
+
+	free(*pp_list);
+	*pp_list = NULL;
+}
+
+/*
+ * Muchiile sunt adaugate de la ultima la prima, la inceputul listelor, deci
+ * vecinii raman in ordinea din el, ca in CSR, fara sa parcurgem lista la
+ * fiecare adaugare.
+ */
+static list_graph_t*
+lg_from_edges(const edge_list_t* el)
+{
+	list_graph_t* graph = malloc(sizeof(*graph));
+	DIE(!graph, "malloc() failed\n");
+
+	graph->neighbors = malloc((el->nodes ? el->nodes : 1) * sizeof(linked_list_t *));
+	DIE(!graph->neighbors, "malloc() failed\n");
+	for (int i = 0; i < el->nodes; i++)
+		graph->neighbors[i] = ll_create(sizeof(wedge_t));
+	graph->nodes = el->nodes;
+
+	for (long i = el->edges - 1; i >= 0; i--) {
+		wedge_t e = { .node = el->dst[i], .cost = el->weight[i] };
+		ll_add_first(graph->neighbors[el->src[i]], &e);
+	}
+
+	return graph;
+}
+
+static void
+lg_free(list_graph_t* graph)
+{
+	for (int i = 0; i < graph->nodes; i++)
+		ll_free(&graph->neighbors[i]);
+	free(graph->neighbors);
+	free(graph);
+}
+
+static long long
+lg_bfs(list_graph_t* lg, int source)
+{
+	int *queue = alloc_nodes(lg->nodes);
+	int *level = alloc_marks(lg->nodes);
+	int head = 0, tail = 0;
+	long long sum = 0;
+
+	level[source] = 0;
+	queue[tail++] = source;
+
+	while (head < tail) {
+		int x = queue[head++];
+		sum += level[x] + 1;
+
+		for (ll_node_t* it = lg->neighbors[x]->head; it; it = it->next) {
+			int y = ((wedge_t *)it->data)->node;
+			if (level[y] < 0) {
+				level[y] = level[x] + 1;
+				queue[tail++] = y;
+			}
+		}
+	}
+
+	free(queue);
+	free(level);
+	return sum;
+}
+
+/* DFS iterativ; stiva retine pentru fiecare nod urmatorul vecin de examinat */
+static long long
+lg_dfs(list_graph_t* lg, int source)
+{
+	ll_node_t **cursor = malloc((lg->nodes ? lg->nodes : 1) * sizeof(*cursor));
+	int *stack = alloc_nodes(lg->nodes);
+	char *visited = calloc(lg->nodes ? lg->nodes : 1, 1);
+	DIE(!cursor || !visited, "malloc() failed\n");
+
+	int depth = 0;
+	long long count = 1;
+
+	visited[source] = 1;
+	cursor[source] = lg->neighbors[source]->head;
+	stack[depth++] = source;
+
+	while (depth) {
+		int x = stack[depth - 1];
+		ll_node_t *it = cursor[x];
+
+		if (!it) {
+			depth--;
+			continue;
+		}
+
+		cursor[x] = it->next;
+		int y = ((wedge_t *)it->data)->node;
+		if (!visited[y]) {
+			visited[y] = 1;
+			cursor[y] = lg->neighbors[y]->head;
+			stack[depth++] = y;
+			count++;
+		}
+	}
+
+	free(cursor);
+	free(stack);
+	free(visited);
+	return count;
+}
+
+/*
+ * BFS din fiecare nod nevizitat inca. color[v] = paritatea nivelului lui v;
+ * *bipartite devine 0 daca o muchie uneste doua noduri de aceeasi paritate.
+ * Intoarce numarul de componente.
+ */
+static int
+lg_color(list_graph_t* lg, int *bipartite)
+{
+	int *queue = alloc_nodes(lg->nodes);
+	int *color = alloc_marks(lg->nodes);
+	int components = 0;
+
+	*bipartite = 1;
+	for (int s = 0; s < lg->nodes; s++) {
+		if (color[s] >= 0)
+			continue;
+
+		int head = 0, tail = 0;
+		components++;
+		color[s] = 0;
+		queue[tail++] = s;
+
+		while (head < tail) {
+			int x = queue[head++];
+
+			for (ll_node_t* it = lg->neighbors[x]->head; it; it = it->next) {
+				int y = ((wedge_t *)it->data)->node;
+				if (color[y] < 0) {
+					color[y] = !color[x];
+					queue[tail++] = y;
+				} else if (color[y] == color[x]) {
+					*bipartite = 0;
+				}
+			}
+		}
+	}
+
+	free(queue);
+	free(color);
+	return components;
+}
+
+static long long
+lg_dijkstra(list_graph_t* lg, int source)
+{
+	long long *dist = malloc((lg->nodes ? lg->nodes : 1) * sizeof(long long));
+	DIE(!dist, "malloc() failed\n");
+	for (int v = 0; v < lg->nodes; v++)
+		dist[v] = SP_INF;
+
+	dheap_t *h = dheap_create(lg->nodes);
+	long long d, sum = 0;
+
+	dist[source] = 0;
+	dheap_push(h, source, 0);
+
+	while (!dheap_is_empty(h)) {
+		int x = dheap_pop(h, &d);
+		sum += d;
+
+		for (ll_node_t* it = lg->neighbors[x]->head; it; it = it->next) {
+			wedge_t *e = it->data;
+
+			if (d + e->cost >= dist[e->node])
+				continue;
+			dist[e->node] = d + e->cost;
+			if (dheap_contains(h, e->node))
+				dheap_decrease_key(h, e->node, d + e->cost);
+			else
+				dheap_push(h, e->node, d + e->cost);
+		}
+	}
+
+	dheap_free(h);
+	free(dist);
+	return sum;
+}
+
+/* Sortare topologica: ordinea inversa a terminarii nodurilor in DFS */
+static void
+lg_top_sort(list_graph_t* lg, int *order)
+{
+	ll_node_t **cursor = malloc((lg->nodes ? lg->nodes : 1) * sizeof(*cursor));
+	int *stack = alloc_nodes(lg->nodes);
+	char *visited = calloc(lg->nodes ? lg->nodes : 1, 1);
+	DIE(!cursor || !visited, "malloc() failed\n");
+
+	int pos = lg->nodes;
+
+	for (int s = 0; s < lg->nodes; s++) {
+		if (visited[s])
+			continue;
+
+		int depth = 0;
+		visited[s] = 1;
+		cursor[s] = lg->neighbors[s]->head;
+		stack[depth++] = s;
+
+		while (depth) {
+			int x = stack[depth - 1];
+			ll_node_t *it = cursor[x];
+
+			if (!it) {
+				order[--pos] = x;
+				depth--;
+				continue;
+			}
+
+			cursor[x] = it->next;
+			int y = ((wedge_t *)it->data)->node;
+			if (!visited[y]) {
+				visited[y] = 1;
+				cursor[y] = lg->neighbors[y]->head;
+				stack[depth++] = y;
+			}
+		}
+	}
+
+	free(cursor);
+	free(stack);
+	free(visited);
+}
+
+static void
+bench_list(bench_t *b)
+{
+	long arcs = b->el->edges;
+	int bipartite;
+
+	phase_start(b);
+	list_graph_t *lg = lg_from_edges(b->el);
+	phase_end(b, "build", arcs, 0);
+
+	phase_start(b);
+	long long r = lg_bfs(lg, 0);
+	phase_end(b, "bfs", arcs, r);
+
+	phase_start(b);
+	r = lg_dfs(lg, 0);
+	phase_end(b, "dfs", arcs, r);
+
+	phase_start(b);
+	r = lg_color(lg, &bipartite);
+	phase_end(b, "components", arcs, r);
+
+	phase_start(b);
+	lg_color(lg, &bipartite);
+	phase_end(b, "bipartite", arcs, bipartite);
+
+	phase_start(b);
+	r = lg_dijkstra(lg, 0);
+	phase_end(b, "minpath", arcs, r);
+
+	lg_free(lg);
+
+	int *order = alloc_nodes(b->dag->nodes);
+
+	phase_start(b);
+	lg = lg_from_edges(b->dag);
+	phase_end(b, "build_dag", b->dag->edges, 0);
+
+	phase_start(b);
+	lg_top_sort(lg, order);
+	phase_stop(b);
+	phase_report(b, "topsort", b->dag->edges, check_top_order(b->dag, order));
+
+	lg_free(lg);
+	free(order);
+}
+
+/* --- matrice de costuri --- */
+
+typedef struct
+{
+	int** matrix; /* matrix[i][j] = costul muchiei i -> j, 0 daca nu exista */
+	int nodes;    /* Numarul de noduri din graf. */
+} matrix_graph_t;
+
+/* La muchii duble se pastreaza costul minim */
+static matrix_graph_t*
+mg_from_edges(const edge_list_t* el)
+{
+	matrix_graph_t* graph = malloc(sizeof(matrix_graph_t));
+	DIE(!graph, "malloc() failed\n");
+
+	graph->matrix = calloc(el->nodes ? el->nodes : 1, sizeof(int *));
+	DIE(!graph->matrix, "calloc() failed\n");
+	for (int i = 0; i < el->nodes; i++) {
+		graph->matrix[i] = calloc(el->nodes, sizeof(int));
+		DIE(!graph->matrix[i], "calloc() failed\n");
+	}
+	graph->nodes = el->nodes;
+
+	for (long i = 0; i < el->edges; i++) {
+		int *cell = &graph->matrix[el->src[i]][el->dst[i]];
+		if (!*cell || el->weight[i] < *cell)
+			*cell = el->weight[i];
+	}
+
+	return graph;
+}
+
+static void
+mg_free(matrix_graph_t* graph)
+{
+	for (int i = 0; i < graph->nodes; i++)
+		free(graph->matrix[i]);
+	free(graph->matrix);
+	free(graph);
+}
+
+static long long
+mg_bfs(matrix_graph_t* mg, int source)
+{
+	int *queue = alloc_nodes(mg->nodes);
+	int *level = alloc_marks(mg->nodes);
+	int head = 0, tail = 0;
+	long long sum = 0;
+
+	level[source] = 0;
+	queue[tail++] = source;
+
+	while (head < tail) {
+		int x = queue[head++];
+		sum += level[x] + 1;
+
+		for (int y = 0; y < mg->nodes; y++)
+			if (mg->matrix[x][y] && level[y] < 0) {
+				level[y] = level[x] + 1;
+				queue[tail++] = y;
+			}
+	}
+
+	free(queue);
+	free(level);
+	return sum;
+}
+
+/* Stiva retine pentru fiecare nod urmatoarea coloana de examinat */
+static long long
+mg_dfs(matrix_graph_t* mg, int source)
+{
+	int *cursor = alloc_nodes(mg->nodes);
+	int *stack = alloc_nodes(mg->nodes);
+	char *visited = calloc(mg->nodes ? mg->nodes : 1, 1);
+	DIE(!visited, "calloc() failed\n");
+
+	int depth = 0;
+	long long count = 1;
+
+	visited[source] = 1;
+	cursor[source] = 0;
+	stack[depth++] = source;
+
+	while (depth) {
+		int x = stack[depth - 1];
+		int y = cursor[x];
+
+		while (y < mg->nodes && (!mg->matrix[x][y] || visited[y]))
+			y++;
+		cursor[x] = y + 1;
+
+		if (y == mg->nodes) {
+			depth--;
+			continue;
+		}
+
+		visited[y] = 1;
+		cursor[y] = 0;
+		stack[depth++] = y;
+		count++;
+	}
+
+	free(cursor);
+	free(stack);
+	free(visited);
+	return count;
+}
+
+/* Ca lg_color */
+static int
+mg_color(matrix_graph_t* mg, int *bipartite)
+{
+	int *queue = alloc_nodes(mg->nodes);
+	int *color = alloc_marks(mg->nodes);
+	int components = 0;
+
+	*bipartite = 1;
+	for (int s = 0; s < mg->nodes; s++) {
+		if (color[s] >= 0)
+			continue;
+
+		int head = 0, tail = 0;
+		components++;
+		color[s] = 0;
+		queue[tail++] = s;
+
+		while (head < tail) {
+			int x = queue[head++];
+
+			for (int y = 0; y < mg->nodes; y++) {
+				if (!mg->matrix[x][y])
+					continue;
+				if (color[y] < 0) {
+					color[y] = !color[x];
+					queue[tail++] = y;
+				} else if (color[y] == color[x]) {
+					*bipartite = 0;
+				}
+			}
+		}
+	}
+
+	free(queue);
+	free(color);
+	return components;
+}
+
+/* Dijkstra clasic pe matrice, O(n^2): minimul se cauta liniar */
+static long long
+mg_dijkstra(matrix_graph_t* mg, int source)
+{
+	long long *dist = malloc((mg->nodes ? mg->nodes : 1) * sizeof(long long));
+	char *done = calloc(mg->nodes ? mg->nodes : 1, 1);
+	DIE(!dist || !done, "malloc() failed\n");
+	for (int v = 0; v < mg->nodes; v++)
+		dist[v] = SP_INF;
+
+	long long sum = 0;
+	dist[source] = 0;
+
+	while (1) {
+		int x = -1;
+
+		for (int v = 0; v < mg->nodes; v++)
+			if (!done[v] && dist[v] != SP_INF && (x < 0 || dist[v] < dist[x]))
+				x = v;
+		if (x < 0)
+			break;
+
+		done[x] = 1;
+		sum += dist[x];
+
+		for (int y = 0; y < mg->nodes; y++)
+			if (mg->matrix[x][y] && dist[x] + mg->matrix[x][y] < dist[y])
+				dist[y] = dist[x] + mg->matrix[x][y];
+	}
+
+	free(dist);
+	free(done);
+	return sum;
+}
+
+/* Floyd-Warshall ca in FloydWarshall.c, fara afisare */
+static long long
+mg_floyd_warshall(matrix_graph_t* mg)
+{
+	int n = mg->nodes;
+	int **dist = malloc((n ? n : 1) * sizeof(int *));
+	DIE(!dist, "malloc() failed\n");
+
+	for (int i = 0; i < n; i++) {
+		dist[i] = malloc(n * sizeof(int));
+		DIE(!dist[i], "malloc() failed\n");
+		for (int j = 0; j < n; j++)
+			dist[i][j] = i == j ? 0 : mg->matrix[i][j] ? mg->matrix[i][j] : BENCH_INF;
+	}
+
+	for (int k = 0; k < n; k++)
+		for (int i = 0; i < n; i++)
+			for (int j = 0; j < n; j++)
+				if (dist[i][k] + dist[k][j] < dist[i][j])
+					dist[i][j] = dist[i][k] + dist[k][j];
+
+	long long sum = 0;
+	for (int i = 0; i < n; i++) {
+		for (int j = 0; j < n; j++)
+			if (dist[i][j] < BENCH_INF)
+				sum += dist[i][j];
+		free(dist[i]);
+	}
+	free(dist);
+
+	return sum;
+}
+
+static void
+mg_top_sort(matrix_graph_t* mg, int *order)
+{
+	int *cursor = alloc_nodes(mg->nodes);
+	int *stack = alloc_nodes(mg->nodes);
+	char *visited = calloc(mg->nodes ? mg->nodes : 1, 1);
+	DIE(!visited, "calloc() failed\n");
+
+	int pos = mg->nodes;
+
+	for (int s = 0; s < mg->nodes; s++) {
+		if (visited[s])
+			continue;
+
+		int depth = 0;
+		visited[s] = 1;
+		cursor[s] = 0;
+		stack[depth++] = s;
+
+		while (depth) {
+			int x = stack[depth - 1];
+			int y = cursor[x];
+
+			while (y < mg->nodes && (!mg->matrix[x][y] || visited[y]))
+				y++;
+			cursor[x] = y + 1;
+
+			if (y == mg->nodes) {
+				order[--pos] = x;
+				depth--;
+				continue;
+			}
+
+			visited[y] = 1;
+			cursor[y] = 0;
+			stack[depth++] = y;
+		}
+	}
+
+	free(cursor);
+	free(stack);
+	free(visited);
+}
+
+static void
+bench_matrix(bench_t *b)
+{
+	long arcs = b->el->edges;
+	int bipartite;
+
+	phase_start(b);
+	matrix_graph_t *mg = mg_from_edges(b->el);
+	phase_end(b, "build", arcs, 0);
+
+	phase_start(b);
+	long long r = mg_bfs(mg, 0);
+	phase_end(b, "bfs", arcs, r);
+
+	phase_start(b);
+	r = mg_dfs(mg, 0);
+	phase_end(b, "dfs", arcs, r);
+
+	phase_start(b);
+	r = mg_color(mg, &bipartite);
+	phase_end(b, "components", arcs, r);
+
+	phase_start(b);
+	mg_color(mg, &bipartite);
+	phase_end(b, "bipartite", arcs, bipartite);
+
+	phase_start(b);
+	r = mg_dijkstra(mg, 0);
+	phase_end(b, "minpath", arcs, r);
+
+	if (mg->nodes <= BENCH_FW_MAX_NODES) {
+		phase_start(b);
+		r = mg_floyd_warshall(mg);
+		phase_end(b, "fw", 0, r);
+	}
+
+	mg_free(mg);
+
+	int *order = alloc_nodes(b->dag->nodes);
+
+	phase_start(b);
+	mg = mg_from_edges(b->dag);
+	phase_end(b, "build_dag", b->dag->edges, 0);
+
+	phase_start(b);
+	mg_top_sort(mg, order);
+	phase_stop(b);
+	phase_report(b, "topsort", b->dag->edges, check_top_order(b->dag, order));
+
+	mg_free(mg);
+	free(order);
+}
+
+/* --- matrice de biti --- */
+
+/* BFS pe niveluri: frontiera si nodurile vizitate sunt linii de biti */
+static long long
+bm_bfs(const bit_matrix_t *bm, int source, uint64_t *visited)
+{
+	uint64_t *frontier = bm_alloc_row(bm);
+	uint64_t *next = bm_alloc_row(bm);
+	long long sum = 1;
+	int level = 1;
+
+	frontier[source >> 6] |= (uint64_t)1 << (source & 63);
+	visited[source >> 6] |= (uint64_t)1 << (source & 63);
+
+	for (long count; (count = bm_expand(bm, frontier, visited, next)); level++) {
+		sum += count * (level + 1);
+		bm_row_or(visited, next, bm->row_words);
+
+		uint64_t *t = frontier;
+		frontier = next;
+		next = t;
+	}
+
+	free(frontier);
+	free(next);
+	return sum;
+}
+
+static void
+bench_bit_matrix(bench_t *b)
+{
+	const edge_list_t *el = b->el;
+
+	phase_start(b);
+	bit_matrix_t *bm = bm_create(el->nodes);
+	for (long i = 0; i < el->edges; i++)
+		bm_set(bm, el->src[i], el->dst[i]);
+	phase_end(b, "build", el->edges, 0);
+
+	uint64_t *visited = bm_alloc_row(bm);
+
+	phase_start(b);
+	long long r = bm_bfs(bm, 0, visited);
+	phase_end(b, "bfs", el->edges, r);
+
+	memset(visited, 0, bm->row_words * sizeof(uint64_t));
+	phase_start(b);
+	r = 0;
+	for (int s = 0; s < el->nodes; s++)
+		if (!((visited[s >> 6] >> (s & 63)) & 1)) {
+			bm_bfs(bm, s, visited);
+			r++;
+		}
+	phase_end(b, "components", el->edges, r);
+
+	free(visited);
+	bm_free(bm);
+}
+
+/* --- CSR --- */
+
+static int
+count_pre(void *arg, int node, int parent)
+{
+	(void)node;
+	(void)parent;
+	(*(long long *)arg)++;
+	return 0;
+}
+
+static void
+bench_csr(bench_t *b)
+{
+	const edge_list_t *el = b->el;
+	long arcs = el->edges;
+	thread_pool_t *tp = tp_create(0);
+
+	phase_start(b);
+	csr_graph_t *g = csr_create_from_edges(el->nodes, el->edges, el->src,
+										   el->dst, el->weight);
+	phase_end(b, "build", arcs, 0);
+
+	/* Graful este simetric, deci este propriul transpus */
+	phase_start(b);
+	bfs_result_t *bfs = bfs_parallel(tp, g, g, 0);
+	phase_stop(b);
+	long long r = 0;
+	for (int v = 0; v < g->nodes; v++)
+		if (bfs->level[v] >= 0)
+			r += bfs->level[v] + 1;
+	phase_report(b, "bfs", arcs, r);
+	bfs_result_free(bfs);
+
+	long long count = 0;
+	dfs_visitor_t vis = { count_pre, NULL, NULL, &count };
+	phase_start(b);
+	dfs_t *d = dfs_create(g);
+	dfs_visit(d, 0, &vis);
+	dfs_free(d);
+	phase_end(b, "dfs", arcs, count);
+
+	phase_start(b);
+	cc_result_t *cc = cc_from_csr(g);
+	phase_end(b, "components", arcs, cc->components);
+	cc_result_free(cc);
+
+	phase_start(b);
+	bip_result_t *bip = bipartite_parallel(tp, g);
+	phase_end(b, "bipartite", arcs, bip->bipartite);
+	bip_result_free(bip);
+
+	phase_start(b);
+	sp_result_t *sp = dijkstra_csr(g, 0, -1);
+	phase_stop(b);
+	r = 0;
+	for (int v = 0; v < g->nodes; v++)
+		if (sp->dist[v] != SP_INF)
+			r += sp->dist[v];
+	phase_report(b, "minpath", arcs, r);
+	sp_result_free(sp);
+
+	if (g->nodes <= BENCH_FW_MAX_NODES) {
+		phase_start(b);
+		apsp_t *a = apsp_from_csr(g, 0);
+		apsp_solve(a, tp);
+		phase_stop(b);
+		r = 0;
+		for (int i = 0; i < g->nodes; i++)
+			for (int j = 0; j < g->nodes; j++)
+				if (apsp_dist(a, i, j) < APSP_INF)
+					r += apsp_dist(a, i, j);
+		phase_report(b, "fw", 0, r);
+		apsp_free(a);
+	}
+
+	csr_free(g);
+
+	int *order = alloc_nodes(b->dag->nodes);
+
+	phase_start(b);
+	g = csr_create_from_edges(b->dag->nodes, b->dag->edges, b->dag->src,
+							  b->dag->dst, NULL);
+	phase_end(b, "build_dag", b->dag->edges, 0);
+
+	phase_start(b);
+	dfs_top_sort(g, order);
+	phase_stop(b);
+	phase_report(b, "topsort", b->dag->edges, check_top_order(b->dag, order));
+
+	csr_free(g);
+	free(order);
+	tp_free(tp);
+}
+
+/* --- graf dinamic --- */
+
+/* BFS din source peste nodurile cu level[v] < 0 */
+static long long
+dg_bfs(const dyn_graph_t *g, int source, int *level, int *queue)
+{
+	int head = 0, tail = 0;
+	long long sum = 0;
+
+	level[source] = 0;
+	queue[tail++] = source;
+
+	while (head < tail) {
+		int x = queue[head++];
+		const int *neigh = dg_neighbors(g, x);
+		sum += level[x] + 1;
+
+		for (int i = 0, deg = dg_degree(g, x); i < deg; i++)
+			if (level[neigh[i]] < 0) {
+				level[neigh[i]] = level[x] + 1;
+				queue[tail++] = neigh[i];
+			}
+	}
+
+	return sum;
+}
+
+static long long
+dg_dfs(const dyn_graph_t *g, int source)
+{
+	int *cursor = alloc_nodes(g->nodes);
+	int *stack = alloc_nodes(g->nodes);
+	char *visited = calloc(g->nodes ? g->nodes : 1, 1);
+	DIE(!visited, "calloc() failed\n");
+
+	int depth = 0;
+	long long count = 1;
+
+	visited[source] = 1;
+	cursor[source] = 0;
+	stack[depth++] = source;
+
+	while (depth) {
+		int x = stack[depth - 1];
+
+		if (cursor[x] == dg_degree(g, x)) {
+			depth--;
+			continue;
+		}
+
+		int y = dg_neighbors(g, x)[cursor[x]++];
+		if (!visited[y]) {
+			visited[y] = 1;
+			cursor[y] = 0;
+			stack[depth++] = y;
+			count++;
+		}
+	}
+
+	free(cursor);
+	free(stack);
+	free(visited);
+	return count;
+}
+
+/* Muchiile duble din rmat si er sunt adaugate o singura data */
+static void
+bench_dyn(bench_t *b)
+{
+	const edge_list_t *el = b->el;
+	long arcs = el->edges;
+
+	phase_start(b);
+	dyn_graph_t *g = dg_create(el->nodes);
+	for (long i = 0; i < el->edges; i++)
+		dg_add_edge(g, el->src[i], el->dst[i]);
+	phase_end(b, "build", arcs, 0);
+
+	int *level = alloc_marks(g->nodes);
+	int *queue = alloc_nodes(g->nodes);
+
+	phase_start(b);
+	long long r = dg_bfs(g, 0, level, queue);
+	phase_end(b, "bfs", arcs, r);
+
+	phase_start(b);
+	r = dg_dfs(g, 0);
+	phase_end(b, "dfs", arcs, r);
+
+	for (int v = 0; v < g->nodes; v++)
+		level[v] = -1;
+	phase_start(b);
+	r = 0;
+	for (int s = 0; s < g->nodes; s++)
+		if (level[s] < 0) {
+			dg_bfs(g, s, level, queue);
+			r++;
+		}
+	phase_end(b, "components", arcs, r);
+
+	free(level);
+	free(queue);
+	dg_free(g);
+}
+
+/* --- graf comprimat --- */
+
+static int
+count_roots(void *arg, int node, int parent)
+{
+	(void)node;
+	if (parent < 0)
+		(*(long long *)arg)++;
+	return 0;
+}
+
+typedef struct post_order_t post_order_t;
+struct post_order_t
+{
+	int *order;
+	int left;
+};
+
+static int
+post_order(void *arg, int node, int parent)
+{
+	post_order_t *s = arg;
+
+	(void)parent;
+	s->order[--s->left] = node;
+	return 0;
+}
+
+/* Graful se construieste din CSR; timpul include si constructia acestuia */
+static void
+bench_compressed(bench_t *b)
+{
+	const edge_list_t *el = b->el;
+	long arcs = el->edges;
+
+	phase_start(b);
+	csr_graph_t *g = csr_create_from_edges(el->nodes, el->edges, el->src,
+										   el->dst, NULL);
+	compressed_graph_t *c = cg_from_csr(g);
+	csr_free(g);
+	phase_end(b, "build", arcs, cg_memory(c));
+
+	int *level = alloc_nodes(c->nodes);
+
+	phase_start(b);
+	cg_bfs(c, 0, level, NULL);
+	phase_stop(b);
+	long long r = 0;
+	for (int v = 0; v < c->nodes; v++)
+		if (level[v] >= 0)
+			r += level[v] + 1;
+	phase_report(b, "bfs", arcs, r);
+	free(level);
+
+	long long count = 0;
+	dfs_visitor_t vis = { count_pre, NULL, NULL, &count };
+	phase_start(b);
+	dfs_t *d = dfs_create_compressed(c);
+	dfs_visit(d, 0, &vis);
+	dfs_free(d);
+	phase_end(b, "dfs", arcs, count);
+
+	count = 0;
+	vis.pre = count_roots;
+	phase_start(b);
+	d = dfs_create_compressed(c);
+	dfs_run(d, &vis);
+	dfs_free(d);
+	phase_end(b, "components", arcs, count);
+
+	cg_free(c);
+
+	post_order_t s = { alloc_nodes(b->dag->nodes), b->dag->nodes };
+	dfs_visitor_t top = { NULL, post_order, NULL, &s };
+
+	phase_start(b);
+	g = csr_create_from_edges(b->dag->nodes, b->dag->edges, b->dag->src,
+							  b->dag->dst, NULL);
+	c = cg_from_csr(g);
+	csr_free(g);
+	phase_end(b, "build_dag", b->dag->edges, cg_memory(c));
+
+	phase_start(b);
+	d = dfs_create_compressed(c);
+	dfs_run(d, &top);
+	dfs_free(d);
+	phase_stop(b);
+	phase_report(b, "topsort", b->dag->edges, check_top_order(b->dag, s.order));
+
+	free(s.order);
+	cg_free(c);
+}
+
+/* --- main --- */
+
+typedef struct repr_t repr_t;
+struct repr_t
+{
+	const char *name;
+	void (*run)(bench_t *b);
+	int max_nodes;      /* 0 = oricate */
+};
+
+static const repr_t reprs[] = {
+	{ "list", bench_list, 0 },
+	{ "matrix", bench_matrix, BENCH_MATRIX_MAX_NODES },
+	{ "bit_matrix", bench_bit_matrix, BENCH_BIT_MATRIX_MAX_NODES },
+	{ "csr", bench_csr, 0 },
+	{ "dyn", bench_dyn, 0 },
+	{ "compressed", bench_compressed, 0 },
+};
+
+static const char *graphs[] = { "rmat", "er", "grid", "chain", "star" };
+
+static edge_list_t *
+generate(const char *graph, int scale, int degree)
+{
+	if (strcmp(graph, "rmat") == 0)
+		return gen_rmat(scale, degree);
+	if (strcmp(graph, "er") == 0)
+		return gen_er(scale, degree);
+	if (strcmp(graph, "grid") == 0)
+		return gen_grid(scale);
+	if (strcmp(graph, "chain") == 0)
+		return gen_chain(scale);
+	if (strcmp(graph, "star") == 0)
+		return gen_star(scale);
+	return NULL;
+}
+
+/*
+ * Genereaza graful si ruleaza fiecare reprezentare intr-un proces copil;
+ * stdout este golit inainte de fork, ca randurile sa nu fie duplicate.
+ */
+static void
+bench_graph(const char *graph, int scale, int degree)
+{
+	bench_t b = { .graph = graph, .scale = scale, .repr = "gen" };
+
+	phase_start(&b);
+	edge_list_t *el = generate(graph, scale, degree);
+	edge_list_t *dag = el_to_dag(el);
+	b.el = el;
+	b.dag = dag;
+	phase_end(&b, "generate", el->edges, 0);
+
+	for (size_t i = 0; i < sizeof(reprs) / sizeof(reprs[0]); i++) {
+		if (reprs[i].max_nodes && el->nodes > reprs[i].max_nodes)
+			continue;
+
+		fflush(stdout);
+		pid_t pid = fork();
+		DIE(pid < 0, "fork() failed\n");
+
+		if (!pid) {
+			b.repr = reprs[i].name;
+			reprs[i].run(&b);
+			exit(0);
+		}
+
+		int status;
+		DIE(waitpid(pid, &status, 0) < 0, "waitpid() failed\n");
+		if (!WIFEXITED(status) || WEXITSTATUS(status))
+			fprintf(stderr, "%s/%s failed\n", graph, reprs[i].name);
+	}
+
+	el_free(el);
+	el_free(dag);
+}
+
+int main(int argc, char *argv[])
+{
+	const char *graph = argc > 1 ? argv[1] : "all";
+	int scale = argc > 2 ? atoi(argv[2]) : 14;
+	int degree = argc > 3 ? atoi(argv[3]) : 8;
+
+	rng_state = argc > 4 ? strtoull(argv[4], NULL, 10) : 1;
+
+	DIE(scale < 1 || scale > 30, "scale must be in 1..30\n");
+	DIE(degree < 1, "degree must be positive\n");
+
+	printf("graph,scale,nodes,edges,repr,phase,seconds,medges_per_sec,"
+		   "peak_rss_kb,result\n");
+
+	int found = 0;
+	for (size_t i = 0; i < sizeof(graphs) / sizeof(graphs[0]); i++)
+		if (strcmp(graph, "all") == 0 || strcmp(graph, graphs[i]) == 0) {
+			bench_graph(graphs[i], scale, degree);
+			found = 1;
+		}
+
+	DIE(!found, "unknown graph (rmat, er, grid, chain, star or all)\n");
+
+	return 0;
+}
@@ -16,6 +16,7 @@
 		}							\
 	} while (0)
 
+#include "dyn_graph.h"
 
 /* --- LINKED LIST SUPPORT START --- */
 
@@ -270,6 +271,7 @@ lg_create(int nodes)
         graph->neighbors[i] = ll_create(sizeof(int));
     
     graph->nodes = nodes;
+    return graph;
 }
 
 /* Adauga o muchie intre nodurile primite ca parametri */
@@ -338,10 +340,32 @@ lg_print_graph(list_graph_t* graph)
 	}
 }
 
-int main()
+/* Ca lg_print_graph, pentru graful cu vecini in tabele de dispersie */
+void
+dg_print_graph(dyn_graph_t* graph)
+{
+	for (int i = 0; i < graph->nodes; i++) {
+		const int *neigh = dg_neighbors(graph, i);
+
+		printf("%d: ", i);
+		for (int k = 0; k < dg_degree(graph, i); k++)
+			printf("%d ", neigh[k]);
+		printf("\n");
+	}
+}
+
+/*
+ * Cu argumentul "hash" graful este un dyn_graph_t (dyn_graph.h): has_edge,
+ * add_edge si remove_edge sunt O(1) in medie si pentru noduri cu milioane de
+ * vecini. O muchie care exista deja nu mai este adaugata, iar dupa stergeri
+ * ordinea vecinilor afisata de print_graph poate sa difere.
+ */
+int main(int argc, char *argv[])
 {
 
 	list_graph_t *lg = NULL;
+	dyn_graph_t *dg = NULL;
+	int hashed = argc > 1 && strcmp(argv[1], "hash") == 0;
 
 	while (1) {
 		char command[MAX_STRING_SIZE];
@@ -352,11 +376,17 @@ int main()
 
 		if (strncmp(command, "create_lg", 9) == 0) {
 			scanf("%d", &nr_nodes);
-			lg = lg_create(nr_nodes);
+			if (hashed)
+				dg = dg_create(nr_nodes);
+			else
+				lg = lg_create(nr_nodes);
 		}
 
 		if (strncmp(command, "add_edge", 8) == 0) {
-			if (lg != NULL) {
+			if (dg != NULL) {
+				scanf("%d %d", &nr1, &nr2);
+				dg_add_edge(dg, nr1, nr2);
+			} else if (lg != NULL) {
 				scanf("%d %d", &nr1, &nr2);
 				lg_add_edge(lg, nr1, nr2);
 			} else {
@@ -366,7 +396,11 @@ int main()
 		}
 
 		if (strncmp(command, "remove_edge", 11) == 0) {
-			if (lg != NULL) {
+			if (dg != NULL) {
+				scanf("%d %d", &nr1, &nr2);
+				if (!dg_remove_edge(dg, nr1, nr2))
+					printf("No edge to remove between the given nodes\n");
+			} else if (lg != NULL) {
 				scanf("%d %d", &nr1, &nr2);
 				lg_remove_edge(lg, nr1, nr2);
 			} else {
@@ -376,7 +410,9 @@ int main()
 		}
 
 		if (strncmp(command, "print_graph", 11) == 0) {
-			if (lg != NULL) {
+			if (dg != NULL) {
+				dg_print_graph(dg);
+			} else if (lg != NULL) {
 				lg_print_graph(lg);
 			} else {
 				printf("Create a graph first!\n");
@@ -385,10 +421,11 @@ int main()
 		}
 
 		if (strncmp(command, "has_edge", 5) == 0) {
-			if (lg != NULL) {
+			if (lg != NULL || dg != NULL) {
 				int flag;
 				scanf("%d %d", &nr1, &nr2);
-				flag = lg_has_edge(lg, nr1, nr2);
+				flag = dg ? dg_has_edge(dg, nr1, nr2)
+						  : lg_has_edge(lg, nr1, nr2);
 				if (flag == 1) {
 					printf("Has edge\n");
 				}
@@ -402,7 +439,9 @@ int main()
 		}
 
 		if (strncmp(command, "free", 4) == 0) {
-			if (lg != NULL) {
+			if (dg != NULL) {
+				dg_free(dg);
+			} else if (lg != NULL) {
 				lg_free(lg);
 			} else {
 				printf("Create a graph first!\n");
@@ -0,0 +1,471 @@
+#include <fcntl.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "graph_loader.h"
+
+/* Cati octeti de text parseaza cel mult un task */
+#define GL_CHUNK_SIZE (4L << 20)
+/* Cate muchii se scriu deodata in gl_save_binary */
+#define GL_WRITE_EDGES 65536
+
+typedef struct gl_map_t gl_map_t;
+struct gl_map_t
+{
+	int fd;
+	const char *data;
+	size_t size;
+};
+
+static void
+gl_map(const char *path, gl_map_t *m)
+{
+	struct stat st;
+
+	m->fd = open(path, O_RDONLY);
+	DIE(m->fd < 0, "open() failed\n");
+	DIE(fstat(m->fd, &st) < 0, "fstat() failed\n");
+
+	m->size = st.st_size;
+	m->data = NULL;
+	if (!m->size)
+		return;
+
+	m->data = mmap(NULL, m->size, PROT_READ, MAP_PRIVATE, m->fd, 0);
+	DIE(m->data == MAP_FAILED, "mmap() failed\n");
+	madvise((void *)m->data, m->size, MADV_SEQUENTIAL);
+}
+
+static void
+gl_unmap(gl_map_t *m)
+{
+	if (m->size)
+		munmap((void *)m->data, m->size);
+	close(m->fd);
+}
+
+/* --- Text --- */
+
+/* O bucata de text, incepe si se termina la capat de linie */
+typedef struct gl_chunk_t gl_chunk_t;
+struct gl_chunk_t
+{
+	const char *begin;
+	const char *end;
+	long first;         /* Primul slot din vectorii de muchii */
+	long count;         /* Cate sloturi foloseste (pasul 1: cel mult atatea) */
+	int max_id;
+};
+
+typedef struct gl_parse_t gl_parse_t;
+struct gl_parse_t
+{
+	gl_chunk_t *chunks;
+	int flags;
+	int *src;
+	int *dst;
+	int *weights;
+};
+
+static inline int
+is_blank(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+/*
+ * Citeste un intreg cu semn de la *pp, dupa spatii. Intoarce 0 (fara sa
+ * treaca de '\n') daca linia nu mai contine numere.
+ */
+static inline int
+parse_int(const char **pp, const char *end, int *out)
+{
+	const char *p = *pp;
+
+	while (p < end && is_blank(*p))
+		p++;
+	if (p == end || *p == '\n') {
+		*pp = p;
+		return 0;
+	}
+
+	int neg = *p == '-';
+	p += neg;
+	DIE(p == end || *p < '0' || *p > '9', "malformed edge line\n");
+
+	long long v = 0;
+	while (p < end && *p >= '0' && *p <= '9') {
+		v = v * 10 + (*p++ - '0');
+		DIE(v > INT_MAX, "number out of range\n");
+	}
+
+	*pp = p;
+	*out = neg ? (int)-v : (int)v;
+	return 1;
+}
+
+/* Sare peste liniile goale si comentarii; intoarce inceputul unei linii cu
+ * date sau end */
+static inline const char *
+skip_empty_lines(const char *p, const char *end)
+{
+	while (p < end) {
+		const char *q = p;
+
+		while (q < end && is_blank(*q))
+			q++;
+		if (q < end && *q != '\n' && *q != '#' && *q != '%')
+			return q;
+
+		q = memchr(q, '\n', end - q);
+		p = q ? q + 1 : end;
+	}
+
+	return end;
+}
+
+/* Pasul 1: fiecare linie poate contine cel mult o muchie */
+static void
+count_range(void *arg, long lo, long hi)
+{
+	gl_parse_t *s = arg;
+
+	for (long c = lo; c < hi; c++) {
+		gl_chunk_t *ch = &s->chunks[c];
+		long lines = 0;
+
+		for (const char *p = ch->begin; p < ch->end; lines++) {
+			p = memchr(p, '\n', ch->end - p);
+			if (!p)
+				break;
+			p++;
+		}
+		if (ch->end > ch->begin && ch->end[-1] != '\n')
+			lines++;
+
+		ch->count = lines * (s->flags & GL_UNDIRECTED ? 2 : 1);
+	}
+}
+
+/* Pasul 2: muchiile bucatii se scriu incepand cu slotul first */
+static void
+parse_range(void *arg, long lo, long hi)
+{
+	gl_parse_t *s = arg;
+
+	for (long c = lo; c < hi; c++) {
+		gl_chunk_t *ch = &s->chunks[c];
+		const char *p = ch->begin, *end = ch->end;
+		long k = ch->first;
+		int u, v, w = 0, extra, max_id = -1;
+
+		while ((p = skip_empty_lines(p, end)) < end) {
+			DIE(!parse_int(&p, end, &u) || !parse_int(&p, end, &v),
+				"edge line needs two nodes\n");
+			if (s->flags & GL_WEIGHTED)
+				DIE(!parse_int(&p, end, &w), "edge line needs a cost\n");
+			DIE(u < 0 || v < 0, "negative node id\n");
+			DIE(parse_int(&p, end, &extra), "too many numbers on edge line\n");
+
+			s->src[k] = u;
+			s->dst[k] = v;
+			if (s->weights)
+				s->weights[k] = w;
+			k++;
+
+			if (s->flags & GL_UNDIRECTED) {
+				s->src[k] = v;
+				s->dst[k] = u;
+				if (s->weights)
+					s->weights[k] = w;
+				k++;
+			}
+
+			if (u > max_id)
+				max_id = u;
+			if (v > max_id)
+				max_id = v;
+		}
+
+		ch->count = k - ch->first;
+		ch->max_id = max_id;
+	}
+}
+
+/*
+ * Parseaza un fisier text in s->src, s->dst si s->weights, cu muchiile in
+ * ordinea din fisier; intoarce numarul de muchii si pune in *nodes numarul de
+ * noduri (fara GL_HEADER, cel mai mare id + 1). Vectorii se elibereaza de
+ * apelant.
+ */
+static long
+parse_text(const char *path, int flags, thread_pool_t *tp, gl_parse_t *out,
+		   int *nodes_out)
+{
+	gl_map_t m;
+	gl_map(path, &m);
+
+	const char *p = m.data, *end = m.data + m.size;
+	int nodes = -1, header_edges;
+
+	if (flags & GL_HEADER) {
+		p = skip_empty_lines(p, end);
+		DIE(!parse_int(&p, end, &nodes) || !parse_int(&p, end, &header_edges)
+			|| nodes < 0, "missing graph header\n");
+		p = memchr(p, '\n', end - p);
+		p = p ? p + 1 : end;
+	}
+
+	/* Bucatile se termina dupa primul '\n' de dupa pozitia nominala */
+	long body = end - p;
+	int nchunks = body / GL_CHUNK_SIZE + 1;
+	if (tp && nchunks < 4 * tp_get_threads(tp) && body > 1 << 16)
+		nchunks = 4 * tp_get_threads(tp);
+
+	gl_parse_t s = { .flags = flags };
+	s.chunks = malloc(nchunks * sizeof(gl_chunk_t));
+	DIE(!s.chunks, "malloc() failed\n");
+
+	const char *prev = p;
+	for (int c = 0; c < nchunks; c++) {
+		const char *stop = c + 1 == nchunks ? end : p + body * (c + 1) / nchunks;
+
+		if (stop < prev)
+			stop = prev;
+		if (stop < end) {
+			stop = memchr(stop, '\n', end - stop);
+			stop = stop ? stop + 1 : end;
+		}
+		s.chunks[c].begin = prev;
+		s.chunks[c].end = stop;
+		prev = stop;
+	}
+
+	if (tp)
+		tp_parallel_for(tp, 0, nchunks, 1, count_range, &s);
+	else
+		count_range(&s, 0, nchunks);
+
+	long slots = 0;
+	for (int c = 0; c < nchunks; c++) {
+		s.chunks[c].first = slots;
+		slots += s.chunks[c].count;
+	}
+
+	s.src = malloc((slots ? slots : 1) * sizeof(int));
+	s.dst = malloc((slots ? slots : 1) * sizeof(int));
+	s.weights = flags & GL_WEIGHTED ? malloc((slots ? slots : 1) * sizeof(int))
+									: NULL;
+	DIE(!s.src || !s.dst || ((flags & GL_WEIGHTED) && !s.weights),
+		"malloc() failed\n");
+
+	if (tp)
+		tp_parallel_for(tp, 0, nchunks, 1, parse_range, &s);
+	else
+		parse_range(&s, 0, nchunks);
+
+	/* Muchiile bucatilor se aduc una dupa alta (sloturile nefolosite raman
+	 * la sfarsit) */
+	long edges = 0;
+	int max_id = -1;
+	for (int c = 0; c < nchunks; c++) {
+		gl_chunk_t *ch = &s.chunks[c];
+
+		if (ch->first != edges) {
+			memmove(s.src + edges, s.src + ch->first, ch->count * sizeof(int));
+			memmove(s.dst + edges, s.dst + ch->first, ch->count * sizeof(int));
+			if (s.weights)
+				memmove(s.weights + edges, s.weights + ch->first,
+						ch->count * sizeof(int));
+		}
+		edges += ch->count;
+		if (ch->max_id > max_id)
+			max_id = ch->max_id;
+	}
+	gl_unmap(&m);
+
+	free(s.chunks);
+	*out = s;
+	*nodes_out = nodes < 0 ? max_id + 1 : nodes;
+	return edges;
+}
+
+/*
+ * Incarca un graf dintr-un fisier text (vezi graph_loader.h). Fara
+ * GL_HEADER numarul de noduri este cel mai mare id + 1. tp poate fi NULL;
+ * atunci totul ruleaza pe thread-ul apelant.
+ */
+csr_graph_t *
+gl_load_text(const char *path, int flags, thread_pool_t *tp)
+{
+	gl_parse_t s;
+	int nodes;
+	long edges = parse_text(path, flags, tp, &s, &nodes);
+
+	csr_graph_t *g = csr_create_from_edges(nodes, edges, s.src, s.dst,
+										   s.weights);
+
+	free(s.src);
+	free(s.dst);
+	free(s.weights);
+	return g;
+}
+
+/* --- Binar --- */
+
+/*
+ * Incarca un graf salvat cu gl_save_binary. Dintre flag-uri conteaza doar
+ * GL_UNDIRECTED.
+ */
+csr_graph_t *
+gl_load_binary(const char *path, int flags)
+{
+	gl_map_t m;
+	gl_header_t h;
+
+	gl_map(path, &m);
+	DIE(m.size < sizeof(h), "truncated graph file\n");
+	memcpy(&h, m.data, sizeof(h));
+	DIE(memcmp(h.magic, GL_MAGIC, 8), "not a binary graph file\n");
+	DIE(h.nodes < 0 || h.edges < 0
+		|| m.size != sizeof(h) + (h.weighted ? 3 : 2) * h.edges * sizeof(int32_t),
+		"truncated graph file\n");
+
+	const int *src = (const int *)(m.data + sizeof(h));
+	const int *dst = src + h.edges;
+	const int *weights = h.weighted ? dst + h.edges : NULL;
+	csr_graph_t *g;
+
+	if (!(flags & GL_UNDIRECTED)) {
+		g = csr_create_from_edges(h.nodes, h.edges, src, dst, weights);
+	} else {
+		long edges = 2 * h.edges;
+		int *s2 = malloc((edges ? edges : 1) * sizeof(int));
+		int *d2 = malloc((edges ? edges : 1) * sizeof(int));
+		int *w2 = weights ? malloc((edges ? edges : 1) * sizeof(int)) : NULL;
+		DIE(!s2 || !d2 || (weights && !w2), "malloc() failed\n");
+
+		for (long e = 0; e < h.edges; e++) {
+			s2[2 * e] = d2[2 * e + 1] = src[e];
+			d2[2 * e] = s2[2 * e + 1] = dst[e];
+			if (w2)
+				w2[2 * e] = w2[2 * e + 1] = weights[e];
+		}
+
+		g = csr_create_from_edges(h.nodes, edges, s2, d2, w2);
+		free(s2);
+		free(d2);
+		free(w2);
+	}
+
+	gl_unmap(&m);
+	return g;
+}
+
+/* Incarca un fisier binar sau text, dupa primii octeti */
+csr_graph_t *
+gl_load(const char *path, int flags, thread_pool_t *tp)
+{
+	char magic[8] = { 0 };
+	int fd = open(path, O_RDONLY);
+	DIE(fd < 0, "open() failed\n");
+
+	ssize_t n = read(fd, magic, sizeof(magic));
+	close(fd);
+
+	if (n == sizeof(magic) && !memcmp(magic, GL_MAGIC, 8))
+		return gl_load_binary(path, flags);
+	return gl_load_text(path, flags, tp);
+}
+
+static void
+write_full(int fd, const void *buf, size_t len)
+{
+	const char *p = buf;
+
+	while (len) {
+		ssize_t n = write(fd, p, len);
+		if (n < 0 && errno == EINTR)
+			continue;
+		DIE(n < 0, "write() failed\n");
+		p += n;
+		len -= n;
+	}
+}
+
+/* Creeaza fisierul binar si scrie antetul; intoarce descriptorul */
+static int
+create_binary(const char *path, int nodes, int weighted, long edges)
+{
+	gl_header_t h = { .nodes = nodes, .weighted = weighted, .edges = edges };
+	memcpy(h.magic, GL_MAGIC, 8);
+
+	int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	DIE(fd < 0, "open() failed\n");
+	write_full(fd, &h, sizeof(h));
+
+	return fd;
+}
+
+/*
+ * Salveaza muchiile lui g in formatul binar, in ordinea din CSR: grupate
+ * dupa sursa, nu in ordinea in care au fost citite. Pentru a pastra ordinea
+ * dintr-un fisier text se foloseste gl_convert_text.
+ */
+void
+gl_save_binary(const csr_graph_t *g, const char *path)
+{
+	int fd = create_binary(path, g->nodes, g->weights != NULL, g->edges);
+
+	/* Sursele nu sunt memorate in CSR: se reconstruiesc din offsets */
+	int *buf = malloc(GL_WRITE_EDGES * sizeof(int));
+	DIE(!buf, "malloc() failed\n");
+
+	long k = 0;
+	for (int u = 0; u < g->nodes; u++) {
+		for (long e = g->offsets[u]; e < g->offsets[u + 1]; e++) {
+			buf[k++] = u;
+			if (k == GL_WRITE_EDGES) {
+				write_full(fd, buf, k * sizeof(int));
+				k = 0;
+			}
+		}
+	}
+	write_full(fd, buf, k * sizeof(int));
+	free(buf);
+
+	write_full(fd, g->targets, g->edges * sizeof(int));
+	if (g->weights)
+		write_full(fd, g->weights, g->edges * sizeof(int));
+
+	close(fd);
+}
+
+/*
+ * Converteste un fisier text in formatul binar fara sa construiasca CSR-ul:
+ * muchiile raman in ordinea din fisier, deci gl_load da acelasi graf (cu
+ * aceeasi ordine a vecinilor) din ambele fisiere. GL_UNDIRECTED este
+ * ignorat: fiecare muchie se scrie o singura data, iar sensul invers se
+ * adauga la incarcare.
+ */
+void
+gl_convert_text(const char *text_path, const char *bin_path, int flags,
+				thread_pool_t *tp)
+{
+	gl_parse_t s;
+	int nodes;
+	long edges = parse_text(text_path, flags & ~GL_UNDIRECTED, tp, &s, &nodes);
+
+	int fd = create_binary(bin_path, nodes, s.weights != NULL, edges);
+	write_full(fd, s.src, edges * sizeof(int));
+	write_full(fd, s.dst, edges * sizeof(int));
+	if (s.weights)
+		write_full(fd, s.weights, edges * sizeof(int));
+	close(fd);
+
+	free(s.src);
+	free(s.dst);
+	free(s.weights);
+}
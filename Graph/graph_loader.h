@@ -0,0 +1,62 @@
+#ifndef GRAPH_LOADER_H
+#define GRAPH_LOADER_H
+
+#include <stdint.h>
+
+#include "csr_graph.h"
+#include "thread_pool.h"
+
+/*
+ * Incarcarea grafurilor mari din fisiere, direct in format CSR.
+ *
+ * Text: cate o muchie pe linie, "u v" sau "u v cost", optional precedate de
+ * o linie "n m" (formatul programelor din acest director). Liniile goale si
+ * cele care incep cu '#' sau '%' sunt ignorate. Fisierul este mapat in
+ * memorie (mmap) si impartit in bucati la capete de linie; bucatile sunt
+ * parsate in paralel, cu un parser de intregi scris de mana, direct in
+ * vectorii de muchii. Nu se face nicio alocare pe muchie.
+ *
+ * Binar: un antet gl_header_t, urmat de vectorii src[edges], dst[edges] si,
+ * daca graful are costuri, weights[edges], toti int32 in ordinea octetilor
+ * masinii. Fisierul mapat este folosit direct de csr_create_from_edges, fara
+ * nicio parsare. gl_convert_text pastreaza ordinea muchiilor din fisierul
+ * text; gl_save_binary le scrie in ordinea din CSR (grupate dupa sursa), deci
+ * vecinii unui nod pot aparea in alta ordine decat in fisierul original.
+ */
+
+/* Prima linie este "n m" */
+#define GL_HEADER 1
+/* Fiecare muchie are un cost: "u v cost" */
+#define GL_WEIGHTED 2
+/* Fiecare muchie u - v este adaugata in ambele sensuri, imediat una dupa
+ * alta, ca vecinii sa apara in aceeasi ordine ca la lg_add_edge */
+#define GL_UNDIRECTED 4
+
+#define GL_MAGIC "GLEDGES1"
+
+typedef struct gl_header_t gl_header_t;
+struct gl_header_t
+{
+	char magic[8];
+	int32_t nodes;
+	int32_t weighted;
+	int64_t edges;
+};
+
+csr_graph_t *
+gl_load_text(const char *path, int flags, thread_pool_t *tp);
+
+csr_graph_t *
+gl_load_binary(const char *path, int flags);
+
+csr_graph_t *
+gl_load(const char *path, int flags, thread_pool_t *tp);
+
+void
+gl_save_binary(const csr_graph_t *g, const char *path);
+
+void
+gl_convert_text(const char *text_path, const char *bin_path, int flags,
+				thread_pool_t *tp);
+
+#endif
@@ -14,11 +14,13 @@
 		}							\
 	} while (0)
 
+#include "bit_matrix.h"
+
 #define MAX_STRING_SIZE    256
 typedef struct
 {
-    int** matrix; /* Matricea de adiacenta a grafului */
-    int nodes;    /* Numarul de noduri din graf. */
+    bit_matrix_t* matrix; /* Matricea de adiacenta, un bit pe muchie */
+    int nodes;            /* Numarul de noduri din graf. */
 } matrix_graph_t;
 
 /**
@@ -36,12 +38,7 @@ mg_create(int nodes)
     matrix_graph_t* graph = malloc(sizeof(matrix_graph_t));
     DIE(!graph, "malloc() failed\n");
 
-    graph->matrix = (int **)calloc(nodes, sizeof(int *));
-    DIE(!graph->matrix, "calloc() failed\n");
-    for (int i = 0; i < nodes; i++) {
-        graph->matrix[i] = (int *)calloc(nodes, sizeof(int));
-        DIE(!graph->matrix[i], "calloc() failed\n");
-    }
+    graph->matrix = bm_create(nodes);
 
     graph->nodes = nodes;
 
@@ -52,30 +49,28 @@ mg_create(int nodes)
 void
 mg_add_edge(matrix_graph_t* graph, int src, int dest)
 {
-    graph->matrix[src][dest] = 1;
+    bm_set(graph->matrix, src, dest);
 }
 
 /* Returneaza 1 daca exista muchie intre cele doua noduri, 0 in caz contrar */
 int
 mg_has_edge(matrix_graph_t* graph, int src, int dest)
 {
-    return graph->matrix[src][dest];
+    return bm_test(graph->matrix, src, dest);
 }
 
 /* Elimina muchia dintre nodurile sursa si destinatie */
 void
 mg_remove_edge(matrix_graph_t* graph, int src, int dest)
 {
-    graph->matrix[src][dest] = 0;
+    bm_clear(graph->matrix, src, dest);
 }
 
 /* Elibereaza memoria folosita de matricea de adiacenta a grafului */
 void
 mg_free(matrix_graph_t* graph)
 {
-    for (int i = 0; i < graph->nodes; i++)
-        free(graph->matrix[i]);
-    free(graph->matrix);
+    bm_free(graph->matrix);
     free(graph);
 }
 
@@ -84,11 +79,32 @@ print_matrix_graph(matrix_graph_t* mg)
 {
     for (int i = 0; i < mg->nodes; i++) {
         for (int j = 0; j < mg->nodes; j++)
-            printf("%d ", mg->matrix[i][j]);
+            printf("%d ", mg_has_edge(mg, i, j));
         printf("\n");
     }
 }
 
+/* Gradul exterior al nodului: numarul de biti setati din linia lui */
+int
+mg_degree(matrix_graph_t* mg, int node)
+{
+    return bm_degree(mg->matrix, node);
+}
+
+/*
+ * Printeaza inchiderea tranzitiva: 1 pe pozitia (i, j) daca exista un drum
+ * de la i la j. Graful nu este modificat.
+ */
+void
+print_transitive_closure(matrix_graph_t* mg)
+{
+    bit_matrix_t *closure = bm_clone(mg->matrix);
+
+    bm_transitive_closure(closure);
+    bm_print(closure);
+    bm_free(closure);
+}
+
 int main()
 {
     
@@ -152,6 +168,25 @@ int main()
             }
         }
         
+        if (strncmp(command, "degree", 6) == 0) {
+            if (mg != NULL) {
+                scanf("%d", &nr1);
+                printf("%d\n", mg_degree(mg, nr1));
+            } else {
+                printf("Create a graph first!\n");
+                exit(0);
+            }
+        }
+
+        if (strncmp(command, "closure", 7) == 0) {
+            if (mg != NULL) {
+                print_transitive_closure(mg);
+            } else {
+                printf("Create a graph first!\n");
+                exit(0);
+            }
+        }
+
         if (strncmp(command, "free", 4) == 0) {
             if (mg != NULL) {
                 mg_free(mg);
@@ -5,6 +5,7 @@
 #include <errno.h>
 
 #define MIN(x, y) ((x) < (y) ? (x) : (y))
+#define MAX(x, y) ((x) > (y) ? (x) : (y))
 
 #define DIE(assertion, call_description)            \
     do                                              \
@@ -20,6 +21,10 @@
 
 #define MAX_QUEUE_SIZE 100
 
+#include "dijkstra.h"
+#include "p2p_search.h"
+#include "graph_loader.h"
+
 typedef struct ll_node_t ll_node_t;
 typedef struct linked_list_t linked_list_t;
 typedef struct queue_t queue_t;
@@ -53,6 +58,18 @@ struct list_graph_t
 {
 	linked_list_t** neighbors;
 	int nodes;
+	int weighted;       /* 1 pentru lg_create_weighted: listele tin wedge_t */
+};
+
+/*
+ * Muchie cu cost, pentru grafurile create cu lg_create_weighted. node este
+ * primul camp, deci *(int *)data da vecinul ca la listele simple.
+ */
+typedef struct wedge_t wedge_t;
+struct wedge_t
+{
+	int node;
+	int cost;
 };
 
 linked_list_t* ll_create(unsigned int data_size);
@@ -74,7 +91,9 @@ void q_clear(queue_t* q);
 void q_free(queue_t* q);
 
 list_graph_t* lg_create(int nodes);
+list_graph_t* lg_create_weighted(int nodes);
 void lg_add_edge(list_graph_t* graph, int src, int dest);
+void lg_add_weighted_edge(list_graph_t* graph, int src, int dest, int cost);
 static ll_node_t *find_node(linked_list_t *ll, int node, unsigned int *pos);
 int lg_has_edge(list_graph_t* graph, int src, int dest);
 linked_list_t* lg_get_neighbours(list_graph_t* graph, int node);
@@ -101,68 +120,280 @@ void print_min_path(list_graph_t *graph, int src, int dest)
 {
     queue_t *q = q_create(sizeof(int), graph->nodes);
 
-    int *visited = calloc(graph->nodes, sizeof(int));
-    DIE(!visited, "calloc() failed\n");
-	visited[src] = 1;
+    /* parent[x] = nodul din care a fost descoperit x, -1 daca nu a fost atins */
+    int *parent = malloc(graph->nodes * sizeof(int));
+    int *path = malloc(graph->nodes * sizeof(int));
+    DIE(!parent || !path, "malloc() failed\n");
+
+    for (int i = 0; i < graph->nodes; i++)
+        parent[i] = -1;
+    parent[src] = src;
 
 	q_enqueue(q, &src);
-    int ok = 0, nr = 0;
-    int path[graph->nodes];
 
-	while (!q_is_empty(q)) {
+	while (!q_is_empty(q) && parent[dest] < 0) {
 		int x = *(int*)(q_front(q));
 		q_dequeue(q);
-        path[nr++] = x;
-
-		ll_node_t *aux = graph->neighbors[x]->head;
-		while (aux) {
-            if (*(int*)(aux->data) == dest) {
-                path[nr++] = dest;
-                ok = 1;
-                break;
-            }
-
-			if (!visited[*(int *)aux->data]) {
-				visited[*(int *)aux->data] = 1;
-				q_enqueue(q, aux->data);
+
+		for (ll_node_t *aux = graph->neighbors[x]->head; aux; aux = aux->next) {
+			int y = *(int *)aux->data;
+
+			if (parent[y] < 0) {
+				parent[y] = x;
+				q_enqueue(q, &y);
 			}
-			aux = aux->next;
 		}
-
-        if (ok)
-            break;
 	}
 
-    for (int i = 0; i < nr && ok; i++) {
-        printf("%d ", path[i]);
+    if (parent[dest] < 0) {
+        printf("No path found");
+    } else {
+        /* Drumul se reconstruieste de la dest spre src, apoi se afiseaza invers */
+        int nr = 0;
+        for (int x = dest; x != src; x = parent[x])
+            path[nr++] = x;
+        path[nr++] = src;
+
+        for (int i = nr - 1; i >= 0; i--)
+            printf("%d ", path[i]);
     }
 
-    if (!ok)
-        printf("No path found");
-    
 	printf("\n");
 	q_free(q);
-    free(visited);
+    free(parent);
+    free(path);
 }
 
-int main()
+/*
+ * Dijkstra pe listele de adiacenta ale unui graf creat cu lg_create_weighted.
+ * Pentru dest >= 0 se opreste cand dest are distanta finala, pentru dest < 0
+ * calculeaza drumurile minime spre toate nodurile.
+ */
+sp_result_t *dijkstra_list_graph(list_graph_t *graph, int src, int dest)
 {
-    int n, m, src, dest;
+    sp_result_t *r = sp_result_create(graph->nodes, src);
+    dheap_t *h = dheap_create(graph->nodes);
+    long long d;
+
+    dheap_push(h, src, 0);
+
+    while (!dheap_is_empty(h)) {
+        int x = dheap_pop(h, &d);
+
+        if (x == dest)
+            break;
+
+        for (ll_node_t *aux = graph->neighbors[x]->head; aux; aux = aux->next) {
+            wedge_t *e = aux->data;
+
+            DIE(e->cost < 0, "negative edge cost\n");
+            if (d + e->cost >= r->dist[e->node])
+                continue;
+
+            r->dist[e->node] = d + e->cost;
+            r->pred[e->node] = x;
+            if (dheap_contains(h, e->node))
+                dheap_decrease_key(h, e->node, d + e->cost);
+            else
+                dheap_push(h, e->node, d + e->cost);
+        }
+    }
+
+    dheap_free(h);
+    return r;
+}
+
+/*
+ * Graful CSR corespunzator listelor de adiacenta; are costuri daca graful a
+ * fost creat cu lg_create_weighted.
+ */
+csr_graph_t *lg_to_csr(list_graph_t *graph)
+{
+    int weighted = graph->weighted;
+    csr_builder_t *b = csr_builder_create(graph->nodes, weighted);
+
+    for (int i = 0; i < graph->nodes; i++)
+        for (ll_node_t *aux = graph->neighbors[i]->head; aux; aux = aux->next) {
+            wedge_t *e = aux->data;
+            csr_builder_add(b, i, e->node, weighted ? e->cost : 0);
+        }
+
+    return csr_builder_finish(b);
+}
+
+/*
+ * Estimare ALT (A*, landmark, inegalitatea triunghiului) cu un singur nod
+ * reper L: d(v, dest) >= d(L, dest) - d(L, v) si d(v, dest) >= d(v, L) -
+ * d(dest, L). Estimarea este consistenta, deci A* nu redeschide noduri.
+ */
+typedef struct landmark_t landmark_t;
+struct landmark_t
+{
+    sp_result_t *from;      /* from->dist[v] = d(L, v) */
+    sp_result_t *to;        /* to->dist[v] = d(v, L), pe graful transpus */
+};
+
+long long landmark_heuristic(void *arg, int node, int dest)
+{
+    landmark_t *lm = arg;
+    long long h = 0;
+
+    if (lm->from->dist[dest] != SP_INF && lm->from->dist[node] != SP_INF)
+        h = MAX(h, lm->from->dist[dest] - lm->from->dist[node]);
+    if (lm->to->dist[node] != SP_INF && lm->to->dist[dest] != SP_INF)
+        h = MAX(h, lm->to->dist[node] - lm->to->dist[dest]);
+
+    return h;
+}
+
+/*
+ * Interogare punct-la-punct cu p2p_search: mode este "bidir_bfs", "bidir"
+ * sau "astar". Afiseaza drumul si costul ca print_sp_result, iar
+ * statisticile interogarii la stderr.
+ */
+void print_p2p_query(list_graph_t *graph, const char *mode, int src, int dest)
+{
+    csr_graph_t *g = lg_to_csr(graph);
+    csr_graph_t *gt = csr_transpose(g);
+    p2p_search_t *p = p2p_create(g, gt);
+    int *path = malloc(g->nodes * sizeof(int));
+    DIE(!path, "malloc() failed\n");
+    sp_stats_t stats;
+    long long cost;
+    int len;
+
+    if (strcmp(mode, "bidir_bfs") == 0) {
+        cost = p2p_bidir_bfs(p, src, dest, path, &len, &stats);
+    } else if (strcmp(mode, "bidir") == 0) {
+        cost = p2p_bidir_dijkstra(p, src, dest, path, &len, &stats);
+    } else {
+        /* Reperul este nodul 0 */
+        landmark_t lm = {
+            .from = dijkstra_csr(g, 0, -1),
+            .to = dijkstra_csr(gt, 0, -1),
+        };
+        cost = p2p_astar(p, src, dest, landmark_heuristic, &lm, path, &len,
+                         &stats);
+        sp_result_free(lm.from);
+        sp_result_free(lm.to);
+    }
+
+    if (cost == SP_INF) {
+        printf("No path found\n");
+    } else {
+        for (int i = 0; i < len; i++)
+            printf("%d ", path[i]);
+        printf("\n%lld\n", cost);
+    }
+    fprintf(stderr, "settled %ld, relaxed %ld, %.3f ms\n", stats.settled,
+            stats.relaxed, stats.time_ms);
+
+    free(path);
+    p2p_free(p);
+    csr_free(gt);
+    csr_free(g);
+}
+
+/*
+ * Afiseaza drumul minim src -> dest pe o linie si costul lui pe urmatoarea.
+ * Pentru dest < 0 afiseaza, pentru fiecare nod, "nod: cost" (sau "nod: -"
+ * daca nu este accesibil).
+ */
+void print_sp_result(sp_result_t *r, int dest)
+{
+    if (dest < 0) {
+        for (int i = 0; i < r->nodes; i++) {
+            if (r->dist[i] == SP_INF)
+                printf("%d: -\n", i);
+            else
+                printf("%d: %lld\n", i, r->dist[i]);
+        }
+        return;
+    }
+
+    int *path = malloc(r->nodes * sizeof(int));
+    DIE(!path, "malloc() failed\n");
+
+    int len = sp_path(r, dest, path);
+    if (!len) {
+        printf("No path found\n");
+    } else {
+        for (int i = 0; i < len; i++)
+            printf("%d ", path[i]);
+        printf("\n%lld\n", r->dist[dest]);
+    }
+
+    free(path);
+}
+
+/*
+ * Fara argumente: graf orientat cu muchii "src dest" si drum minim cu BFS;
+ * "bidir_bfs" foloseste aceeasi intrare, cu BFS bidirectional.
+ * Cu argumentul "dijkstra" (liste de adiacenta), "dijkstra_csr", "bidir"
+ * (Dijkstra bidirectional) sau "astar" muchiile sunt "src dest cost". Pentru
+ * dijkstra si dest = -1 se afiseaza drumurile minime spre toate nodurile.
+ * "file <cale> src dest" incarca graful cu costuri cu gl_load (prima linie
+ * "n m", apoi muchiile "src dest cost", sau formatul binar) si ruleaza
+ * dijkstra_csr.
+ */
+int main(int argc, char *argv[])
+{
+    int n, m, src, dest, cost;
     list_graph_t *graph;
+    const char *mode = argc > 1 ? argv[1] : "bfs";
+    int weighted = strncmp(mode, "dijkstra", 8) == 0 || strcmp(mode, "bidir") == 0 ||
+                   strcmp(mode, "astar") == 0;
+
+    if (strcmp(mode, "file") == 0) {
+        DIE(argc < 5, "usage: minpath file <path> <src> <dest>\n");
+        thread_pool_t *tp = tp_create(0);
+        csr_graph_t *g = gl_load(argv[2], GL_HEADER | GL_WEIGHTED, tp);
+        src = atoi(argv[3]);
+        dest = atoi(argv[4]);
+        DIE(src < 0 || src >= g->nodes || dest >= g->nodes, "node out of range\n");
+
+        sp_result_t *r = dijkstra_csr(g, src, dest);
+        print_sp_result(r, dest);
+
+        sp_result_free(r);
+        csr_free(g);
+        tp_free(tp);
+        return 0;
+    }
 
     scanf("%d%d", &n, &m);
-    graph = lg_create(n);
+    graph = weighted ? lg_create_weighted(n) : lg_create(n);
 
     // Read graph edges
     for (int i = 0; i < m; ++i) {
-        scanf("%d%d", &src, &dest);
-        lg_add_edge(graph, src, dest);
+        if (weighted) {
+            scanf("%d%d%d", &src, &dest, &cost);
+            lg_add_weighted_edge(graph, src, dest, cost);
+        } else {
+            scanf("%d%d", &src, &dest);
+            lg_add_edge(graph, src, dest);
+        }
     }
 
     // Read src & dest for min path
     scanf("%d%d", &src, &dest);
 
-    print_min_path(graph, src, dest);
+    if (strcmp(mode, "bidir_bfs") == 0 || strcmp(mode, "bidir") == 0 ||
+        strcmp(mode, "astar") == 0) {
+        print_p2p_query(graph, mode, src, dest);
+    } else if (!weighted) {
+        print_min_path(graph, src, dest);
+    } else if (strcmp(mode, "dijkstra_csr") == 0) {
+        csr_graph_t *g = lg_to_csr(graph);
+        sp_result_t *r = dijkstra_csr(g, src, dest);
+        print_sp_result(r, dest);
+        sp_result_free(r);
+        csr_free(g);
+    } else {
+        sp_result_t *r = dijkstra_list_graph(graph, src, dest);
+        print_sp_result(r, dest);
+        sp_result_free(r);
+    }
 
     lg_free(graph);
     return 0;
@@ -411,10 +642,35 @@ lg_create(int nodes)
         g->neighbors[i] = ll_create(sizeof(int));
 
     g->nodes = nodes;
+    g->weighted = 0;
+
+    return g;
+}
+
+/* Ca lg_create, dar listele retin muchii wedge_t (vecin si cost) */
+list_graph_t *
+lg_create_weighted(int nodes)
+{
+    list_graph_t *g = lg_create(nodes);
+
+    for (int i = 0; i != nodes; ++i)
+        g->neighbors[i]->data_size = sizeof(wedge_t);
+    g->weighted = 1;
 
     return g;
 }
 
+void lg_add_weighted_edge(list_graph_t *graph, int src, int dest, int cost)
+{
+    wedge_t e = { .node = dest, .cost = cost };
+
+    if (
+        !graph || !graph->neighbors || !is_node_in_graph(src, graph->nodes) || !is_node_in_graph(dest, graph->nodes))
+        return;
+
+    ll_add_nth_node(graph->neighbors[src], graph->neighbors[src]->size, &e);
+}
+
 void lg_add_edge(list_graph_t *graph, int src, int dest)
 {
     if (
@@ -0,0 +1,364 @@
+#include <unistd.h>
+
+#include "named_graph.h"
+
+#define NB_READ_SIZE (1 << 20)
+/* Cate nume se cauta deodata in nb_load_text */
+#define NB_BATCH 64
+
+/*
+ * Hash pe 32 de biti; numele este citit cate 8 octeti deodata, iar fiecare
+ * cuvant este amestecat cu o inmultire si un xorshift.
+ */
+static inline uint32_t
+hash_name(const char *s, int len)
+{
+	uint64_t h = 0x9e3779b97f4a7c15ULL ^ (uint64_t)len;
+	uint64_t w;
+
+	for (; len >= 8; s += 8, len -= 8) {
+		memcpy(&w, s, 8);
+		h = (h ^ w) * 0xff51afd7ed558ccdULL;
+		h ^= h >> 32;
+	}
+
+	w = 0;
+	memcpy(&w, s, len);
+	h = (h ^ w) * 0xff51afd7ed558ccdULL;
+	h ^= h >> 29;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 32;
+
+	return (uint32_t)h;
+}
+
+static nt_slot_t *
+alloc_slots(long count)
+{
+	nt_slot_t *slots = malloc(count * sizeof(nt_slot_t));
+	DIE(!slots, "malloc() failed\n");
+
+	for (long i = 0; i < count; i++)
+		slots[i].id = -1;
+
+	return slots;
+}
+
+/* expected = cate nume se asteapta (doar pentru dimensionarea initiala) */
+name_table_t *
+nt_create(int expected)
+{
+	name_table_t *nt = malloc(sizeof(*nt));
+	DIE(!nt, "malloc() failed\n");
+
+	long slots = 16;
+	while (slots < 2L * expected)
+		slots *= 2;
+
+	nt->count = 0;
+	nt->capacity = expected > 16 ? expected : 16;
+	nt->arena_size = 0;
+	nt->arena_capacity = 16L * nt->capacity;
+	nt->arena = malloc(nt->arena_capacity);
+	nt->offsets = malloc((nt->capacity + 1L) * sizeof(long));
+	DIE(!nt->arena || !nt->offsets, "malloc() failed\n");
+
+	nt->slots = alloc_slots(slots);
+	nt->mask = slots - 1;
+	nt->offsets[0] = 0;
+
+	return nt;
+}
+
+/* Dubleaza tabela; sloturile sunt mutate dupa hash-urile retinute in ele */
+static void
+nt_grow_slots(name_table_t *nt)
+{
+	long old = nt->mask + 1;
+	nt_slot_t *slots = alloc_slots(2 * old);
+
+	nt->mask = 2 * old - 1;
+	for (long j = 0; j < old; j++) {
+		if (nt->slots[j].id < 0)
+			continue;
+
+		long i = nt->slots[j].hash & nt->mask;
+		while (slots[i].id >= 0)
+			i = (i + 1) & nt->mask;
+		slots[i] = nt->slots[j];
+	}
+
+	free(nt->slots);
+	nt->slots = slots;
+}
+
+/* Slotul in care este (sau ar trebui inserat) numele cu hash-ul h */
+static inline long
+nt_probe(const name_table_t *nt, const char *name, int len, uint32_t h)
+{
+	long i = h & nt->mask;
+
+	for (;; i = (i + 1) & nt->mask) {
+		const nt_slot_t *sl = &nt->slots[i];
+
+		if (sl->id < 0)
+			return i;
+		if (sl->hash == h && memcmp(nt->arena + sl->offset, name, len) == 0
+			&& nt->arena[sl->offset + len] == '\0')
+			return i;
+	}
+}
+
+/* Id-ul numelui name (len octeti, nu neaparat terminat cu '\0'), -1 daca nu
+ * exista */
+int
+nt_find(const name_table_t *nt, const char *name, int len)
+{
+	return nt->slots[nt_probe(nt, name, len, hash_name(name, len))].id;
+}
+
+static int
+nt_intern_hashed(name_table_t *nt, const char *name, int len, uint32_t h)
+{
+	long slot = nt_probe(nt, name, len, h);
+
+	if (nt->slots[slot].id >= 0)
+		return nt->slots[slot].id;
+
+	if (nt->count == nt->capacity) {
+		nt->capacity *= 2;
+		nt->offsets = realloc(nt->offsets, (nt->capacity + 1L) * sizeof(long));
+		DIE(!nt->offsets, "realloc() failed\n");
+	}
+	if (nt->arena_size + len + 1 > nt->arena_capacity) {
+		while (nt->arena_size + len + 1 > nt->arena_capacity)
+			nt->arena_capacity *= 2;
+		nt->arena = realloc(nt->arena, nt->arena_capacity);
+		DIE(!nt->arena, "realloc() failed\n");
+	}
+
+	int id = nt->count++;
+
+	memcpy(nt->arena + nt->arena_size, name, len);
+	nt->arena[nt->arena_size + len] = '\0';
+	nt->arena_size += len + 1;
+	nt->offsets[id + 1] = nt->arena_size;
+	nt->slots[slot].hash = h;
+	nt->slots[slot].id = id;
+	nt->slots[slot].offset = nt->offsets[id];
+
+	/* Factor de incarcare de cel mult 1/2 */
+	if (2L * nt->count > nt->mask + 1)
+		nt_grow_slots(nt);
+
+	return id;
+}
+
+/* Id-ul numelui name; daca nu exista, primeste urmatorul id liber */
+int
+nt_intern(name_table_t *nt, const char *name, int len)
+{
+	return nt_intern_hashed(nt, name, len, hash_name(name, len));
+}
+
+void
+nt_free(name_table_t *nt)
+{
+	if (!nt)
+		return;
+
+	free(nt->arena);
+	free(nt->offsets);
+	free(nt->slots);
+	free(nt);
+}
+
+/* --- Graf cu noduri cu nume --- */
+
+named_builder_t *
+nb_create(void)
+{
+	named_builder_t *b = malloc(sizeof(*b));
+	DIE(!b, "malloc() failed\n");
+
+	b->names = nt_create(0);
+	/* Numarul de noduri se completeaza in nb_finish */
+	b->edges = csr_builder_create(0, 0);
+
+	return b;
+}
+
+void
+nb_add_edge(named_builder_t *b, const char *src, int src_len, const char *dst,
+			int dst_len)
+{
+	int u = nt_intern(b->names, src, src_len);
+	int v = nt_intern(b->names, dst, dst_len);
+
+	csr_builder_add(b->edges, u, v, 0);
+}
+
+/*
+ * Construieste graful si elibereaza builder-ul. Tabela de nume trece la
+ * apelant prin *names.
+ */
+csr_graph_t *
+nb_finish(named_builder_t *b, name_table_t **names)
+{
+	b->edges->nodes = b->names->count;
+	csr_graph_t *g = csr_builder_finish(b->edges);
+
+	*names = b->names;
+	free(b);
+
+	return g;
+}
+
+/* Separatori: spatiu, '\n', '\t', '\r' si orice alt caracter de control */
+static inline int
+is_space(char c)
+{
+	return (unsigned char)c <= ' ';
+}
+
+/*
+ * Sfarsitul cuvantului care incepe la i: primul separator dupa i, sau have.
+ * Se verifica 8 octeti deodata (little-endian: primul octet din buffer este
+ * cel mai putin semnificativ): un octet b <= ' ' (fara bitul 7 setat) face
+ * ca b - 0x21 sa imprumute si sa seteze bitul 7. Imprumutul se poate
+ * propaga doar spre octetii de dupa primul separator, deci primul bit gasit
+ * este corect. Bufferul trebuie sa aiba 8 octeti in plus dupa have.
+ */
+static inline long
+token_end(const char *buf, long i, long have)
+{
+	const uint64_t ones = 0x0101010101010101ULL;
+	const uint64_t high = 0x8080808080808080ULL;
+
+	for (; i < have; i += 8) {
+		uint64_t w;
+		memcpy(&w, buf + i, 8);
+
+		uint64_t hit = (w - 0x21 * ones) & ~w & high;
+		if (hit) {
+			i += __builtin_ctzll(hit) >> 3;
+			break;
+		}
+	}
+
+	return i < have ? i : have;
+}
+
+/* Nume citite, inca necautate in tabela */
+typedef struct nb_batch_t nb_batch_t;
+struct nb_batch_t
+{
+	int count;
+	long start[NB_BATCH];
+	int len[NB_BATCH];
+	uint32_t hash[NB_BATCH];
+};
+
+/*
+ * Cauta numele din batch si adauga muchiile. Fiecare cautare atinge
+ * aleator trei zone mari de memorie (slotul, offsets[id], arena), deci
+ * fiecare nivel este cerut din memorie pentru tot batch-ul inainte sa fie
+ * folosit, ca miss-urile de cache sa se suprapuna in loc sa se astepte unul
+ * pe altul.
+ */
+static void
+nb_flush(named_builder_t *b, const char *buf, nb_batch_t *batch, int *src)
+{
+	name_table_t *nt = b->names;
+	int k;
+
+	for (k = 0; k < batch->count; k++)
+		__builtin_prefetch(&nt->slots[batch->hash[k] & nt->mask]);
+	for (k = 0; k < batch->count; k++) {
+		const nt_slot_t *sl = &nt->slots[batch->hash[k] & nt->mask];
+		if (sl->id >= 0 && sl->hash == batch->hash[k])
+			__builtin_prefetch(nt->arena + sl->offset);
+	}
+
+	for (k = 0; k < batch->count; k++) {
+		int id = nt_intern_hashed(nt, buf + batch->start[k], batch->len[k],
+								  batch->hash[k]);
+		if (*src < 0) {
+			*src = id;
+		} else {
+			csr_builder_add(b->edges, *src, id, 0);
+			*src = -1;
+		}
+	}
+
+	batch->count = 0;
+}
+
+/*
+ * Citeste din fd muchii "sursa destinatie", nume separate prin spatii sau
+ * linii noi (formatul din top_sort.c; cu skip_header primele doua cuvinte,
+ * "n m", sunt ignorate). Datele se citesc in bucati mari, iar numele sunt
+ * interne direct din buffer, fara copii intermediare, cate NB_BATCH
+ * deodata. Un nume rupt intre doua citiri este mutat la inceputul
+ * bufferului.
+ */
+csr_graph_t *
+nb_load_text(int fd, int skip_header, name_table_t **names)
+{
+	named_builder_t *b = nb_create();
+	long size = NB_READ_SIZE;
+	char *buf = malloc(size + 8);
+	nb_batch_t *batch = malloc(sizeof(*batch));
+	DIE(!buf || !batch, "malloc() failed\n");
+
+	long have = 0, tokens = 0;
+	int src = -1, eof = 0;
+
+	batch->count = 0;
+	while (!eof) {
+		ssize_t n = read(fd, buf + have, size - have);
+		if (n < 0 && errno == EINTR)
+			continue;
+		DIE(n < 0, "read() failed\n");
+		eof = n == 0;
+		have += n;
+
+		long i = 0, start;
+		for (;;) {
+			while (i < have && is_space(buf[i]))
+				i++;
+			start = i;
+			i = token_end(buf, i, have);
+			/* Cuvantul poate continua in citirea urmatoare */
+			if (i == start || (i == have && !eof))
+				break;
+
+			if (tokens++ < 2 * !!skip_header)
+				continue;
+
+			int k = batch->count++;
+			batch->start[k] = start;
+			batch->len[k] = (int)(i - start);
+			batch->hash[k] = hash_name(buf + start, batch->len[k]);
+			if (batch->count == NB_BATCH)
+				nb_flush(b, buf, batch, &src);
+		}
+
+		/* Numele din batch trebuie cautate inainte sa fie mutat bufferul */
+		nb_flush(b, buf, batch, &src);
+
+		/* Pastreaza cuvantul neterminat; un cuvant cat tot bufferul il
+		 * face sa creasca */
+		have -= start;
+		memmove(buf, buf + start, have);
+		if (have == size) {
+			size *= 2;
+			buf = realloc(buf, size + 8);
+			DIE(!buf, "realloc() failed\n");
+		}
+	}
+
+	free(batch);
+	free(buf);
+	return nb_finish(b, names);
+}
@@ -0,0 +1,93 @@
+#ifndef NAMED_GRAPH_H
+#define NAMED_GRAPH_H
+
+#include <stdint.h>
+
+#include "csr_graph.h"
+
+/*
+ * Noduri identificate prin nume (string-uri), numerotate dens 0, 1, 2, ...
+ * in ordinea primei aparitii.
+ *
+ * Toate numele stau unul dupa altul intr-o singura zona de memorie (arena),
+ * terminate cu '\0'; numele nodului id incepe la arena + offsets[id], deci
+ * id -> nume este O(1), fara nicio alocare pe nume. Nume -> id se cauta
+ * intr-o singura tabela cu adresare deschisa (sondare liniara). Un slot
+ * tine id-ul, hash-ul si pozitia in arena a numelui: la cautare numele este
+ * citit doar cand hash-urile sunt egale si direct din arena (fara sa treaca
+ * prin offsets), iar la redimensionare nu este citit deloc.
+ *
+ * Numele nu pot contine '\0'.
+ */
+typedef struct nt_slot_t nt_slot_t;
+struct nt_slot_t
+{
+	uint32_t hash;
+	int id;             /* -1 = slot liber */
+	long offset;        /* offsets[id], ca numele sa fie gasit direct */
+};
+
+typedef struct name_table_t name_table_t;
+struct name_table_t
+{
+	int count;
+	int capacity;       /* Loc pentru atatea nume in offsets */
+	char *arena;
+	long arena_size;
+	long arena_capacity;
+	long *offsets;      /* capacity + 1 elemente */
+	nt_slot_t *slots;   /* Numarul de sloturi este o putere a lui 2 */
+	long mask;
+};
+
+/*
+ * Construieste un graf CSR din muchii intre noduri cu nume. Numarul de
+ * noduri se afla abia la sfarsit.
+ */
+typedef struct named_builder_t named_builder_t;
+struct named_builder_t
+{
+	name_table_t *names;
+	csr_builder_t *edges;
+};
+
+name_table_t *
+nt_create(int expected);
+
+int
+nt_intern(name_table_t *nt, const char *name, int len);
+
+int
+nt_find(const name_table_t *nt, const char *name, int len);
+
+void
+nt_free(name_table_t *nt);
+
+named_builder_t *
+nb_create(void);
+
+void
+nb_add_edge(named_builder_t *b, const char *src, int src_len, const char *dst,
+			int dst_len);
+
+csr_graph_t *
+nb_finish(named_builder_t *b, name_table_t **names);
+
+csr_graph_t *
+nb_load_text(int fd, int skip_header, name_table_t **names);
+
+/* Numele nodului id, terminat cu '\0' */
+static inline const char *
+nt_name(const name_table_t *nt, int id)
+{
+	return nt->arena + nt->offsets[id];
+}
+
+/* Lungimea numelui nodului id */
+static inline int
+nt_name_len(const name_table_t *nt, int id)
+{
+	return (int)(nt->offsets[id + 1] - nt->offsets[id] - 1);
+}
+
+#endif
@@ -0,0 +1,357 @@
+#include <time.h>
+
+#include "p2p_search.h"
+
+static void
+side_init(p2p_side_t *s, int nodes)
+{
+	s->dist = malloc(nodes * sizeof(*s->dist));
+	s->pred = malloc(nodes * sizeof(*s->pred));
+	s->touched = malloc(nodes * sizeof(*s->touched));
+	s->queue = malloc(nodes * sizeof(*s->queue));
+	DIE(!s->dist || !s->pred || !s->touched || !s->queue, "malloc() failed\n");
+
+	for (int i = 0; i < nodes; i++) {
+		s->dist[i] = SP_INF;
+		s->pred[i] = -1;
+	}
+	s->touched_size = 0;
+	s->heap = dheap_create(nodes);
+}
+
+/* Sterge urmele interogarii anterioare si porneste din nodul start */
+static void
+side_reset(p2p_side_t *s, int start)
+{
+	for (int i = 0; i < s->touched_size; i++) {
+		s->dist[s->touched[i]] = SP_INF;
+		s->pred[s->touched[i]] = -1;
+	}
+	s->touched_size = 0;
+	dheap_clear(s->heap);
+
+	s->dist[start] = 0;
+	s->touched[s->touched_size++] = start;
+}
+
+/* Seteaza dist[v] si pred[v], tinand evidenta nodurilor atinse */
+static inline void
+side_set(p2p_side_t *s, int v, long long d, int pred)
+{
+	if (s->dist[v] == SP_INF)
+		s->touched[s->touched_size++] = v;
+	s->dist[v] = d;
+	s->pred[v] = pred;
+}
+
+static void
+side_free(p2p_side_t *s)
+{
+	free(s->dist);
+	free(s->pred);
+	free(s->touched);
+	free(s->queue);
+	dheap_free(s->heap);
+}
+
+/*
+ * gt trebuie sa fie transpusul lui g (csr_graph.h: csr_transpose) si este
+ * folosit doar de cautarile bidirectionale; poate fi NULL daca se foloseste
+ * doar A* sau daca graful este neorientat.
+ */
+p2p_search_t *
+p2p_create(const csr_graph_t *g, const csr_graph_t *gt)
+{
+	p2p_search_t *p = malloc(sizeof(*p));
+	DIE(!p, "malloc() failed\n");
+
+	p->g = g;
+	p->gt = gt ? gt : g;
+	side_init(&p->fwd, g->nodes);
+	side_init(&p->bwd, g->nodes);
+
+	return p;
+}
+
+void
+p2p_free(p2p_search_t *p)
+{
+	if (!p)
+		return;
+
+	side_free(&p->fwd);
+	side_free(&p->bwd);
+	free(p);
+}
+
+static double
+now_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+/*
+ * Scrie drumul src -> meet (din pred-urile cautarii inainte), apoi
+ * meet -> dest (din pred-urile cautarii inapoi, care duc spre dest).
+ */
+static int
+build_path(p2p_search_t *p, int meet, int *path)
+{
+	int len = 0;
+
+	for (int v = meet; v != -1; v = p->fwd.pred[v])
+		path[len++] = v;
+
+	for (int i = 0, j = len - 1; i < j; i++, j--) {
+		int tmp = path[i];
+		path[i] = path[j];
+		path[j] = tmp;
+	}
+
+	for (int v = p->bwd.pred[meet]; v != -1; v = p->bwd.pred[v])
+		path[len++] = v;
+
+	return len;
+}
+
+static void
+finish_query(p2p_search_t *p, long long cost, int meet, int *path,
+			 int *path_len, sp_stats_t *stats, double start)
+{
+	int len = 0;
+
+	if (cost != SP_INF && path)
+		len = build_path(p, meet, path);
+	if (path_len)
+		*path_len = len;
+	if (stats)
+		stats->time_ms = now_ms() - start;
+}
+
+/*
+ * Extinde cu un nivel frontiera BFS a lui s (coada intre *head si *tail) pe
+ * graful g. Cand un nod nou a fost deja atins de cealalta parte, se
+ * actualizeaza cel mai scurt drum gasit (*best, prin nodul *meet).
+ */
+static void
+bfs_level(const csr_graph_t *g, p2p_side_t *s, p2p_side_t *other, int *head,
+		  int *tail, long long *best, int *meet, sp_stats_t *stats)
+{
+	int end = *tail;
+
+	for (; *head < end; (*head)++) {
+		int u = s->queue[*head];
+
+		stats->settled++;
+		for (long e = g->offsets[u]; e < g->offsets[u + 1]; e++) {
+			int v = g->targets[e];
+
+			stats->relaxed++;
+			if (s->dist[v] != SP_INF)
+				continue;
+
+			side_set(s, v, s->dist[u] + 1, u);
+			s->queue[(*tail)++] = v;
+
+			if (other->dist[v] != SP_INF && s->dist[v] + other->dist[v] < *best) {
+				*best = s->dist[v] + other->dist[v];
+				*meet = v;
+			}
+		}
+	}
+}
+
+/*
+ * BFS bidirectional (costurile muchiilor sunt ignorate). Se extinde cate un
+ * nivel intreg din partea cu frontiera mai mica. Daca src a atins Lf
+ * niveluri si dest Lb niveluri, orice drum negasit inca are lungimea cel
+ * putin Lf + Lb + 1, deci dupa nivelul la care partile se intalnesc drumul
+ * gasit este minim.
+ *
+ * Intoarce lungimea drumului (SP_INF daca nu exista). Daca path nu este
+ * NULL, in el se scriu nodurile drumului (loc pentru g->nodes noduri), iar
+ * in *path_len numarul lor. stats poate fi NULL.
+ */
+long long
+p2p_bidir_bfs(p2p_search_t *p, int src, int dest, int *path, int *path_len,
+			  sp_stats_t *stats)
+{
+	sp_stats_t local;
+	double start = now_ms();
+	long long best = SP_INF;
+	int meet = -1;
+
+	DIE(src < 0 || src >= p->g->nodes || dest < 0 || dest >= p->g->nodes,
+		"node out of range\n");
+	if (!stats)
+		stats = &local;
+	stats->settled = stats->relaxed = 0;
+
+	side_reset(&p->fwd, src);
+	side_reset(&p->bwd, dest);
+
+	if (src == dest) {
+		best = 0;
+		meet = src;
+	}
+
+	int fh = 0, ft = 0, bh = 0, bt = 0;
+	p->fwd.queue[ft++] = src;
+	p->bwd.queue[bt++] = dest;
+
+	while (best == SP_INF && fh < ft && bh < bt) {
+		if (ft - fh <= bt - bh)
+			bfs_level(p->g, &p->fwd, &p->bwd, &fh, &ft, &best, &meet, stats);
+		else
+			bfs_level(p->gt, &p->bwd, &p->fwd, &bh, &bt, &best, &meet, stats);
+	}
+
+	finish_query(p, best, meet, path, path_len, stats, start);
+	return best;
+}
+
+/* Relaxeaza muchiile lui u din partea s pe graful g */
+static void
+dijkstra_step(const csr_graph_t *g, p2p_side_t *s, p2p_side_t *other, int u,
+			  long long d, long long *best, int *meet, sp_stats_t *stats)
+{
+	stats->settled++;
+
+	for (long e = g->offsets[u]; e < g->offsets[u + 1]; e++) {
+		int v = g->targets[e];
+		long long w = g->weights ? g->weights[e] : 1;
+
+		stats->relaxed++;
+		DIE(w < 0, "negative edge cost\n");
+		if (d + w >= s->dist[v])
+			continue;
+
+		side_set(s, v, d + w, u);
+		if (dheap_contains(s->heap, v))
+			dheap_decrease_key(s->heap, v, d + w);
+		else
+			dheap_push(s->heap, v, d + w);
+
+		if (other->dist[v] != SP_INF && d + w + other->dist[v] < *best) {
+			*best = d + w + other->dist[v];
+			*meet = v;
+		}
+	}
+}
+
+/*
+ * Dijkstra bidirectional. La fiecare pas se extinde partea cu cheia minima
+ * mai mica. Cand suma cheilor minime din cele doua heap-uri ajunge la costul
+ * celui mai bun drum gasit, niciun drum prin noduri neextinse nu mai poate
+ * fi mai scurt si cautarea se opreste. Parametrii si rezultatul sunt ca la
+ * p2p_bidir_bfs.
+ */
+long long
+p2p_bidir_dijkstra(p2p_search_t *p, int src, int dest, int *path,
+				   int *path_len, sp_stats_t *stats)
+{
+	sp_stats_t local;
+	double start = now_ms();
+	long long best = SP_INF, d;
+	int meet = -1;
+
+	DIE(src < 0 || src >= p->g->nodes || dest < 0 || dest >= p->g->nodes,
+		"node out of range\n");
+	if (!stats)
+		stats = &local;
+	stats->settled = stats->relaxed = 0;
+
+	side_reset(&p->fwd, src);
+	side_reset(&p->bwd, dest);
+
+	if (src == dest) {
+		best = 0;
+		meet = src;
+	}
+
+	dheap_push(p->fwd.heap, src, 0);
+	dheap_push(p->bwd.heap, dest, 0);
+
+	while (!dheap_is_empty(p->fwd.heap) && !dheap_is_empty(p->bwd.heap)) {
+		long long kf = dheap_min_key(p->fwd.heap);
+		long long kb = dheap_min_key(p->bwd.heap);
+
+		if (best != SP_INF && kf + kb >= best)
+			break;
+
+		if (kf <= kb) {
+			int u = dheap_pop(p->fwd.heap, &d);
+			dijkstra_step(p->g, &p->fwd, &p->bwd, u, d, &best, &meet, stats);
+		} else {
+			int u = dheap_pop(p->bwd.heap, &d);
+			dijkstra_step(p->gt, &p->bwd, &p->fwd, u, d, &best, &meet, stats);
+		}
+	}
+
+	finish_query(p, best, meet, path, path_len, stats, start);
+	return best;
+}
+
+/*
+ * A* de la src la dest cu estimarea h (h = NULL inseamna Dijkstra cu oprire
+ * la dest). Daca h nu este consistenta, un nod deja scos poate fi pus din
+ * nou in heap cand i se gaseste un drum mai scurt, deci rezultatul ramane
+ * corect pentru orice estimare care nu depaseste costul real. Parametrii si
+ * rezultatul sunt ca la p2p_bidir_bfs.
+ */
+long long
+p2p_astar(p2p_search_t *p, int src, int dest, sp_heuristic_fn h, void *harg,
+		  int *path, int *path_len, sp_stats_t *stats)
+{
+	sp_stats_t local;
+	double start = now_ms();
+	const csr_graph_t *g = p->g;
+	p2p_side_t *s = &p->fwd;
+	long long best = SP_INF, key;
+
+	DIE(src < 0 || src >= g->nodes || dest < 0 || dest >= g->nodes,
+		"node out of range\n");
+	if (!stats)
+		stats = &local;
+	stats->settled = stats->relaxed = 0;
+
+	/* Drumul se reconstruieste doar din partea inainte */
+	side_reset(s, src);
+	side_reset(&p->bwd, dest);
+
+	dheap_push(s->heap, src, h ? h(harg, src, dest) : 0);
+
+	while (!dheap_is_empty(s->heap)) {
+		int u = dheap_pop(s->heap, &key);
+
+		if (u == dest) {
+			best = s->dist[u];
+			break;
+		}
+
+		stats->settled++;
+		for (long e = g->offsets[u]; e < g->offsets[u + 1]; e++) {
+			int v = g->targets[e];
+			long long w = g->weights ? g->weights[e] : 1;
+			long long nd = s->dist[u] + w;
+
+			stats->relaxed++;
+			DIE(w < 0, "negative edge cost\n");
+			if (nd >= s->dist[v])
+				continue;
+
+			side_set(s, v, nd, u);
+			key = nd + (h ? h(harg, v, dest) : 0);
+			if (dheap_contains(s->heap, v))
+				dheap_decrease_key(s->heap, v, key);
+			else
+				dheap_push(s->heap, v, key);
+		}
+	}
+
+	finish_query(p, best, dest, path, path_len, stats, start);
+	return best;
+}
@@ -0,0 +1,78 @@
+#ifndef P2P_SEARCH_H
+#define P2P_SEARCH_H
+
+#include "dijkstra.h"
+
+/*
+ * Cautari punct-la-punct (un singur dest), care se opresc cat mai devreme:
+ *
+ * - BFS / Dijkstra bidirectional: o cautare porneste din src pe g, una din
+ *   dest pe transpus, si se opresc cand se intalnesc si niciun drum mai
+ *   scurt nu mai este posibil. Fiecare parte exploreaza o "bila" de raza
+ *   aproximativ d / 2 in loc de una de raza d.
+ * - A*: Dijkstra cu cheia dist[v] + h(v), unde h(v) estimeaza costul
+ *   v -> dest fara sa il depaseasca. O estimare buna indreapta cautarea
+ *   spre dest.
+ *
+ * Toata memoria se aloca o singura data in p2p_search_t. La fiecare
+ * interogare se reseteaza doar nodurile atinse de interogarea anterioara,
+ * deci costul unei interogari nu depinde de marimea grafului.
+ */
+
+typedef struct sp_stats_t sp_stats_t;
+struct sp_stats_t
+{
+	long settled;       /* Noduri scoase din heap / coada */
+	long relaxed;       /* Muchii examinate */
+	double time_ms;
+};
+
+/*
+ * Estimarea costului node -> dest pentru A*. Trebuie sa fie nenegativa si
+ * sa nu depaseasca costul real; daca este si consistenta
+ * (h(u) <= w(u, v) + h(v)), fiecare nod este scos din heap o singura data.
+ */
+typedef long long (*sp_heuristic_fn)(void *arg, int node, int dest);
+
+/* Starea unei directii de cautare */
+typedef struct p2p_side_t p2p_side_t;
+struct p2p_side_t
+{
+	long long *dist;
+	int *pred;
+	/* Nodurile cu dist != SP_INF, resetate la inceputul interogarii */
+	int *touched;
+	int touched_size;
+	/* Coada pentru BFS */
+	int *queue;
+	dheap_t *heap;
+};
+
+typedef struct p2p_search_t p2p_search_t;
+struct p2p_search_t
+{
+	const csr_graph_t *g;
+	const csr_graph_t *gt;
+	p2p_side_t fwd;
+	p2p_side_t bwd;
+};
+
+p2p_search_t *
+p2p_create(const csr_graph_t *g, const csr_graph_t *gt);
+
+long long
+p2p_bidir_bfs(p2p_search_t *p, int src, int dest, int *path, int *path_len,
+			  sp_stats_t *stats);
+
+long long
+p2p_bidir_dijkstra(p2p_search_t *p, int src, int dest, int *path,
+				   int *path_len, sp_stats_t *stats);
+
+long long
+p2p_astar(p2p_search_t *p, int src, int dest, sp_heuristic_fn h, void *harg,
+		  int *path, int *path_len, sp_stats_t *stats);
+
+void
+p2p_free(p2p_search_t *p);
+
+#endif
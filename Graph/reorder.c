@@ -0,0 +1,357 @@
+#include <stdint.h>
+
+#include "reorder.h"
+
+/* Cate BFS-uri se fac cel mult pentru gasirea nodului pseudo-periferic */
+#define RCM_PERIPHERAL_ITERS 8
+/* Bucatile mai scurte sunt sortate prin insertie */
+#define REORDER_SMALL_SORT 16
+
+static int
+cmp_u64(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+static void
+sort_keys(uint64_t *keys, long count)
+{
+	if (count > REORDER_SMALL_SORT) {
+		qsort(keys, count, sizeof(uint64_t), cmp_u64);
+		return;
+	}
+
+	for (long i = 1; i < count; i++) {
+		uint64_t k = keys[i];
+		long j = i;
+
+		for (; j > 0 && keys[j - 1] > k; j--)
+			keys[j] = keys[j - 1];
+		keys[j] = k;
+	}
+}
+
+static reorder_t *
+reorder_alloc(int nodes)
+{
+	reorder_t *r = malloc(sizeof(*r));
+	DIE(!r, "malloc() failed\n");
+
+	r->nodes = nodes;
+	r->new_id = malloc((nodes ? nodes : 1) * sizeof(int));
+	r->old_id = malloc((nodes ? nodes : 1) * sizeof(int));
+	DIE(!r->new_id || !r->old_id, "malloc() failed\n");
+
+	for (int v = 0; v < nodes; v++)
+		r->new_id[v] = -1;
+
+	return r;
+}
+
+/*
+ * BFS din start peste nodurile nemarcate cu stamp si neplasate inca
+ * (placed[v] < 0). Nodurile ajung in queue; intoarce numarul de niveluri, iar
+ * ultimul nivel este queue[*last .. *count - 1].
+ */
+static int
+bfs_levels(const csr_graph_t *g, int start, const int *placed, int *mark,
+		   int stamp, int *queue, int *last, int *count)
+{
+	int head = 0, tail = 0, level_end = 1, levels = 1;
+
+	mark[start] = stamp;
+	queue[tail++] = start;
+	*last = 0;
+
+	while (head < tail) {
+		if (head == level_end) {
+			*last = head;
+			level_end = tail;
+			levels++;
+		}
+
+		int x = queue[head++];
+		for (long e = g->offsets[x]; e < g->offsets[x + 1]; e++) {
+			int y = g->targets[e];
+
+			if (mark[y] != stamp && placed[y] < 0) {
+				mark[y] = stamp;
+				queue[tail++] = y;
+			}
+		}
+	}
+
+	*count = tail;
+	return levels;
+}
+
+/*
+ * Nod pseudo-periferic (George si Liu): pornind din root, se trece in nodul
+ * de grad minim de pe ultimul nivel BFS cat timp numarul de niveluri
+ * creste.
+ */
+static int
+peripheral_node(const csr_graph_t *g, int root, const int *placed, int *mark,
+				int *stamp, int *queue)
+{
+	int last, count;
+	int levels = bfs_levels(g, root, placed, mark, ++*stamp, queue, &last,
+							&count);
+
+	for (int it = 0; it < RCM_PERIPHERAL_ITERS; it++) {
+		int best = queue[last];
+
+		for (int i = last + 1; i < count; i++)
+			if (csr_degree(g, queue[i]) < csr_degree(g, best))
+				best = queue[i];
+
+		int next = bfs_levels(g, best, placed, mark, ++*stamp, queue, &last,
+							  &count);
+		if (next <= levels)
+			break;
+
+		root = best;
+		levels = next;
+	}
+
+	return root;
+}
+
+/*
+ * Cuthill-McKee din root: BFS in care vecinii nevizitati ai fiecarui nod
+ * sunt adaugati crescator dupa grad (la egalitate dupa id). Nodurile se scriu
+ * in order de la *pos; new_id[v] >= 0 marcheaza nodurile plasate.
+ */
+static void
+cuthill_mckee(const csr_graph_t *g, int root, int *new_id, int *order,
+			  int *pos, uint64_t *keys)
+{
+	int head = *pos;
+
+	new_id[root] = *pos;
+	order[(*pos)++] = root;
+
+	while (head < *pos) {
+		int x = order[head++];
+		long count = 0;
+
+		for (long e = g->offsets[x]; e < g->offsets[x + 1]; e++) {
+			int y = g->targets[e];
+
+			if (new_id[y] >= 0)
+				continue;
+			new_id[y] = 0;
+			keys[count++] = (uint64_t)csr_degree(g, y) << 32 | (uint32_t)y;
+		}
+
+		sort_keys(keys, count);
+		for (long k = 0; k < count; k++) {
+			int y = (int)(uint32_t)keys[k];
+
+			new_id[y] = *pos;
+			order[(*pos)++] = y;
+		}
+	}
+}
+
+static void
+order_rcm(const csr_graph_t *g, reorder_t *r)
+{
+	int n = g->nodes, pos = 0, stamp = 0;
+	long max_degree = 0;
+
+	for (int v = 0; v < n; v++)
+		if (csr_degree(g, v) > max_degree)
+			max_degree = csr_degree(g, v);
+
+	int *order = malloc((n ? n : 1) * sizeof(int));
+	int *mark = calloc(n ? n : 1, sizeof(int));
+	uint64_t *keys = malloc((max_degree ? max_degree : 1) * sizeof(uint64_t));
+	DIE(!order || !mark || !keys, "malloc() failed\n");
+
+	/* queue pentru bfs_levels refoloseste old_id, completat abia la sfarsit */
+	for (int v = 0; v < n; v++) {
+		if (r->new_id[v] >= 0)
+			continue;
+
+		int root = peripheral_node(g, v, r->new_id, mark, &stamp, r->old_id);
+		cuthill_mckee(g, root, r->new_id, order, &pos, keys);
+
+		/* Pe un graf orientat root poate sa nu ajunga in v; atunci v devine
+		 * el insusi radacina */
+		if (r->new_id[v] < 0)
+			cuthill_mckee(g, v, r->new_id, order, &pos, keys);
+	}
+	DIE(pos != n, "RCM did not place every node\n");
+
+	for (int i = 0; i < n; i++) {
+		r->old_id[i] = order[n - 1 - i];
+		r->new_id[r->old_id[i]] = i;
+	}
+
+	free(order);
+	free(mark);
+	free(keys);
+}
+
+/* Sortare prin numarare dupa grad, descrescator; stabila, deci la grad egal
+ * ramane ordinea id-urilor */
+static void
+order_degree(const csr_graph_t *g, reorder_t *r)
+{
+	int n = g->nodes;
+	long max_degree = 0;
+
+	for (int v = 0; v < n; v++)
+		if (csr_degree(g, v) > max_degree)
+			max_degree = csr_degree(g, v);
+
+	long *start = calloc(max_degree + 2, sizeof(long));
+	DIE(!start, "calloc() failed\n");
+
+	/* Pozitia de start a gradului d este numarul de noduri cu grad > d */
+	for (int v = 0; v < n; v++)
+		start[max_degree - csr_degree(g, v) + 1]++;
+	for (long d = 0; d <= max_degree; d++)
+		start[d + 1] += start[d];
+
+	for (int v = 0; v < n; v++) {
+		int i = (int)start[max_degree - csr_degree(g, v)]++;
+
+		r->new_id[v] = i;
+		r->old_id[i] = v;
+	}
+
+	free(start);
+}
+
+static void
+order_bfs(const csr_graph_t *g, reorder_t *r)
+{
+	int n = g->nodes, pos = 0;
+
+	for (int s = 0; s < n; s++) {
+		if (r->new_id[s] >= 0)
+			continue;
+
+		int head = pos;
+		r->new_id[s] = pos;
+		r->old_id[pos++] = s;
+
+		while (head < pos) {
+			int x = r->old_id[head++];
+
+			for (long e = g->offsets[x]; e < g->offsets[x + 1]; e++) {
+				int y = g->targets[e];
+
+				if (r->new_id[y] < 0) {
+					r->new_id[y] = pos;
+					r->old_id[pos++] = y;
+				}
+			}
+		}
+	}
+}
+
+/* Permutarea de tipul kind pentru g; se elibereaza cu reorder_free */
+reorder_t *
+reorder_compute(const csr_graph_t *g, reorder_kind_t kind)
+{
+	reorder_t *r = reorder_alloc(g->nodes);
+
+	switch (kind) {
+	case REORDER_RCM:
+		order_rcm(g, r);
+		break;
+	case REORDER_DEGREE:
+		order_degree(g, r);
+		break;
+	case REORDER_BFS:
+		order_bfs(g, r);
+		break;
+	}
+
+	return r;
+}
+
+/*
+ * Graful g cu nodurile renumerotate dupa r. Vecinii fiecarui nod sunt in
+ * ordinea crescatoare a id-urilor noi (costurile ii insotesc), fara nicio
+ * sortare: muchiile sunt distribuite pe randuri luand destinatiile in
+ * ordinea id-urilor noi, din graful transpus.
+ */
+csr_graph_t *
+reorder_apply(const csr_graph_t *g, const reorder_t *r)
+{
+	int n = g->nodes;
+	csr_graph_t *gt = csr_transpose(g);
+	csr_graph_t *h = csr_alloc(n, g->edges, g->weights != NULL);
+	long *cursor = malloc((n ? n : 1) * sizeof(long));
+	DIE(!cursor, "malloc() failed\n");
+
+	for (int i = 0; i < n; i++) {
+		h->offsets[i + 1] = h->offsets[i] + csr_degree(g, r->old_id[i]);
+		cursor[i] = h->offsets[i];
+	}
+
+	for (int j = 0; j < n; j++) {
+		int v = r->old_id[j];
+
+		for (long e = gt->offsets[v]; e < gt->offsets[v + 1]; e++) {
+			long k = cursor[r->new_id[gt->targets[e]]]++;
+
+			h->targets[k] = j;
+			if (h->weights)
+				h->weights[k] = gt->weights[e];
+		}
+	}
+
+	free(cursor);
+	csr_free(gt);
+	return h;
+}
+
+/*
+ * Traduce un vector calculat pe graful renumerotat: out[v] = in[new_id[v]]
+ * pentru fiecare nod vechi v. Daca values_are_nodes, valorile sunt si ele
+ * id-uri noi de noduri (de exemplu parent[]) si sunt traduse cu
+ * reorder_node_old. in si out nu trebuie sa se suprapuna.
+ */
+void
+reorder_to_old(const reorder_t *r, const int *in, int *out, int values_are_nodes)
+{
+	for (int v = 0; v < r->nodes; v++) {
+		int x = in[r->new_id[v]];
+
+		out[v] = values_are_nodes ? reorder_node_old(r, x) : x;
+	}
+}
+
+/* "rcm", "degree" sau "bfs"; intoarce 0 pentru un nume necunoscut */
+int
+reorder_parse_kind(const char *name, reorder_kind_t *kind)
+{
+	if (strcmp(name, "rcm") == 0)
+		*kind = REORDER_RCM;
+	else if (strcmp(name, "degree") == 0)
+		*kind = REORDER_DEGREE;
+	else if (strcmp(name, "bfs") == 0)
+		*kind = REORDER_BFS;
+	else
+		return 0;
+
+	return 1;
+}
+
+void
+reorder_free(reorder_t *r)
+{
+	if (!r)
+		return;
+
+	free(r->new_id);
+	free(r->old_id);
+	free(r);
+}
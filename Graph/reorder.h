@@ -0,0 +1,70 @@
+#ifndef REORDER_H
+#define REORDER_H
+
+#include "csr_graph.h"
+
+/*
+ * Renumerotarea nodurilor unui graf CSR, pentru ca parcurgerile sa atinga
+ * memoria in ordine. Id-urile citite din fisiere urmeaza ordinea din intrare,
+ * asa ca vecinii unui nod sunt, de obicei, imprastiati prin tot graful; dupa
+ * renumerotare nodurile vizitate unul dupa altul au id-uri apropiate, deci
+ * datele lor (offsets, level, parent, ...) sunt in aceleasi linii de cache.
+ *
+ * REORDER_RCM     Reverse Cuthill-McKee: BFS din cate un nod pseudo-periferic
+ *                 al fiecarei componente, cu vecinii luati crescator dupa
+ *                 grad, iar ordinea finala este inversata. Micsoreaza
+ *                 latimea de banda a matricei de adiacenta.
+ * REORDER_DEGREE  Descrescator dupa grad (la egalitate dupa id): nodurile cu
+ *                 multi vecini, atinse cel mai des, ajung impreuna la inceput.
+ * REORDER_BFS     Ordinea unui BFS din nodul 0, apoi din fiecare nod
+ *                 nevizitat inca.
+ *
+ * Pe grafurile orientate se folosesc doar muchiile de iesire.
+ *
+ * Rezultatul este o permutare in ambele sensuri: new_id[v] este id-ul nou al
+ * nodului v, old_id[i] nodul care a primit id-ul i. reorder_apply construieste
+ * graful renumerotat; rezultatele calculate pe el (vectori indexati dupa id-ul
+ * nou, eventual cu id-uri noi ca valori) se traduc inapoi cu
+ * reorder_to_old si reorder_node_old.
+ */
+
+typedef enum reorder_kind_t reorder_kind_t;
+enum reorder_kind_t
+{
+	REORDER_RCM,
+	REORDER_DEGREE,
+	REORDER_BFS
+};
+
+typedef struct reorder_t reorder_t;
+struct reorder_t
+{
+	int nodes;
+	int *new_id;        /* id vechi -> id nou */
+	int *old_id;        /* id nou -> id vechi */
+};
+
+reorder_t *
+reorder_compute(const csr_graph_t *g, reorder_kind_t kind);
+
+csr_graph_t *
+reorder_apply(const csr_graph_t *g, const reorder_t *r);
+
+void
+reorder_to_old(const reorder_t *r, const int *in, int *out, int values_are_nodes);
+
+void
+reorder_free(reorder_t *r);
+
+int
+reorder_parse_kind(const char *name, reorder_kind_t *kind);
+
+/* Id-ul vechi al nodului cu id-ul nou v; valorile negative (de exemplu -1
+ * pentru "nevizitat") raman neschimbate */
+static inline int
+reorder_node_old(const reorder_t *r, int v)
+{
+	return v < 0 ? v : r->old_id[v];
+}
+
+#endif
@@ -0,0 +1,567 @@
+#include "scc.h"
+#include "dfs_engine.h"
+
+/* Cate noduri primeste cel putin un task la trimming */
+#define FB_GRAIN 4096
+/* De cate ori se repeta cel mult trimming-ul */
+#define FB_TRIM_ROUNDS 8
+/* Subproblemele mai mici sunt rezolvate cu Tarjan, de task-ul care le-a
+ * creat */
+#define FB_SPAWN_MIN 1024
+/* Dupa atatia pasi forward-backward o subproblema este rezolvata cu Tarjan */
+#define FB_MAX_DEPTH 8
+
+#define FB_FWD 1
+#define FB_BWD 2
+
+/* --- Rezultatul comun --- */
+
+/*
+ * Construieste rezultatul din etichetele label[] (0 .. count - 1, in orice
+ * ordine; label trece in rezultat). Componentele sunt renumerotate intai in
+ * ordinea celui mai mic nod, apoi in ordinea data de dfs_top_sort pe graful
+ * condensat, ca numerotarea sa nu depinda de algoritm.
+ */
+static scc_result_t *
+scc_finish(const csr_graph_t *g, int *label, int count)
+{
+	int n = g->nodes, c;
+	int *map = malloc((count ? count : 1) * sizeof(int));
+	int *start = calloc(count + 1, sizeof(int));
+	int *members = malloc((n ? n : 1) * sizeof(int));
+	int *mark = malloc((count ? count : 1) * sizeof(int));
+	DIE(!map || !start || !members || !mark, "malloc() failed\n");
+
+	for (c = 0; c < count; c++)
+		map[c] = -1;
+	for (int v = 0, next = 0; v < n; v++) {
+		if (map[label[v]] < 0)
+			map[label[v]] = next++;
+		label[v] = map[label[v]];
+		start[label[v] + 1]++;
+	}
+
+	/* Nodurile grupate pe componente */
+	for (c = 0; c < count; c++)
+		start[c + 1] += start[c];
+	for (int v = 0; v < n; v++)
+		members[start[label[v]]++] = v;
+	for (c = count; c > 0; c--)
+		start[c] = start[c - 1];
+	start[0] = 0;
+
+	/* Muchiile dintre componente, fara duplicate: mark[d] = ultima
+	 * componenta care a adaugat muchia spre d */
+	long edges = 0;
+	int *targets = malloc((g->edges ? g->edges : 1) * sizeof(int));
+	long *offsets = malloc((count + 1L) * sizeof(long));
+	DIE(!targets || !offsets, "malloc() failed\n");
+
+	for (c = 0; c < count; c++)
+		mark[c] = -1;
+	offsets[0] = 0;
+	for (c = 0; c < count; c++) {
+		for (int i = start[c]; i < start[c + 1]; i++) {
+			int u = members[i];
+
+			for (long e = g->offsets[u]; e < g->offsets[u + 1]; e++) {
+				int d = label[g->targets[e]];
+
+				if (d != c && mark[d] != c) {
+					mark[d] = c;
+					targets[edges++] = d;
+				}
+			}
+		}
+		offsets[c + 1] = edges;
+	}
+
+	/* Renumerotarea in ordine topologica: componenta order[i] devine i */
+	csr_graph_t tmp = { .nodes = count, .edges = edges, .offsets = offsets,
+						.targets = targets, .weights = NULL };
+	int *order = members;
+	dfs_top_sort(&tmp, order);
+	for (int i = 0; i < count; i++)
+		map[order[i]] = i;
+
+	scc_result_t *r = malloc(sizeof(*r));
+	DIE(!r, "malloc() failed\n");
+	r->nodes = n;
+	r->components = count;
+	r->label = label;
+	r->size = malloc((count ? count : 1) * sizeof(int));
+	r->dag = csr_alloc(count, edges, 0);
+	DIE(!r->size, "malloc() failed\n");
+
+	for (int v = 0; v < n; v++)
+		label[v] = map[label[v]];
+	for (int i = 0; i < count; i++) {
+		int old = order[i];
+		long deg = offsets[old + 1] - offsets[old];
+
+		r->size[i] = start[old + 1] - start[old];
+		r->dag->offsets[i + 1] = r->dag->offsets[i] + deg;
+		for (long e = 0; e < deg; e++)
+			r->dag->targets[r->dag->offsets[i] + e] =
+				map[targets[offsets[old] + e]];
+	}
+
+	free(map);
+	free(start);
+	free(members);
+	free(mark);
+	free(targets);
+	free(offsets);
+
+	return r;
+}
+
+void
+scc_result_free(scc_result_t *r)
+{
+	if (!r)
+		return;
+
+	free(r->label);
+	free(r->size);
+	csr_free(r->dag);
+	free(r);
+}
+
+/* --- Tarjan --- */
+
+typedef struct tarjan_state_t tarjan_state_t;
+struct tarjan_state_t
+{
+	const dfs_t *d;
+	int *low;
+	int *label;         /* -1 cat timp nodul este pe stiva de componente */
+	int *stack;
+	int top;
+	int count;
+};
+
+static int
+tarjan_pre(void *arg, int node, int parent)
+{
+	tarjan_state_t *s = arg;
+
+	(void)parent;
+	s->low[node] = s->d->disc[node];
+	s->stack[s->top++] = node;
+	return 0;
+}
+
+static int
+tarjan_edge(void *arg, int u, int v, dfs_edge_kind_t kind)
+{
+	tarjan_state_t *s = arg;
+
+	if (kind != DFS_TREE && s->label[v] < 0 && s->d->disc[v] < s->low[u])
+		s->low[u] = s->d->disc[v];
+	return 0;
+}
+
+static int
+tarjan_post(void *arg, int node, int parent)
+{
+	tarjan_state_t *s = arg;
+
+	if (s->low[node] == s->d->disc[node]) {
+		int v;
+
+		do {
+			v = s->stack[--s->top];
+			s->label[v] = s->count;
+		} while (v != node);
+		s->count++;
+	}
+
+	if (parent >= 0 && s->low[node] < s->low[parent])
+		s->low[parent] = s->low[node];
+	return 0;
+}
+
+/* Componentele tare conexe ale lui g; rezultatul se elibereaza cu
+ * scc_result_free */
+scc_result_t *
+scc_tarjan(const csr_graph_t *g)
+{
+	int n = g->nodes ? g->nodes : 1;
+	dfs_t *d = dfs_create(g);
+	tarjan_state_t s = { .d = d };
+
+	s.low = malloc(n * sizeof(int));
+	s.label = malloc(n * sizeof(int));
+	s.stack = malloc(n * sizeof(int));
+	DIE(!s.low || !s.label || !s.stack, "malloc() failed\n");
+	for (int v = 0; v < g->nodes; v++)
+		s.label[v] = -1;
+
+	dfs_visitor_t vis = { tarjan_pre, tarjan_post, tarjan_edge, &s };
+	dfs_run(d, &vis);
+
+	dfs_free(d);
+	free(s.low);
+	free(s.stack);
+
+	return scc_finish(g, s.label, s.count);
+}
+
+/* --- Forward-backward --- */
+
+typedef struct fb_state_t fb_state_t;
+struct fb_state_t
+{
+	const csr_graph_t *g;
+	const csr_graph_t *gt;
+	thread_pool_t *tp;
+	tp_group_t group;
+
+	/* Nodurile inca nerezolvate; fiecare subproblema este o bucata din perm,
+	 * iar bucata corespunzatoare din queue ii serveste drept coada */
+	int *perm;
+	int *queue;
+	/* part[v] = subproblema nodului v, -1 dupa ce v primeste o componenta */
+	atomic_int *part;
+	atomic_int *label;
+	/* mark (FB_FWD / FB_BWD), disc si low sunt scrise si citite doar de
+	 * task-ul care detine nodul */
+	unsigned char *mark;
+	int *disc;
+	int *low;
+	atomic_int components;
+	atomic_int parts;
+	atomic_long trimmed;
+};
+
+typedef struct fb_sub_t fb_sub_t;
+struct fb_sub_t
+{
+	fb_state_t *s;
+	int begin;
+	int count;
+	int id;
+	int depth;          /* Cati pasi forward-backward au dus la ea */
+};
+
+static inline int
+fb_live(fb_state_t *s, int v)
+{
+	return atomic_load_explicit(&s->label[v], memory_order_relaxed) < 0;
+}
+
+/* Are v un vecin in g, diferit de el, fara componenta? */
+static inline int
+has_live_neighbor(fb_state_t *s, const csr_graph_t *g, int v)
+{
+	for (long e = g->offsets[v]; e < g->offsets[v + 1]; e++)
+		if (g->targets[e] != v && fb_live(s, g->targets[e]))
+			return 1;
+
+	return 0;
+}
+
+/*
+ * Un nod fara vecini de intrare sau fara vecini de iesire ramasi este singur
+ * in componenta lui. Nodurile eliminate intre timp de alte thread-uri doar
+ * micsoreaza multimea vecinilor ramasi, deci decizia ramane corecta.
+ */
+static void
+trim_range(void *arg, long lo, long hi)
+{
+	fb_state_t *s = arg;
+	long trimmed = 0;
+
+	for (long v = lo; v < hi; v++) {
+		if (!fb_live(s, (int)v))
+			continue;
+		if (has_live_neighbor(s, s->g, (int)v)
+			&& has_live_neighbor(s, s->gt, (int)v))
+			continue;
+
+		atomic_store_explicit(&s->label[v],
+							  atomic_fetch_add(&s->components, 1),
+							  memory_order_relaxed);
+		trimmed++;
+	}
+
+	atomic_fetch_add_explicit(&s->trimmed, trimmed, memory_order_relaxed);
+}
+
+/* Marcheaza cu bit nodurile subproblemei accesibile din start pe muchiile
+ * lui g */
+static void
+fb_reach(fb_state_t *s, const fb_sub_t *sub, const csr_graph_t *g, int start,
+		 unsigned char bit)
+{
+	int *queue = s->queue + sub->begin;
+	int head = 0, tail = 0;
+
+	s->mark[start] |= bit;
+	queue[tail++] = start;
+
+	while (head < tail) {
+		int x = queue[head++];
+
+		for (long e = g->offsets[x]; e < g->offsets[x + 1]; e++) {
+			int y = g->targets[e];
+
+			if (atomic_load_explicit(&s->part[y], memory_order_relaxed)
+				!= sub->id || (s->mark[y] & bit))
+				continue;
+
+			s->mark[y] |= bit;
+			queue[tail++] = y;
+		}
+	}
+}
+
+/*
+ * Tarjan iterativ doar pe nodurile subproblemei (dfs_engine.h ar aloca
+ * structuri pentru tot graful la fiecare apel). Un vecin cu part == id este
+ * fie nevizitat, fie inca pe stiva de componente: nodurile care primesc o
+ * componenta ies din subproblema (part = -1).
+ */
+static void
+fb_tarjan(fb_state_t *s, const fb_sub_t *sub)
+{
+	const csr_graph_t *g = s->g;
+	const int *nodes = s->perm + sub->begin;
+	int *stack = s->queue + sub->begin;
+	dfs_frame_t *frames = malloc(sub->count * sizeof(dfs_frame_t));
+	DIE(!frames, "malloc() failed\n");
+
+	int time = 0, top = 0;
+	for (int i = 0; i < sub->count; i++)
+		s->disc[nodes[i]] = -1;
+
+	for (int i = 0; i < sub->count; i++) {
+		int root = nodes[i], depth = 0;
+
+		if (s->disc[root] >= 0)
+			continue;
+
+		s->disc[root] = s->low[root] = time++;
+		stack[top++] = root;
+		frames[depth++] = (dfs_frame_t){ root, g->offsets[root] };
+
+		while (depth) {
+			dfs_frame_t *f = &frames[depth - 1];
+			int u = f->node, descended = 0;
+
+			while (f->cursor < g->offsets[u + 1]) {
+				int v = g->targets[f->cursor++];
+
+				if (atomic_load_explicit(&s->part[v], memory_order_relaxed)
+					!= sub->id)
+					continue;
+
+				if (s->disc[v] < 0) {
+					s->disc[v] = s->low[v] = time++;
+					stack[top++] = v;
+					frames[depth++] = (dfs_frame_t){ v, g->offsets[v] };
+					descended = 1;
+					break;
+				}
+				if (s->disc[v] < s->low[u])
+					s->low[u] = s->disc[v];
+			}
+
+			if (descended)
+				continue;
+
+			depth--;
+			if (s->low[u] == s->disc[u]) {
+				int comp = atomic_fetch_add(&s->components, 1), v;
+
+				do {
+					v = stack[--top];
+					atomic_store_explicit(&s->part[v], -1,
+										  memory_order_relaxed);
+					atomic_store_explicit(&s->label[v], comp,
+										  memory_order_relaxed);
+				} while (v != u);
+			}
+			if (depth && s->low[u] < s->low[frames[depth - 1].node])
+				s->low[frames[depth - 1].node] = s->low[u];
+		}
+	}
+
+	free(frames);
+}
+
+/* Un pas forward-backward: componenta pivotului si cele trei subprobleme
+ * ramase, puse pe stiva sau trimise pool-ului */
+static void fb_push(fb_state_t *s, fb_sub_t *stack, int *top, int begin,
+					int count, int depth);
+
+static void
+fb_split(fb_state_t *s, const fb_sub_t *sub, fb_sub_t *stack, int *top)
+{
+	int *nodes = s->perm + sub->begin;
+	int *tmp = s->queue + sub->begin;
+	int comp = atomic_fetch_add(&s->components, 1);
+
+	fb_reach(s, sub, s->g, nodes[0], FB_FWD);
+	fb_reach(s, sub, s->gt, nodes[0], FB_BWD);
+
+	/* Impartirea pe loc: F si B (componenta), doar F, doar B, restul */
+	static const int group_of[4] = { 3, 1, 2, 0 };
+	int count[4] = { 0 }, at[4];
+
+	for (int i = 0; i < sub->count; i++)
+		count[group_of[s->mark[nodes[i]]]]++;
+	at[0] = 0;
+	for (int k = 1; k < 4; k++)
+		at[k] = at[k - 1] + count[k - 1];
+	for (int i = 0; i < sub->count; i++) {
+		int v = nodes[i];
+
+		tmp[at[group_of[s->mark[v]]]++] = v;
+		s->mark[v] = 0;
+	}
+	memcpy(nodes, tmp, sub->count * sizeof(int));
+
+	for (int i = 0; i < count[0]; i++) {
+		atomic_store_explicit(&s->part[nodes[i]], -1, memory_order_relaxed);
+		atomic_store_explicit(&s->label[nodes[i]], comp, memory_order_relaxed);
+	}
+
+	int begin = sub->begin + count[0];
+	for (int k = 1; k < 4; k++) {
+		fb_push(s, stack, top, begin, count[k], sub->depth + 1);
+		begin += count[k];
+	}
+}
+
+/*
+ * Rezolva o subproblema si pe cele mici create din ea. Fiecare pas adauga pe
+ * stiva locala cel mult 3 subprobleme si scoate una, iar toate sunt disjuncte
+ * si nevide, deci pe stiva sunt cel mult 2 * count + 1.
+ */
+static void
+fb_task(void *arg)
+{
+	fb_sub_t *first = arg;
+	fb_state_t *s = first->s;
+	int cap = 2 * first->count + 1, top = 0;
+	fb_sub_t *stack = malloc(cap * sizeof(fb_sub_t));
+	DIE(!stack, "malloc() failed\n");
+
+	stack[top++] = *first;
+	free(first);
+
+	while (top) {
+		fb_sub_t sub = stack[--top];
+
+		/* Pe lanturi de componente mici fiecare pas ar desprinde doar
+		 * cateva noduri, deci dupa FB_MAX_DEPTH pasi (si pentru
+		 * subproblemele mici) se trece la Tarjan, liniar in marime */
+		if (sub.count < FB_SPAWN_MIN || sub.depth >= FB_MAX_DEPTH)
+			fb_tarjan(s, &sub);
+		else
+			fb_split(s, &sub, stack, &top);
+	}
+
+	free(stack);
+}
+
+/* Noua subproblema din perm[begin, begin + count) */
+static void
+fb_push(fb_state_t *s, fb_sub_t *stack, int *top, int begin, int count,
+		int depth)
+{
+	if (!count)
+		return;
+
+	int id = atomic_fetch_add_explicit(&s->parts, 1, memory_order_relaxed);
+	for (int i = begin; i < begin + count; i++)
+		atomic_store_explicit(&s->part[s->perm[i]], id, memory_order_relaxed);
+
+	fb_sub_t sub = { s, begin, count, id, depth };
+	if (count >= FB_SPAWN_MIN) {
+		fb_sub_t *task = malloc(sizeof(*task));
+		DIE(!task, "malloc() failed\n");
+		*task = sub;
+		tp_spawn(s->tp, &s->group, fb_task, task);
+	} else {
+		stack[(*top)++] = sub;
+	}
+}
+
+/*
+ * Componentele tare conexe ale lui g, in paralel pe tp. Fara tp (sau cu un
+ * singur thread) se foloseste direct scc_tarjan. Rezultatul este acelasi ca
+ * la scc_tarjan.
+ */
+scc_result_t *
+scc_fw_bw(thread_pool_t *tp, const csr_graph_t *g)
+{
+	if (!tp || tp_get_threads(tp) == 1)
+		return scc_tarjan(g);
+
+	int n = g->nodes ? g->nodes : 1;
+	fb_state_t s = { .g = g, .tp = tp };
+
+	s.gt = csr_transpose(g);
+	s.perm = malloc(n * sizeof(int));
+	s.queue = malloc(n * sizeof(int));
+	s.part = malloc(n * sizeof(atomic_int));
+	s.label = malloc(n * sizeof(atomic_int));
+	s.mark = calloc(n, 1);
+	s.disc = malloc(n * sizeof(int));
+	s.low = malloc(n * sizeof(int));
+	DIE(!s.perm || !s.queue || !s.part || !s.label || !s.mark || !s.disc
+		|| !s.low, "malloc() failed\n");
+	atomic_init(&s.components, 0);
+	atomic_init(&s.parts, 1);
+
+	for (int v = 0; v < g->nodes; v++) {
+		atomic_init(&s.part[v], 0);
+		atomic_init(&s.label[v], -1);
+	}
+
+	for (int round = 0; round < FB_TRIM_ROUNDS; round++) {
+		atomic_store(&s.trimmed, 0);
+		if (g->nodes <= FB_GRAIN)
+			trim_range(&s, 0, g->nodes);
+		else
+			tp_parallel_for(tp, 0, g->nodes, FB_GRAIN, trim_range, &s);
+		if (!atomic_load(&s.trimmed))
+			break;
+	}
+
+	int live = 0;
+	for (int v = 0; v < g->nodes; v++) {
+		if (fb_live(&s, v))
+			s.perm[live++] = v;
+		else
+			atomic_store_explicit(&s.part[v], -1, memory_order_relaxed);
+	}
+
+	if (live) {
+		fb_sub_t *root = malloc(sizeof(*root));
+		DIE(!root, "malloc() failed\n");
+		*root = (fb_sub_t){ &s, 0, live, 0, 0 };
+
+		tp_group_init(&s.group);
+		tp_spawn(tp, &s.group, fb_task, root);
+		tp_group_wait(tp, &s.group);
+	}
+
+	/* label[] devine un vector obisnuit, refolosind perm */
+	int *label = s.perm;
+	for (int v = 0; v < g->nodes; v++)
+		label[v] = atomic_load_explicit(&s.label[v], memory_order_relaxed);
+
+	csr_free((csr_graph_t *)s.gt);
+	free(s.queue);
+	free(s.part);
+	free(s.label);
+	free(s.mark);
+	free(s.disc);
+	free(s.low);
+
+	return scc_finish(g, label, atomic_load(&s.components));
+}
@@ -0,0 +1,56 @@
+#ifndef SCC_H
+#define SCC_H
+
+#include <stdatomic.h>
+
+#include "csr_graph.h"
+#include "thread_pool.h"
+
+/*
+ * Componentele tare conexe ale unui graf orientat si graful condensat (DAG-ul
+ * componentelor).
+ *
+ * scc_tarjan este algoritmul lui Tarjan construit pe dfs_engine.h, deci fara
+ * recursivitate: low[] se actualizeaza pe muchiile spre noduri inca pe stiva
+ * de componente si la terminarea fiecarui nod.
+ *
+ * scc_fw_bw este varianta paralela forward-backward (Fleischer, Hendrickson,
+ * Pinar): nodurile care nu au vecini de intrare sau de iesire ramasi sunt
+ * componente de un singur nod si sunt eliminate intai, in paralel (trimming).
+ * Din restul se alege un pivot; nodurile accesibile din el (F) si cele din
+ * care el este accesibil (B) dau componenta lui, F intersectat cu B. F \ B,
+ * B \ F si restul nu mai au componente comune, deci sunt rezolvate ca
+ * subprobleme independente, pe thread-uri diferite. Fiecare subproblema este
+ * o bucata dintr-un singur vector de noduri, impartita pe loc. Subproblemele
+ * mici si cele la care s-a ajuns dupa prea multi pasi (pe un lant de
+ * componente fiecare pas ar desprinde doar una) sunt rezolvate cu Tarjan,
+ * restrans la nodurile lor.
+ *
+ * Ambele variante dau acelasi rezultat: componentele sunt numerotate in
+ * ordinea topologica a grafului condensat (o muchie u -> v din graf duce
+ * dintr-o componenta intr-una cu numar mai mare sau egal), iar ordinea este
+ * unic determinata de graf, nu de algoritm sau de numarul de thread-uri.
+ */
+
+typedef struct scc_result_t scc_result_t;
+struct scc_result_t
+{
+	int nodes;
+	int components;
+	int *label;         /* label[v] = componenta nodului v */
+	int *size;          /* size[c] = numarul de noduri din componenta c */
+	/* Graful condensat: un nod pentru fiecare componenta si o singura
+	 * muchie c -> d (c < d) daca exista o muchie intre ele in graf */
+	csr_graph_t *dag;
+};
+
+scc_result_t *
+scc_tarjan(const csr_graph_t *g);
+
+scc_result_t *
+scc_fw_bw(thread_pool_t *tp, const csr_graph_t *g);
+
+void
+scc_result_free(scc_result_t *r);
+
+#endif
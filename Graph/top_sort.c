@@ -3,6 +3,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <errno.h>
+#include <unistd.h>
 
 #define HMAX 100
 #define MAX_STRING_SIZE 64
@@ -19,6 +20,12 @@
         }                                           \
     } while (0)
 
+#include "csr_graph.h"
+#include "dfs_engine.h"
+#include "dyn_topo.h"
+#include "named_graph.h"
+#include "scc.h"
+
 typedef struct ll_node_t ll_node_t;
 typedef struct linked_list_t linked_list_t;
 typedef struct stack_t stack_t;
@@ -192,10 +199,158 @@ linked_list_t *top_sort(list_graph_t *graph)
     return list;
 }
 
-int main()
+/*
+ * Construieste reprezentarea CSR a grafului. Vecinii fiecarui nod raman in
+ * ordinea din lista de adiacenta.
+ */
+csr_graph_t* lg_to_csr(list_graph_t* lg)
+{
+    long edges = 0;
+
+    for (int i = 0; i < lg->nodes; i++)
+        edges += lg->neighbors[i]->size;
+
+    csr_graph_t* g = csr_alloc(lg->nodes, edges, 0);
+    for (int i = 0; i < lg->nodes; i++) {
+        long e = g->offsets[i];
+        g->offsets[i + 1] = e + lg->neighbors[i]->size;
+        for (ll_node_t* it = lg->neighbors[i]->head; it; it = it->next)
+            g->targets[e++] = *(int *)it->data;
+    }
+
+    return g;
+}
+
+/*
+ * Sortarea topologica pe un graf CSR, cu DFS-ul iterativ din dfs_engine.h
+ * (merge si pe lanturi cu milioane de noduri). Intoarce un vector cu
+ * g->nodes noduri (in aceeasi ordine ca top_sort), care trebuie eliberat de
+ * apelant. Daca graful are un ciclu, acesta este afisat la stderr.
+ */
+int *top_sort_csr(csr_graph_t *g)
+{
+    int *order = malloc((g->nodes ? g->nodes : 1) * sizeof(int));
+    DIE(!order, "malloc() failed\n");
+
+    if (!dfs_top_sort(g, order)) {
+        int *cycle = malloc(g->nodes * sizeof(int));
+        DIE(!cycle, "malloc() failed\n");
+
+        int len = dfs_find_cycle(g, cycle);
+        fprintf(stderr, "graph has a cycle:");
+        for (int i = 0; i < len; i++)
+            fprintf(stderr, " %d ->", cycle[i]);
+        fprintf(stderr, " %d\n", cycle[0]);
+        free(cycle);
+    }
+
+    return order;
+}
+
+/* Pentru modul "dyn": numele nodurilor si muchiile date lui dt_add_edges */
+typedef struct reject_ctx_t reject_ctx_t;
+struct reject_ctx_t
+{
+    hashtable_t *names;
+    const int *edges;
+};
+
+/* Afiseaza la stderr o muchie refuzata de dt_add_edges si ciclul inchis */
+void print_rejected(void *arg, int edge, const int *cycle, int len)
+{
+    reject_ctx_t *ctx = arg;
+    int u = ctx->edges[2 * edge], v = ctx->edges[2 * edge + 1];
+
+    fprintf(stderr, "edge %s -> %s closes a cycle:",
+            (char*) ht_get(ctx->names, &u), (char*) ht_get(ctx->names, &v));
+    for (int j = 0; j < len; j++) {
+        int node = cycle[j];
+        fprintf(stderr, " %s ->", (char*) ht_get(ctx->names, &node));
+    }
+    fprintf(stderr, " %s\n", (char*) ht_get(ctx->names, &v));
+}
+
+/*
+ * Afiseaza componentele tare conexe, cate una pe linie, in ordinea
+ * topologica a grafului condensat (o materie apare dupa toate componentele
+ * de care depinde). Nodurile unei componente sunt in ordine crescatoare.
+ */
+void print_scc(const scc_result_t *r, const name_table_t *names)
+{
+    int *start = calloc(r->components + 1, sizeof(int));
+    int *members = malloc((r->nodes ? r->nodes : 1) * sizeof(int));
+    DIE(!start || !members, "malloc() failed\n");
+
+    for (int c = 0; c < r->components; c++)
+        start[c + 1] = start[c] + r->size[c];
+    for (int v = 0; v < r->nodes; v++)
+        members[start[r->label[v]]++] = v;
+
+    for (int c = 0, i = 0; c < r->components; c++) {
+        for (int k = 0; k < r->size[c]; k++, i++)
+            printf(k ? " %s" : "%s", nt_name(names, members[i]));
+        printf("\n");
+    }
+
+    free(start);
+    free(members);
+}
+
+/*
+ * Cu argumentul "csr" sortarea se face pe reprezentarea CSR a grafului.
+ * Iesirea este aceeasi.
+ *
+ * Cu argumentul "dyn" ordinea este mentinuta de dyn_topo_t: muchiile citite
+ * sunt adaugate ca un singur lot cu dt_add_edges. Este tot o ordine
+ * topologica, dar nu neaparat aceeasi ca cea data de DFS. O muchie care ar
+ * inchide un ciclu este ignorata si ciclul este afisat la stderr.
+ *
+ * Cu argumentul "named" numele sunt interne cu named_graph.h (o singura
+ * tabela si o arena de string-uri, fara cele doua hashtable_t) si graful
+ * este construit direct in format CSR. Iesirea este aceeasi ca la "csr".
+ *
+ * Cu "scc" (Tarjan) sau "scc_par" (forward-backward, in paralel) graful
+ * poate avea cicluri: se afiseaza componentele tare conexe cu print_scc,
+ * deci materiile care depind circular unele de altele apar pe aceeasi linie.
+ */
+int main(int argc, char *argv[])
 {
     int n, m, subject_idx = 0;
 
+    if (argc > 1 && strcmp(argv[1], "named") == 0) {
+        name_table_t *names;
+        csr_graph_t *g = nb_load_text(STDIN_FILENO, 1, &names);
+        int *order = top_sort_csr(g);
+
+        for (int i = 0; i < g->nodes; i++)
+            printf("%s\n", nt_name(names, order[i]));
+
+        free(order);
+        nt_free(names);
+        csr_free(g);
+        return 0;
+    }
+
+    if (argc > 1 && strncmp(argv[1], "scc", 3) == 0) {
+        name_table_t *names;
+        csr_graph_t *g = nb_load_text(STDIN_FILENO, 1, &names);
+        scc_result_t *r;
+
+        if (strcmp(argv[1], "scc_par") == 0) {
+            thread_pool_t *tp = tp_create(0);
+            r = scc_fw_bw(tp, g);
+            tp_free(tp);
+        } else {
+            r = scc_tarjan(g);
+        }
+        print_scc(r, names);
+
+        scc_result_free(r);
+        nt_free(names);
+        csr_free(g);
+        return 0;
+    }
+
 	char src[MAX_STRING_SIZE], dest[MAX_STRING_SIZE];
     list_graph_t* graph;
 	hashtable_t* ht = ht_create(HMAX, hash_function_string, compare_function_strings);
@@ -205,6 +360,10 @@ int main()
 
     graph = lg_create(n);
 
+    int dynamic = argc > 1 && strcmp(argv[1], "dyn") == 0;
+    int *batch = dynamic ? malloc((m ? m : 1) * 2 * sizeof(int)) : NULL;
+    DIE(dynamic && !batch, "malloc() failed\n");
+
     for(int i = 0; i < m; ++i) {
         scanf("%s %s\n", src, dest);
 
@@ -222,17 +381,44 @@ int main()
 		}
 
 		// Use ids as nodes in the graph
-        lg_add_edge(graph, *((int*)ht_get(ht, src)), *((int*)ht_get(ht, dest)));
+        int u = *((int*)ht_get(ht, src)), v = *((int*)ht_get(ht, dest));
+        lg_add_edge(graph, u, v);
+
+        if (dynamic) {
+            batch[2 * i] = u;
+            batch[2 * i + 1] = v;
+        }
     }
 
-    linked_list_t* sorted = top_sort(graph);
-	for(ll_node_t* head = sorted->head; head; head = head->next)
-		printf("%s\n", (char*) ht_get(ht_reverse, (int*)head->data));
+    if (dynamic) {
+        dyn_topo_t *dt = dt_create(n);
+        reject_ctx_t ctx = { ht_reverse, batch };
+
+        dt_add_edges(dt, batch, m, print_rejected, &ctx);
+
+        for (int i = 0; i < n; i++) {
+            int node = dt_node_at(dt, i);
+            printf("%s\n", (char*) ht_get(ht_reverse, &node));
+        }
+        dt_free(dt);
+        free(batch);
+    } else if (argc > 1 && strcmp(argv[1], "csr") == 0) {
+        csr_graph_t *g = lg_to_csr(graph);
+        int *order = top_sort_csr(g);
+        for (int i = 0; i < g->nodes; i++)
+            printf("%s\n", (char*) ht_get(ht_reverse, &order[i]));
+        free(order);
+        csr_free(g);
+    } else {
+        linked_list_t* sorted = top_sort(graph);
+        for(ll_node_t* head = sorted->head; head; head = head->next)
+            printf("%s\n", (char*) ht_get(ht_reverse, (int*)head->data));
+        ll_free(&sorted);
+    }
 
     ht_free(ht);
 	ht_free(ht_reverse);
 	lg_free(graph);
-	ll_free(&sorted);
 	
     return 0;
 }
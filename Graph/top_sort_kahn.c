@@ -6,6 +6,9 @@
 #define MAX_STRING_SIZE 64
 #define MIN(x, y) ((x) < (y) ? (x) : (y))
 
+#include "csr_graph.h"
+#include "topo_parallel.h"
+#include "graph_loader.h"
 
 typedef struct ll_node_t ll_node_t;
 struct ll_node_t
@@ -395,9 +398,151 @@ linked_list_t* top_sort(list_graph_t* graph) {
 }
 
 
-int main()
+/*
+ * Construieste reprezentarea CSR a grafului. Vecinii fiecarui nod raman in
+ * ordinea din lista de adiacenta.
+ */
+csr_graph_t* lg_to_csr(list_graph_t* lg)
+{
+	long edges = 0;
+
+	for (int i = 0; i < lg->nodes; i++)
+		edges += lg->neighbors[i]->size;
+
+	csr_graph_t* g = csr_alloc(lg->nodes, edges, 0);
+	for (int i = 0; i < lg->nodes; i++) {
+		long e = g->offsets[i];
+		g->offsets[i + 1] = e + lg->neighbors[i]->size;
+		for (ll_node_t* it = lg->neighbors[i]->head; it; it = it->next)
+			g->targets[e++] = *(int *)it->data;
+	}
+
+	return g;
+}
+
+/*
+ * Algoritmul lui Kahn pe un graf CSR. Gradele interioare se calculeaza
+ * dintr-o singura trecere prin targets[], iar coada este un vector de
+ * g->nodes elemente (fiecare nod intra in coada o singura data). Intoarce
+ * numarul de noduri scrise in order; daca este mai mic decat g->nodes,
+ * graful are un ciclu.
+ */
+int
+top_sort_csr(csr_graph_t* g, int *order)
+{
+	int *in_degree = calloc(g->nodes, sizeof(int));
+	DIE(!in_degree, "calloc() failed\n");
+
+	for (long e = 0; e < g->edges; e++)
+		in_degree[g->targets[e]]++;
+
+	/* order[] este chiar coada: [head, tail) sunt nodurile neprocesate */
+	int head = 0, tail = 0;
+	for (int i = 0; i < g->nodes; i++)
+		if (!in_degree[i])
+			order[tail++] = i;
+
+	while (head < tail) {
+		int x = order[head++];
+		const int *neigh = csr_neighbors(g, x);
+
+		for (long i = 0, deg = csr_degree(g, x); i < deg; i++)
+			if (--in_degree[neigh[i]] == 0)
+				order[tail++] = neigh[i];
+	}
+
+	free(in_degree);
+	return tail;
+}
+
+/*
+ * Afiseaza rezultatul lui topo_sort_parallel: cate un val pe linie, cu
+ * nodurile lui in ordine crescatoare (ordinea din order nu este fixa).
+ */
+static int cmp_int(const void *a, const void *b)
+{
+	return (*(const int *)a > *(const int *)b) - (*(const int *)a < *(const int *)b);
+}
+
+void print_waves(topo_result_t *r)
+{
+	if (r->sorted != r->nodes) {
+		printf("There is a cycle in the graph\n");
+		return;
+	}
+
+	for (int w = 0; w < r->waves; w++) {
+		int *wave = r->order + r->wave_start[w];
+		int size = r->wave_start[w + 1] - r->wave_start[w];
+
+		qsort(wave, size, sizeof(int), cmp_int);
+		printf("%d:", w);
+		for (int i = 0; i < size; i++)
+			printf(" %d", wave[i]);
+		printf("\n");
+	}
+}
+
+/*
+ * Citeste "n m" si m muchii "u v" (noduri de la 0) de la intrarea standard
+ * si le sorteaza pe valuri, in paralel.
+ */
+void run_waves_stdin(void)
+{
+	int n, src, dest;
+	long m;
+
+	DIE(scanf("%d%ld", &n, &m) != 2, "missing graph header\n");
+	csr_builder_t *b = csr_builder_create(n, 0);
+	for (long i = 0; i < m; i++) {
+		DIE(scanf("%d%d", &src, &dest) != 2, "missing edge\n");
+		csr_builder_add(b, src, dest, 0);
+	}
+	csr_graph_t *g = csr_builder_finish(b);
+
+	thread_pool_t *tp = tp_create(0);
+	topo_result_t *r = topo_sort_parallel(tp, g);
+	print_waves(r);
+
+	topo_result_free(r);
+	tp_free(tp);
+	csr_free(g);
+}
+
+/* Ca run_waves_stdin, pentru un graf incarcat cu gl_load (text sau binar) */
+void run_waves_file(const char *path)
+{
+	thread_pool_t *tp = tp_create(0);
+	csr_graph_t *g = gl_load(path, GL_HEADER, tp);
+	topo_result_t *r = topo_sort_parallel(tp, g);
+	print_waves(r);
+
+	topo_result_free(r);
+	tp_free(tp);
+	csr_free(g);
+}
+
+/*
+ * Cu argumentul "csr" sortarea se face cu top_sort_csr. Cu "par" se afiseaza
+ * valurile calculate de topo_sort_parallel (nodurile din acelasi val pot fi
+ * executate simultan), iar cu "waves" la fel, pentru un graf citit de la
+ * intrarea standard; "file <cale>" citeste graful din fisier.
+ */
+int main(int argc, char *argv[])
 {
 	list_graph_t *lg = NULL;
+
+    if (argc > 1 && strcmp(argv[1], "waves") == 0) {
+        run_waves_stdin();
+        return 0;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "file") == 0) {
+        DIE(argc < 3, "usage: top_sort_kahn file <path>\n");
+        run_waves_file(argv[2]);
+        return 0;
+    }
+
     lg = lg_create(6);
     lg_add_edge(lg, 5, 2);
     lg_add_edge(lg, 5, 0);
@@ -410,11 +555,38 @@ int main()
     lg_print_graph(lg);
 
     printf("graful sortat topologic: ");
-    linked_list_t* sorted = top_sort(lg);
-    if (sorted)
-        ll_print_int(sorted);
+    if (argc > 1 && strcmp(argv[1], "par") == 0) {
+        csr_graph_t *g = lg_to_csr(lg);
+        topo_result_t *r = topo_sort_parallel(NULL, g);
+
+        printf("\n");
+        print_waves(r);
+
+        topo_result_free(r);
+        csr_free(g);
+    } else if (argc > 1 && strcmp(argv[1], "csr") == 0) {
+        csr_graph_t *g = lg_to_csr(lg);
+        int *order = malloc(g->nodes * sizeof(int));
+        DIE(!order, "malloc() failed\n");
+
+        int ct = top_sort_csr(g, order);
+        if (ct != g->nodes) {
+            printf("There is a cycle in the graph\n");
+        } else {
+            for (int i = 0; i < ct; i++)
+                printf("%d ", order[i]);
+            printf("\n");
+        }
+
+        free(order);
+        csr_free(g);
+    } else {
+        linked_list_t* sorted = top_sort(lg);
+        if (sorted)
+            ll_print_int(sorted);
 
-    ll_free(&sorted);
+        ll_free(&sorted);
+    }
 	lg_free(lg);
 
 
@@ -0,0 +1,222 @@
+#include "topo_parallel.h"
+
+/* Nodurile gata de executie se strang local si se copiaza in order pe bucati */
+#define TOPO_LOCAL_BUF 256
+/* Cate noduri primeste cel putin un task; valurile mai mici nu sunt
+ * impartite pe thread-uri */
+#define TOPO_GRAIN 2048
+/* Cu cate noduri / muchii inainte se cer datele din memorie */
+#define TOPO_PREFETCH 16
+
+typedef struct topo_state_t topo_state_t;
+struct topo_state_t
+{
+	const csr_graph_t *g;
+	atomic_int *in_degree;
+	int *order;
+	int *level;
+	/* Valul care se proceseaza si sfarsitul valului urmator in order */
+	int wave;
+	atomic_int tail;
+	/* 1 cand intervalul este procesat doar de apelant: gradele se pot
+	 * modifica fara instructiuni atomice (read-modify-write), care pe x86
+	 * ordoneaza accesele la memorie si nu lasa mai multe miss-uri de cache
+	 * sa fie asteptate in acelasi timp */
+	int serial;
+};
+
+/* Ruleaza body pe [lo, hi), in paralel doar daca intervalul merita */
+static void
+run_range(thread_pool_t *tp, long lo, long hi, tp_range_fn body,
+		  topo_state_t *s)
+{
+	s->serial = !tp || tp_get_threads(tp) == 1 || hi - lo <= TOPO_GRAIN;
+
+	if (s->serial)
+		body(s, lo, hi);
+	else
+		tp_parallel_for(tp, lo, hi, TOPO_GRAIN, body, s);
+}
+
+/* Scade gradul interior al lui v si intoarce valoarea dinainte */
+static inline int
+dec_in_degree(topo_state_t *s, int v)
+{
+	if (!s->serial)
+		return atomic_fetch_sub_explicit(&s->in_degree[v], 1,
+										 memory_order_relaxed);
+
+	int d = atomic_load_explicit(&s->in_degree[v], memory_order_relaxed);
+	atomic_store_explicit(&s->in_degree[v], d - 1, memory_order_relaxed);
+	return d;
+}
+
+static void
+flush_local(topo_state_t *s, const int *buf, int n)
+{
+	if (!n)
+		return;
+
+	int pos = atomic_fetch_add_explicit(&s->tail, n, memory_order_relaxed);
+	memcpy(s->order + pos, buf, n * sizeof(int));
+}
+
+static void
+in_degree_range(void *arg, long lo, long hi)
+{
+	topo_state_t *s = arg;
+	const int *targets = s->g->targets;
+	long end = s->g->offsets[hi];
+
+	for (long e = s->g->offsets[lo]; e < end; e++) {
+		int v = targets[e];
+
+		if (e + TOPO_PREFETCH < end)
+			__builtin_prefetch(&s->in_degree[targets[e + TOPO_PREFETCH]], 1);
+
+		if (s->serial)
+			atomic_store_explicit(&s->in_degree[v],
+								  atomic_load_explicit(&s->in_degree[v],
+													   memory_order_relaxed) + 1,
+								  memory_order_relaxed);
+		else
+			atomic_fetch_add_explicit(&s->in_degree[v], 1,
+									  memory_order_relaxed);
+	}
+}
+
+/* Valul 0: nodurile din [lo, hi) fara muchii de intrare */
+static void
+sources_range(void *arg, long lo, long hi)
+{
+	topo_state_t *s = arg;
+	int buf[TOPO_LOCAL_BUF];
+	int n = 0;
+
+	for (long v = lo; v < hi; v++) {
+		s->level[v] = -1;
+		if (atomic_load_explicit(&s->in_degree[v], memory_order_relaxed))
+			continue;
+
+		s->level[v] = 0;
+		buf[n++] = (int)v;
+		if (n == TOPO_LOCAL_BUF) {
+			flush_local(s, buf, n);
+			n = 0;
+		}
+	}
+
+	flush_local(s, buf, n);
+}
+
+/*
+ * Nodurile order[lo, hi) din valul curent scad gradele vecinilor. Doar un
+ * thread poate vedea gradul unui nod trecand din 1 in 0, deci fiecare nod
+ * este adaugat o singura data.
+ */
+static void
+wave_range(void *arg, long lo, long hi)
+{
+	topo_state_t *s = arg;
+	const long *offsets = s->g->offsets;
+	const int *targets = s->g->targets;
+	int buf[TOPO_LOCAL_BUF];
+	int n = 0;
+
+	for (long i = lo; i < hi; i++) {
+		int u = s->order[i];
+
+		/* Nodurile din val sunt imprastiate prin graf, deci fiecare nivel de
+		 * indirectare (offsets, targets, in_degree) se cere din memorie cu
+		 * cateva noduri inainte, ca miss-urile sa se suprapuna. Se citesc doar
+		 * valori deja aduse de pasii anteriori; targets[offsets[x]] exista
+		 * numai daca x are vecini (altfel poate fi dupa sfarsitul lui targets) */
+		if (i + TOPO_PREFETCH < hi) {
+			const int *next = s->order + i;
+			int x = next[TOPO_PREFETCH / 4];
+
+			__builtin_prefetch(&offsets[next[TOPO_PREFETCH]]);
+			__builtin_prefetch(&targets[offsets[next[TOPO_PREFETCH / 2]]]);
+			if (offsets[x] < offsets[x + 1])
+				__builtin_prefetch(&s->in_degree[targets[offsets[x]]], 1);
+		}
+
+		for (long e = offsets[u]; e < offsets[u + 1]; e++) {
+			int v = targets[e];
+
+			if (dec_in_degree(s, v) != 1)
+				continue;
+
+			s->level[v] = s->wave + 1;
+			buf[n++] = v;
+			if (n == TOPO_LOCAL_BUF) {
+				flush_local(s, buf, n);
+				n = 0;
+			}
+		}
+	}
+
+	flush_local(s, buf, n);
+}
+
+/*
+ * Sorteaza topologic graful orientat g. tp poate fi NULL; atunci totul
+ * ruleaza pe thread-ul apelant.
+ */
+topo_result_t *
+topo_sort_parallel(thread_pool_t *tp, const csr_graph_t *g)
+{
+	int n = g->nodes;
+	topo_result_t *r = malloc(sizeof(*r));
+	DIE(!r, "malloc() failed\n");
+
+	r->nodes = n;
+	r->order = malloc((n ? n : 1) * sizeof(int));
+	r->level = malloc((n ? n : 1) * sizeof(int));
+	r->wave_start = malloc((n + 1) * sizeof(int));
+	DIE(!r->order || !r->level || !r->wave_start, "malloc() failed\n");
+
+	topo_state_t s = {
+		.g = g,
+		.in_degree = calloc(n ? n : 1, sizeof(atomic_int)),
+		.order = r->order,
+		.level = r->level,
+		.wave = 0,
+	};
+	DIE(!s.in_degree, "calloc() failed\n");
+	atomic_init(&s.tail, 0);
+
+	run_range(tp, 0, n, in_degree_range, &s);
+	run_range(tp, 0, n, sources_range, &s);
+
+	/* order[head, end) este valul curent; valul urmator se scrie dupa el */
+	int head = 0, end = atomic_load(&s.tail);
+
+	r->waves = 0;
+	while (head < end) {
+		r->wave_start[r->waves++] = head;
+		s.wave = r->waves - 1;
+
+		run_range(tp, head, end, wave_range, &s);
+
+		head = end;
+		end = atomic_load(&s.tail);
+	}
+	r->wave_start[r->waves] = end;
+	r->sorted = end;
+
+	free(s.in_degree);
+	return r;
+}
+
+void
+topo_result_free(topo_result_t *r)
+{
+	if (!r)
+		return;
+
+	free(r->order);
+	free(r->level);
+	free(r->wave_start);
+	free(r);
+}
@@ -0,0 +1,49 @@
+#ifndef TOPO_PARALLEL_H
+#define TOPO_PARALLEL_H
+
+#include <stdatomic.h>
+
+#include "csr_graph.h"
+#include "thread_pool.h"
+
+/*
+ * Algoritmul lui Kahn pe valuri (level-synchronous), in paralel.
+ *
+ * Valul 0 contine nodurile fara muchii de intrare, iar valul w + 1 nodurile
+ * ale caror ultime muchii de intrare vin din valul w; nodurile din acelasi
+ * val nu depind unele de altele, deci pot fi executate simultan. Valul unui
+ * nod este lungimea celui mai lung drum care se termina in el.
+ *
+ * Gradele interioare sunt contoare atomice: fiecare nod din valul curent
+ * scade gradele vecinilor lui, iar thread-ul care aduce un grad la 0 adauga
+ * nodul in valul urmator. Valurile se impart pe thread-urile unui
+ * thread_pool_t; cele mici sunt procesate direct de apelant.
+ *
+ * Valurile si level[] nu depind de numarul de thread-uri; ordinea nodurilor
+ * in interiorul unui val poate sa difere de la o rulare la alta.
+ */
+
+typedef struct topo_result_t topo_result_t;
+struct topo_result_t
+{
+	int nodes;
+	/* Cate noduri au fost sortate; mai putine decat nodes inseamna ca
+	 * graful are un ciclu */
+	int sorted;
+	/* Nodurile sortate, grupate pe valuri: valul w este
+	 * order[wave_start[w] .. wave_start[w + 1] - 1] */
+	int *order;
+	int waves;
+	int *wave_start;
+	/* level[v] = valul nodului v, -1 daca v este pe un ciclu sau accesibil
+	 * dintr-un ciclu */
+	int *level;
+};
+
+topo_result_t *
+topo_sort_parallel(thread_pool_t *tp, const csr_graph_t *g);
+
+void
+topo_result_free(topo_result_t *r);
+
+#endif
@@ -0,0 +1,508 @@
+#include <unistd.h>
+#include <limits.h>
+
+#include "union_find.h"
+
+/* Cate muchii se citesc inainte sa fie trimise pool-ului */
+#define CC_BATCH_EDGES (1 << 20)
+/* Cate muchii reuneste cel putin un task */
+#define CC_GRAIN 4096
+#define CC_READ_SIZE (1 << 20)
+
+/* --- union-find pentru un singur thread --- */
+
+uf_t *
+uf_create(int nodes)
+{
+	uf_t *uf = malloc(sizeof(*uf));
+	DIE(!uf, "malloc() failed\n");
+
+	uf->nodes = nodes;
+	uf->components = nodes;
+	uf->parent = malloc((nodes ? nodes : 1) * sizeof(int));
+	uf->rank = calloc(nodes ? nodes : 1, sizeof(unsigned char));
+	DIE(!uf->parent || !uf->rank, "malloc() failed\n");
+
+	for (int i = 0; i < nodes; i++)
+		uf->parent[i] = i;
+
+	return uf;
+}
+
+/*
+ * Radacina multimii lui v. Toate nodurile de pe drum sunt legate apoi direct
+ * de radacina (comprimarea drumului), iterativ, fara recursivitate.
+ */
+int
+uf_find(uf_t *uf, int v)
+{
+	int root = v;
+
+	while (uf->parent[root] != root)
+		root = uf->parent[root];
+
+	while (uf->parent[v] != root) {
+		int next = uf->parent[v];
+		uf->parent[v] = root;
+		v = next;
+	}
+
+	return root;
+}
+
+/*
+ * Reuneste multimile lui u si v; radacina cu rangul mai mic devine fiul
+ * celeilalte. Intoarce 1 daca multimile erau diferite, 0 altfel.
+ */
+int
+uf_union(uf_t *uf, int u, int v)
+{
+	u = uf_find(uf, u);
+	v = uf_find(uf, v);
+
+	if (u == v)
+		return 0;
+
+	if (uf->rank[u] < uf->rank[v]) {
+		int tmp = u;
+		u = v;
+		v = tmp;
+	}
+
+	uf->parent[v] = u;
+	if (uf->rank[u] == uf->rank[v])
+		uf->rank[u]++;
+	uf->components--;
+
+	return 1;
+}
+
+/*
+ * Reuneste count muchii date ca perechi (u, v) in edges; perechile cu un
+ * capat in afara [0, nodes) sunt ignorate. Intoarce cate reuniuni au unit
+ * multimi diferite, adica cu cat a scazut numarul de componente.
+ */
+int
+uf_union_batch(uf_t *uf, const int *edges, long count)
+{
+	int merged = 0;
+
+	for (long e = 0; e < count; e++) {
+		int u = edges[2 * e], v = edges[2 * e + 1];
+
+		if (u >= 0 && u < uf->nodes && v >= 0 && v < uf->nodes)
+			merged += uf_union(uf, u, v);
+	}
+
+	return merged;
+}
+
+void
+uf_free(uf_t *uf)
+{
+	if (!uf)
+		return;
+
+	free(uf->parent);
+	free(uf->rank);
+	free(uf);
+}
+
+/* --- union-find concurent --- */
+
+cuf_t *
+cuf_create(int nodes)
+{
+	cuf_t *uf = malloc(sizeof(*uf));
+	DIE(!uf, "malloc() failed\n");
+
+	uf->nodes = nodes;
+	uf->parent = malloc((nodes ? nodes : 1) * sizeof(atomic_int));
+	DIE(!uf->parent, "malloc() failed\n");
+
+	for (int i = 0; i < nodes; i++)
+		atomic_init(&uf->parent[i], i);
+
+	return uf;
+}
+
+/*
+ * Radacina multimii lui v. parent[x] <= x pentru orice x, iar fiecare nod de
+ * pe drum este mutat sub bunicul lui (path halving); un CAS esuat inseamna
+ * doar ca alt thread a scurtat deja drumul.
+ */
+int
+cuf_find(cuf_t *uf, int v)
+{
+	for (;;) {
+		int p = atomic_load_explicit(&uf->parent[v], memory_order_acquire);
+		if (p == v)
+			return v;
+
+		int gp = atomic_load_explicit(&uf->parent[p], memory_order_acquire);
+		if (gp != p)
+			atomic_compare_exchange_weak_explicit(&uf->parent[v], &p, gp,
+												  memory_order_release,
+												  memory_order_relaxed);
+		v = gp;
+	}
+}
+
+/*
+ * Reuneste multimile lui u si v. Radacina cu indicele mai mare este legata
+ * de cealalta doar daca este inca radacina (CAS); altfel alt thread a
+ * schimbat-o intre timp si se reincearca. Intoarce 1 daca apelul a unit doua
+ * multimi diferite.
+ */
+int
+cuf_union(cuf_t *uf, int u, int v)
+{
+	for (;;) {
+		u = cuf_find(uf, u);
+		v = cuf_find(uf, v);
+
+		if (u == v)
+			return 0;
+
+		if (u < v) {
+			int tmp = u;
+			u = v;
+			v = tmp;
+		}
+
+		int expected = u;
+		if (atomic_compare_exchange_strong_explicit(&uf->parent[u], &expected,
+													v, memory_order_acq_rel,
+													memory_order_acquire))
+			return 1;
+	}
+}
+
+void
+cuf_free(cuf_t *uf)
+{
+	if (!uf)
+		return;
+
+	free(uf->parent);
+	free(uf);
+}
+
+/* --- componente conexe --- */
+
+static cc_result_t *
+cc_alloc(int nodes)
+{
+	cc_result_t *cc = malloc(sizeof(*cc));
+	DIE(!cc, "malloc() failed\n");
+
+	cc->nodes = nodes;
+	cc->components = 0;
+	cc->label = malloc((nodes ? nodes : 1) * sizeof(int));
+	cc->size = calloc(nodes ? nodes : 1, sizeof(int));
+	DIE(!cc->label || !cc->size, "malloc() failed\n");
+
+	return cc;
+}
+
+/*
+ * Numeroteaza componentele in ordinea celui mai mic nod, pornind de la
+ * radacina root[v] a fiecarui nod. root poate fi chiar cc->label: root[v]
+ * este citit inainte ca label[v] sa fie scris.
+ */
+static void
+cc_label_roots(cc_result_t *cc, const int *root)
+{
+	int *root_label = malloc((cc->nodes ? cc->nodes : 1) * sizeof(int));
+	DIE(!root_label, "malloc() failed\n");
+
+	for (int v = 0; v < cc->nodes; v++)
+		root_label[v] = -1;
+
+	for (int v = 0; v < cc->nodes; v++) {
+		int r = root[v];
+
+		if (root_label[r] < 0)
+			root_label[r] = cc->components++;
+		cc->label[v] = root_label[r];
+		cc->size[cc->label[v]]++;
+	}
+
+	free(root_label);
+}
+
+/*
+ * Instantaneu al componentelor din uf: rezultatul este o copie, deci ramane
+ * neschimbat cand uf primeste muchii noi.
+ */
+cc_result_t *
+cc_from_uf(uf_t *uf)
+{
+	cc_result_t *cc = cc_alloc(uf->nodes);
+
+	for (int v = 0; v < uf->nodes; v++)
+		cc->label[v] = uf_find(uf, v);
+	cc_label_roots(cc, cc->label);
+
+	return cc;
+}
+
+/* Structura nu trebuie sa mai fie modificata de alte thread-uri */
+cc_result_t *
+cc_from_cuf(cuf_t *uf)
+{
+	cc_result_t *cc = cc_alloc(uf->nodes);
+
+	for (int v = 0; v < uf->nodes; v++)
+		cc->label[v] = cuf_find(uf, v);
+	cc_label_roots(cc, cc->label);
+
+	return cc;
+}
+
+/* Componentele unui graf CSR (muchiile sunt considerate neorientate) */
+cc_result_t *
+cc_from_csr(const csr_graph_t *g)
+{
+	uf_t *uf = uf_create(g->nodes);
+
+	for (int u = 0; u < g->nodes; u++)
+		for (long e = g->offsets[u]; e < g->offsets[u + 1]; e++)
+			uf_union(uf, u, g->targets[e]);
+
+	cc_result_t *cc = cc_from_uf(uf);
+	uf_free(uf);
+	return cc;
+}
+
+void
+cc_result_free(cc_result_t *cc)
+{
+	if (!cc)
+		return;
+
+	free(cc->label);
+	free(cc->size);
+	free(cc);
+}
+
+/* --- muchii citite dintr-un fisier --- */
+
+/*
+ * Muchiile se strang in doua buffere: cat timp pool-ul reuneste muchiile
+ * dintr-unul, thread-ul apelant il umple pe celalalt. Memoria folosita este
+ * O(noduri + CC_BATCH_EDGES), oricate muchii ar avea fisierul.
+ */
+typedef struct cc_batch_t cc_batch_t;
+struct cc_batch_t
+{
+	cuf_t *uf;
+	thread_pool_t *tp;
+	int *edges;         /* Perechi (u, v) */
+	long count;
+};
+
+typedef struct cc_stream_t cc_stream_t;
+struct cc_stream_t
+{
+	cuf_t *uf;
+	thread_pool_t *tp;
+	tp_group_t group;
+	cc_batch_t batch[2];
+	int cur;
+};
+
+static void
+union_range(void *arg, long lo, long hi)
+{
+	cc_batch_t *b = arg;
+
+	for (long e = lo; e < hi; e++)
+		cuf_union(b->uf, b->edges[2 * e], b->edges[2 * e + 1]);
+}
+
+static void
+batch_task(void *arg)
+{
+	cc_batch_t *b = arg;
+
+	tp_parallel_for(b->tp, 0, b->count, CC_GRAIN, union_range, b);
+}
+
+static void
+cs_init(cc_stream_t *cs, int nodes, thread_pool_t *tp)
+{
+	cs->uf = cuf_create(nodes);
+	cs->tp = tp;
+	cs->cur = 0;
+	tp_group_init(&cs->group);
+
+	for (int i = 0; i < 2; i++) {
+		cs->batch[i].uf = cs->uf;
+		cs->batch[i].tp = tp;
+		cs->batch[i].count = 0;
+		cs->batch[i].edges = malloc(2 * CC_BATCH_EDGES * sizeof(int));
+		DIE(!cs->batch[i].edges, "malloc() failed\n");
+	}
+}
+
+/* Trimite bufferul curent si trece la celalalt (dupa ce acesta s-a terminat) */
+static void
+cs_submit(cc_stream_t *cs)
+{
+	cc_batch_t *b = &cs->batch[cs->cur];
+
+	if (!cs->tp) {
+		union_range(b, 0, b->count);
+		b->count = 0;
+		return;
+	}
+
+	tp_group_wait(cs->tp, &cs->group);
+	if (b->count)
+		tp_spawn(cs->tp, &cs->group, batch_task, b);
+
+	cs->cur ^= 1;
+	cs->batch[cs->cur].count = 0;
+}
+
+static inline void
+cs_add(cc_stream_t *cs, int u, int v)
+{
+	cc_batch_t *b = &cs->batch[cs->cur];
+
+	DIE(u < 0 || u >= cs->uf->nodes || v < 0 || v >= cs->uf->nodes,
+		"edge endpoint out of range\n");
+
+	b->edges[2 * b->count] = u;
+	b->edges[2 * b->count + 1] = v;
+	if (++b->count == CC_BATCH_EDGES)
+		cs_submit(cs);
+}
+
+static cc_result_t *
+cs_finish(cc_stream_t *cs)
+{
+	cs_submit(cs);
+	if (cs->tp)
+		tp_group_wait(cs->tp, &cs->group);
+
+	cc_result_t *cc = cc_from_cuf(cs->uf);
+
+	cuf_free(cs->uf);
+	free(cs->batch[0].edges);
+	free(cs->batch[1].edges);
+
+	return cc;
+}
+
+static ssize_t
+read_full(int fd, char *buf, size_t len)
+{
+	size_t done = 0;
+
+	while (done < len) {
+		ssize_t n = read(fd, buf + done, len - done);
+		if (n < 0 && errno == EINTR)
+			continue;
+		DIE(n < 0, "read() failed\n");
+		if (n == 0)
+			break;
+		done += n;
+	}
+
+	return done;
+}
+
+/*
+ * Citeste din fd un graf in formatul din comp_conex.c ("n m", apoi m
+ * perechi "u v") si intoarce componentele lui, fara sa retina muchiile.
+ * Numerele sunt parsate direct din buffer; un numar poate fi rupt intre doua
+ * citiri. tp poate fi NULL.
+ */
+cc_result_t *
+cc_stream_text(int fd, thread_pool_t *tp)
+{
+	char *buf = malloc(CC_READ_SIZE + 1);
+	DIE(!buf, "malloc() failed\n");
+
+	long long header[2] = { 0, 0 }, edges = 0;
+	int have = 0, pair[2];
+	long long num = 0;
+	int in_number = 0;
+	cc_stream_t cs;
+	int eof = 0;
+
+	while (!eof) {
+		ssize_t n = read_full(fd, buf, CC_READ_SIZE);
+
+		/* La sfarsitul fisierului ultimul numar se termina la EOF */
+		eof = n < CC_READ_SIZE;
+		if (eof)
+			buf[n++] = '\n';
+
+		for (ssize_t i = 0; i < n; i++) {
+			char c = buf[i];
+
+			if (c >= '0' && c <= '9') {
+				num = num * 10 + (c - '0');
+				in_number = 1;
+				continue;
+			}
+			if (!in_number)
+				continue;
+			in_number = 0;
+
+			if (have < 2) {
+				header[have++] = num;
+				if (have == 2) {
+					DIE(header[0] > INT_MAX, "too many nodes\n");
+					cs_init(&cs, (int)header[0], tp);
+				}
+			} else if (edges < header[1]) {
+				pair[have++ - 2] = (int)(num > INT_MAX ? -1 : num);
+				if (have == 4) {
+					cs_add(&cs, pair[0], pair[1]);
+					edges++;
+					have = 2;
+				}
+			}
+			num = 0;
+		}
+	}
+
+	free(buf);
+	DIE(have < 2, "missing graph header\n");
+	return cs_finish(&cs);
+}
+
+/*
+ * Citeste din fd muchii binare: perechi de int32 (u, v) in ordinea octetilor
+ * masinii, pana la sfarsitul fisierului. tp poate fi NULL.
+ */
+cc_result_t *
+cc_stream_binary(int fd, int nodes, thread_pool_t *tp)
+{
+	cc_stream_t cs;
+
+	cs_init(&cs, nodes, tp);
+
+	for (;;) {
+		cc_batch_t *b = &cs.batch[cs.cur];
+		ssize_t n = read_full(fd, (char *)b->edges,
+							  2 * CC_BATCH_EDGES * sizeof(int));
+
+		DIE(n % (2 * sizeof(int)), "truncated edge file\n");
+		b->count = n / (2 * sizeof(int));
+
+		for (long e = 0; e < 2 * b->count; e++)
+			DIE(b->edges[e] < 0 || b->edges[e] >= nodes,
+				"edge endpoint out of range\n");
+
+		if (!b->count)
+			break;
+		cs_submit(&cs);
+	}
+
+	return cs_finish(&cs);
+}
@@ -0,0 +1,108 @@
+#ifndef UNION_FIND_H
+#define UNION_FIND_H
+
+#include <stdatomic.h>
+
+#include "csr_graph.h"
+#include "thread_pool.h"
+
+/*
+ * Paduri de multimi disjuncte (union-find) pentru componente conexe.
+ *
+ * uf_t este varianta pentru un singur thread: reuniune dupa rang si
+ * comprimarea drumului la find, deci fiecare operatie costa amortizat
+ * O(alpha(n)), practic constant.
+ *
+ * cuf_t poate fi folosita simultan din mai multe thread-uri, fara lock-uri.
+ * O radacina se leaga de alta cu un CAS pe parent[], iar legarea se face
+ * mereu de la indicele mai mare la cel mai mic, ca doua reuniuni simultane
+ * sa nu poata forma un ciclu. find scurteaza drumul (path halving) tot cu
+ * CAS-uri, care pot esua fara sa strice structura.
+ */
+
+typedef struct uf_t uf_t;
+struct uf_t
+{
+	int nodes;
+	int components;
+	int *parent;
+	unsigned char *rank;
+};
+
+typedef struct cuf_t cuf_t;
+struct cuf_t
+{
+	int nodes;
+	atomic_int *parent;
+};
+
+/* Componentele conexe: etichete 0 .. components - 1, in ordinea celui mai
+ * mic nod din fiecare componenta */
+typedef struct cc_result_t cc_result_t;
+struct cc_result_t
+{
+	int nodes;
+	int components;
+	int *label;         /* label[v] = componenta nodului v */
+	int *size;          /* size[c] = numarul de noduri din componenta c */
+};
+
+uf_t *
+uf_create(int nodes);
+
+int
+uf_find(uf_t *uf, int v);
+
+int
+uf_union(uf_t *uf, int u, int v);
+
+int
+uf_union_batch(uf_t *uf, const int *edges, long count);
+
+void
+uf_free(uf_t *uf);
+
+cuf_t *
+cuf_create(int nodes);
+
+int
+cuf_find(cuf_t *uf, int v);
+
+int
+cuf_union(cuf_t *uf, int u, int v);
+
+void
+cuf_free(cuf_t *uf);
+
+cc_result_t *
+cc_from_uf(uf_t *uf);
+
+cc_result_t *
+cc_from_cuf(cuf_t *uf);
+
+cc_result_t *
+cc_from_csr(const csr_graph_t *g);
+
+cc_result_t *
+cc_stream_text(int fd, thread_pool_t *tp);
+
+cc_result_t *
+cc_stream_binary(int fd, int nodes, thread_pool_t *tp);
+
+void
+cc_result_free(cc_result_t *cc);
+
+static inline int
+uf_connected(uf_t *uf, int u, int v)
+{
+	return uf_find(uf, u) == uf_find(uf, v);
+}
+
+/* Interogare pe un rezultat deja calculat: O(1), fara sa modifice nimic */
+static inline int
+cc_connected(const cc_result_t *cc, int u, int v)
+{
+	return cc->label[u] == cc->label[v];
+}
+
+#endif
@@ -0,0 +1,223 @@
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+#include "blocking_queue.h"
+
+/*
+ * Calculeaza momentul absolut (pe CLOCK_MONOTONIC) la care expira un timeout
+ * de timeout_ms milisecunde.
+ */
+static void
+deadline_after(struct timespec *deadline, int timeout_ms)
+{
+	clock_gettime(CLOCK_MONOTONIC, deadline);
+	deadline->tv_sec += timeout_ms / 1000;
+	deadline->tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+	if (deadline->tv_nsec >= 1000000000L) {
+		deadline->tv_sec++;
+		deadline->tv_nsec -= 1000000000L;
+	}
+}
+
+/*
+ * Asteapta pe cond cu lock-ul luat. Intoarce 0 daca a fost trezit si
+ * ETIMEDOUT daca a expirat timpul (imediat, pentru BQ_NO_WAIT).
+ */
+static int
+wait_on(pthread_cond_t *cond, pthread_mutex_t *lock, int timeout_ms,
+		const struct timespec *deadline)
+{
+	if (timeout_ms == BQ_NO_WAIT)
+		return ETIMEDOUT;
+
+	if (timeout_ms < 0)
+		return pthread_cond_wait(cond, lock);
+
+	return pthread_cond_timedwait(cond, lock, deadline);
+}
+
+static void
+notify_readable(blocking_queue_t *bq)
+{
+	uint64_t one = 1;
+
+	if (bq->event_fd >= 0)
+		DIE(write(bq->event_fd, &one, sizeof(one)) != sizeof(one),
+			"eventfd write failed\n");
+}
+
+static void
+notify_drained(blocking_queue_t *bq)
+{
+	uint64_t value;
+
+	/* Coada nu mai are elemente: fd-ul nu trebuie sa mai fie citibil */
+	if (bq->event_fd >= 0 && read(bq->event_fd, &value, sizeof(value)) < 0)
+		DIE(errno != EAGAIN, "eventfd read failed\n");
+}
+
+/*
+ * Creeaza o coada blocanta cu capacitatea cel putin capacity. Cu flag-ul
+ * BQ_EVENTFD se aloca si un eventfd, obtinut cu bq_get_fd.
+ */
+blocking_queue_t *
+bq_create(unsigned int data_size, unsigned int capacity, int flags)
+{
+	pthread_condattr_t attr;
+	blocking_queue_t *bq = calloc(1, sizeof(*bq));
+	DIE(!bq, "calloc() failed for blocking queue\n");
+
+	bq->q = rq_create(data_size, capacity, 0);
+	bq->event_fd = -1;
+
+	pthread_mutex_init(&bq->lock, NULL);
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&bq->not_empty, &attr);
+	pthread_cond_init(&bq->not_full, &attr);
+	pthread_condattr_destroy(&attr);
+
+	if (flags & BQ_EVENTFD) {
+		bq->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		DIE(bq->event_fd < 0, "eventfd() failed\n");
+	}
+
+	return bq;
+}
+
+/*
+ * Introduce un element, asteptand cel mult timeout_ms milisecunde sa se
+ * elibereze loc (BQ_WAIT_FOREVER = fara limita, BQ_NO_WAIT = deloc). Intoarce
+ * 1 in caz de succes si 0 la timeout sau daca coada a fost inchisa.
+ */
+int
+bq_enqueue(blocking_queue_t *bq, const void *new_data, int timeout_ms)
+{
+	struct timespec deadline;
+
+	if (timeout_ms > 0)
+		deadline_after(&deadline, timeout_ms);
+
+	pthread_mutex_lock(&bq->lock);
+
+	while (!bq->closed && bq->q->size == bq->q->capacity) {
+		bq->waiting_producers++;
+		int rc = wait_on(&bq->not_full, &bq->lock, timeout_ms, &deadline);
+		bq->waiting_producers--;
+		if (rc == ETIMEDOUT)
+			break;
+	}
+
+	if (bq->closed || bq->q->size == bq->q->capacity) {
+		pthread_mutex_unlock(&bq->lock);
+		return 0;
+	}
+
+	rq_enqueue(bq->q, new_data);
+	if (bq->q->size == 1)
+		notify_readable(bq);
+	if (bq->waiting_consumers)
+		pthread_cond_signal(&bq->not_empty);
+
+	pthread_mutex_unlock(&bq->lock);
+	return 1;
+}
+
+/*
+ * Scoate cel mult n elemente in out, asteptand cel mult timeout_ms
+ * milisecunde sa apara macar unul. Intoarce numarul de elemente scoase; 0
+ * inseamna timeout sau coada inchisa si golita.
+ */
+unsigned int
+bq_dequeue_n(blocking_queue_t *bq, void *out, unsigned int n, int timeout_ms)
+{
+	struct timespec deadline;
+
+	if (timeout_ms > 0)
+		deadline_after(&deadline, timeout_ms);
+
+	pthread_mutex_lock(&bq->lock);
+
+	while (!bq->closed && !bq->q->size) {
+		bq->waiting_consumers++;
+		int rc = wait_on(&bq->not_empty, &bq->lock, timeout_ms, &deadline);
+		bq->waiting_consumers--;
+		if (rc == ETIMEDOUT)
+			break;
+	}
+
+	n = rq_dequeue_n(bq->q, out, n);
+	if (n && !bq->q->size && !bq->closed)
+		notify_drained(bq);
+	if (n && bq->waiting_producers)
+		pthread_cond_broadcast(&bq->not_full);
+
+	pthread_mutex_unlock(&bq->lock);
+	return n;
+}
+
+/*
+ * Scoate primul element din coada si il copiaza in out. Intoarce 1 in caz de
+ * succes si 0 la timeout sau daca coada a fost inchisa si golita.
+ */
+int
+bq_dequeue(blocking_queue_t *bq, void *out, int timeout_ms)
+{
+	return bq_dequeue_n(bq, out, 1, timeout_ms) == 1;
+}
+
+unsigned int
+bq_get_size(blocking_queue_t *bq)
+{
+	pthread_mutex_lock(&bq->lock);
+	unsigned int size = bq->q->size;
+	pthread_mutex_unlock(&bq->lock);
+
+	return size;
+}
+
+/*
+ * Intoarce eventfd-ul cozii (citibil cat timp coada are elemente sau dupa
+ * inchiderea ei) sau -1 daca coada a fost creata fara BQ_EVENTFD. Fd-ul este
+ * doar pentru notificare: elementele se scot tot cu bq_dequeue/BQ_NO_WAIT.
+ */
+int
+bq_get_fd(blocking_queue_t *bq)
+{
+	return bq->event_fd;
+}
+
+/*
+ * Inchide coada: producatorii si consumatorii blocati sunt treziti, enqueue
+ * nu mai are efect, iar consumatorii pot goli elementele ramase.
+ */
+void
+bq_close(blocking_queue_t *bq)
+{
+	pthread_mutex_lock(&bq->lock);
+	bq->closed = 1;
+	notify_readable(bq);
+	pthread_cond_broadcast(&bq->not_empty);
+	pthread_cond_broadcast(&bq->not_full);
+	pthread_mutex_unlock(&bq->lock);
+}
+
+/*
+ * Elibereaza coada. Niciun thread nu trebuie sa mai astepte pe ea.
+ */
+void
+bq_free(blocking_queue_t *bq)
+{
+	if (!bq)
+		return;
+
+	if (bq->event_fd >= 0)
+		close(bq->event_fd);
+	pthread_cond_destroy(&bq->not_empty);
+	pthread_cond_destroy(&bq->not_full);
+	pthread_mutex_destroy(&bq->lock);
+	rq_free(bq->q);
+	free(bq);
+}
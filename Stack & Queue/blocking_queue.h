@@ -0,0 +1,65 @@
+#ifndef BLOCKING_QUEUE_H
+#define BLOCKING_QUEUE_H
+
+#include <pthread.h>
+
+#include "ring_queue.h"
+
+/* Flag pentru bq_create: coada expune un eventfd pentru epoll/poll */
+#define BQ_EVENTFD 1
+
+/* Valori pentru timeout_ms */
+#define BQ_NO_WAIT 0
+#define BQ_WAIT_FOREVER -1
+
+/*
+ * Coada marginita in care enqueue pe o coada plina si dequeue pe o coada
+ * goala asteapta (cu timeout optional) in loc sa intoarca imediat 0. Un thread
+ * blocat doarme pe o variabila de conditie, deci un stagiu de pipeline fara
+ * treaba nu consuma CPU.
+ *
+ * Optional, coada tine un eventfd care este citibil cat timp coada are
+ * elemente, ca un consumator sa o poata adauga intr-un epoll alaturi de alte
+ * surse de evenimente.
+ */
+typedef struct blocking_queue_t blocking_queue_t;
+struct blocking_queue_t
+{
+	ring_queue_t *q;
+	pthread_mutex_t lock;
+	pthread_cond_t not_empty;
+	pthread_cond_t not_full;
+	/* Numarul de thread-uri care asteapta pe fiecare conditie */
+	unsigned int waiting_consumers;
+	unsigned int waiting_producers;
+	/* 1 dupa bq_close: enqueue esueaza, dequeue goleste ce a ramas */
+	int closed;
+	/* eventfd-ul de notificare sau -1 */
+	int event_fd;
+};
+
+blocking_queue_t *
+bq_create(unsigned int data_size, unsigned int capacity, int flags);
+
+int
+bq_enqueue(blocking_queue_t *bq, const void *new_data, int timeout_ms);
+
+int
+bq_dequeue(blocking_queue_t *bq, void *out, int timeout_ms);
+
+unsigned int
+bq_dequeue_n(blocking_queue_t *bq, void *out, unsigned int n, int timeout_ms);
+
+unsigned int
+bq_get_size(blocking_queue_t *bq);
+
+int
+bq_get_fd(blocking_queue_t *bq);
+
+void
+bq_close(blocking_queue_t *bq);
+
+void
+bq_free(blocking_queue_t *bq);
+
+#endif
@@ -0,0 +1,137 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+
+#include "blocking_queue.h"
+
+/*
+ * Pipeline cu doua stagii: un producator trimite din cand in cand momentul
+ * la care a facut enqueue, iar consumatorul doarme pana primeste ceva si
+ * masoara cat a durat trezirea. Consumatorul asteapta fie direct in
+ * bq_dequeue, fie intr-un epoll pe eventfd-ul cozii.
+ *
+ * Utilizare: ./blocking_queue_demo [mesaje] [pauza_us]
+ */
+
+typedef struct {
+	blocking_queue_t *bq;
+	int messages;
+	int pause_us;
+} producer_arg_t;
+
+static long long
+now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void *
+producer(void *arg)
+{
+	producer_arg_t *pa = arg;
+
+	for (int i = 0; i < pa->messages; i++) {
+		usleep(pa->pause_us);
+		long long stamp = now_ns();
+		bq_enqueue(pa->bq, &stamp, BQ_WAIT_FOREVER);
+	}
+
+	bq_close(pa->bq);
+	return NULL;
+}
+
+static void
+report(const char *mode, long long total_ns, long long max_ns, int count)
+{
+	if (!count) {
+		printf("%s: no messages\n", mode);
+		return;
+	}
+
+	printf("%s: %d messages, avg wakeup %.1f us, max %.1f us\n", mode, count,
+		   total_ns / 1000.0 / count, max_ns / 1000.0);
+}
+
+static void
+run_blocking(int messages, int pause_us)
+{
+	producer_arg_t pa = { bq_create(sizeof(long long), 64, 0),
+						  messages, pause_us };
+	pthread_t tid;
+	long long stamp, total = 0, max = 0;
+	int count = 0;
+
+	pthread_create(&tid, NULL, producer, &pa);
+
+	while (bq_dequeue(pa.bq, &stamp, BQ_WAIT_FOREVER)) {
+		long long lat = now_ns() - stamp;
+		total += lat;
+		max = lat > max ? lat : max;
+		count++;
+	}
+
+	pthread_join(tid, NULL);
+	report("condvar", total, max, count);
+	bq_free(pa.bq);
+}
+
+static void
+run_epoll(int messages, int pause_us)
+{
+	producer_arg_t pa = { bq_create(sizeof(long long), 64, BQ_EVENTFD),
+						  messages, pause_us };
+	struct epoll_event ev = { .events = EPOLLIN }, ready;
+	pthread_t tid;
+	long long stamp, total = 0, max = 0;
+	int count = 0;
+
+	int epfd = epoll_create1(EPOLL_CLOEXEC);
+	DIE(epfd < 0, "epoll_create1() failed\n");
+	DIE(epoll_ctl(epfd, EPOLL_CTL_ADD, bq_get_fd(pa.bq), &ev) < 0,
+		"epoll_ctl() failed\n");
+
+	pthread_create(&tid, NULL, producer, &pa);
+
+	for (;;) {
+		int n = epoll_wait(epfd, &ready, 1, -1);
+		if (n < 0 && errno == EINTR)
+			continue;
+		DIE(n < 0, "epoll_wait() failed\n");
+
+		int got = 0;
+		while (bq_dequeue(pa.bq, &stamp, BQ_NO_WAIT)) {
+			long long lat = now_ns() - stamp;
+			total += lat;
+			max = lat > max ? lat : max;
+			count++;
+			got = 1;
+		}
+
+		/* Fd citibil dar coada goala: producatorul a inchis-o */
+		if (!got)
+			break;
+	}
+
+	pthread_join(tid, NULL);
+	report("epoll", total, max, count);
+	close(epfd);
+	bq_free(pa.bq);
+}
+
+int main(int argc, char *argv[])
+{
+	int messages = argc > 1 ? atoi(argv[1]) : 1000;
+	int pause_us = argc > 2 ? atoi(argv[2]) : 200;
+
+	run_blocking(messages, pause_us);
+	run_epoll(messages, pause_us);
+
+	return 0;
+}
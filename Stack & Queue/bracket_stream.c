@@ -0,0 +1,249 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "bracket_stream.h"
+
+#define DIE(assertion, call_description)				\
+	do {								\
+		if (assertion) {					\
+			fprintf(stderr, "(%s, %d): ",			\
+					__FILE__, __LINE__);		\
+			perror(call_description);			\
+			exit(errno);				        \
+		}							\
+	} while (0)
+
+#define BV_INITIAL_CAPACITY 64
+
+/* 0 = alt caracter, 1..3 = deschidere de tipul 0..2, 4..6 = inchidere */
+static const unsigned char bracket_code[256] = {
+	['('] = 1, ['['] = 2, ['{'] = 3,
+	[')'] = 4, [']'] = 5, ['}'] = 6,
+};
+
+/*
+ * Creeaza un validator. max_depth limiteaza adancimea de imbricare (si deci
+ * memoria folosita); 0 inseamna fara limita.
+ */
+bracket_validator_t *
+bv_create(size_t max_depth)
+{
+	bracket_validator_t *bv = calloc(1, sizeof(*bv));
+	DIE(!bv, "calloc() failed for bracket validator\n");
+
+	bv->max_depth = max_depth ? max_depth : (size_t)-1;
+	bv->capacity = BV_INITIAL_CAPACITY;
+	if (bv->capacity > bv->max_depth)
+		bv->capacity = bv->max_depth;
+	bv->stack = malloc(bv->capacity);
+	DIE(!bv->stack, "malloc() failed for bracket stack\n");
+
+	return bv;
+}
+
+static int
+fail(bracket_validator_t *bv, int error, size_t pos)
+{
+	bv->error = error;
+	bv->error_offset = bv->offset + pos;
+	return 0;
+}
+
+/*
+ * Proceseaza o paranteza (cod nenul din bracket_code) aflata la pozitia pos
+ * din bufferul curent. Intoarce 0 la prima eroare.
+ */
+static inline int
+step(bracket_validator_t *bv, unsigned char code, size_t pos)
+{
+	if (code <= 3) {
+		if (bv->depth == bv->capacity) {
+			if (bv->capacity == bv->max_depth)
+				return fail(bv, BV_TOO_DEEP, pos);
+
+			size_t new_capacity = bv->capacity * 2;
+			if (new_capacity > bv->max_depth)
+				new_capacity = bv->max_depth;
+			bv->stack = realloc(bv->stack, new_capacity);
+			DIE(!bv->stack, "realloc() failed for bracket stack\n");
+			bv->capacity = new_capacity;
+		}
+		bv->stack[bv->depth++] = code - 1;
+		return 1;
+	}
+
+	if (!bv->depth)
+		return fail(bv, BV_UNDERFLOW, pos);
+	if (bv->stack[--bv->depth] != code - 4)
+		return fail(bv, BV_MISMATCH, pos);
+
+	return 1;
+}
+
+static size_t
+feed_scalar(bracket_validator_t *bv, const unsigned char *p, size_t start,
+			size_t len)
+{
+	for (size_t i = start; i < len; i++) {
+		unsigned char code = bracket_code[p[i]];
+		if (code && !step(bv, code, i))
+			return i;
+	}
+
+	return len;
+}
+
+/*
+ * Parcurge bitii setati din mask (cate unul pentru fiecare paranteza din
+ * blocul care incepe la base).
+ */
+static inline int
+walk_mask(bracket_validator_t *bv, const unsigned char *p, size_t base,
+		  unsigned long long mask)
+{
+	while (mask) {
+		size_t i = base + __builtin_ctzll(mask);
+		mask &= mask - 1;
+		if (!step(bv, bracket_code[p[i]], i))
+			return 0;
+	}
+
+	return 1;
+}
+
+#if defined(__AVX2__)
+/*
+ * Clasifica cate 64 de octeti (doua registre de 32): cele sase comparatii dau
+ * o masca de paranteze, iar blocurile fara paranteze sunt sarite direct.
+ */
+static size_t
+feed_simd(bracket_validator_t *bv, const unsigned char *p, size_t len)
+{
+	const __m256i o1 = _mm256_set1_epi8('('), c1 = _mm256_set1_epi8(')');
+	const __m256i o2 = _mm256_set1_epi8('['), c2 = _mm256_set1_epi8(']');
+	const __m256i o3 = _mm256_set1_epi8('{'), c3 = _mm256_set1_epi8('}');
+	size_t i = 0;
+
+	for (; i + 64 <= len; i += 64) {
+		unsigned long long mask = 0;
+
+		for (int half = 0; half < 2; half++) {
+			__m256i v = _mm256_loadu_si256((const __m256i *)(p + i + 32 * half));
+			__m256i open = _mm256_or_si256(_mm256_or_si256(
+							_mm256_cmpeq_epi8(v, o1), _mm256_cmpeq_epi8(v, o2)),
+							_mm256_cmpeq_epi8(v, o3));
+			__m256i close = _mm256_or_si256(_mm256_or_si256(
+							_mm256_cmpeq_epi8(v, c1), _mm256_cmpeq_epi8(v, c2)),
+							_mm256_cmpeq_epi8(v, c3));
+			unsigned int m = _mm256_movemask_epi8(_mm256_or_si256(open, close));
+			mask |= (unsigned long long)m << (32 * half);
+		}
+
+		if (mask && !walk_mask(bv, p, i, mask))
+			return i;
+	}
+
+	return i;
+}
+#elif defined(__SSE2__)
+static size_t
+feed_simd(bracket_validator_t *bv, const unsigned char *p, size_t len)
+{
+	const __m128i o1 = _mm_set1_epi8('('), c1 = _mm_set1_epi8(')');
+	const __m128i o2 = _mm_set1_epi8('['), c2 = _mm_set1_epi8(']');
+	const __m128i o3 = _mm_set1_epi8('{'), c3 = _mm_set1_epi8('}');
+	size_t i = 0;
+
+	for (; i + 64 <= len; i += 64) {
+		unsigned long long mask = 0;
+
+		for (int q = 0; q < 4; q++) {
+			__m128i v = _mm_loadu_si128((const __m128i *)(p + i + 16 * q));
+			__m128i any = _mm_or_si128(
+				_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, o1),
+										  _mm_cmpeq_epi8(v, o2)),
+							 _mm_or_si128(_mm_cmpeq_epi8(v, o3),
+										  _mm_cmpeq_epi8(v, c1))),
+				_mm_or_si128(_mm_cmpeq_epi8(v, c2), _mm_cmpeq_epi8(v, c3)));
+			unsigned int m = _mm_movemask_epi8(any);
+			mask |= (unsigned long long)m << (16 * q);
+		}
+
+		if (mask && !walk_mask(bv, p, i, mask))
+			return i;
+	}
+
+	return i;
+}
+#else
+static size_t
+feed_simd(bracket_validator_t *bv, const unsigned char *p, size_t len)
+{
+	(void)bv;
+	(void)p;
+	(void)len;
+	return 0;
+}
+#endif
+
+/*
+ * Adauga urmatoarea bucata din flux. Intoarce 1 daca fluxul este corect pana
+ * aici si 0 daca a aparut o eroare (dupa care bucatile urmatoare sunt
+ * ignorate).
+ */
+int
+bv_feed(bracket_validator_t *bv, const char *buf, size_t len)
+{
+	const unsigned char *p = (const unsigned char *)buf;
+
+	if (bv->error)
+		return 0;
+
+	size_t done = feed_simd(bv, p, len);
+	if (!bv->error)
+		feed_scalar(bv, p, done, len);
+
+	bv->offset += len;
+	return !bv->error;
+}
+
+/*
+ * Marcheaza sfarsitul fluxului. Intoarce 1 daca toate parantezele au fost
+ * inchise corect si 0 altfel.
+ */
+int
+bv_finish(bracket_validator_t *bv)
+{
+	if (!bv->error && bv->depth)
+		fail(bv, BV_UNCLOSED, 0);
+
+	return !bv->error;
+}
+
+/*
+ * Pregateste validatorul pentru un flux nou, pastrand stiva alocata.
+ */
+void
+bv_reset(bracket_validator_t *bv)
+{
+	bv->depth = 0;
+	bv->offset = 0;
+	bv->error = BV_OK;
+	bv->error_offset = 0;
+}
+
+void
+bv_free(bracket_validator_t *bv)
+{
+	if (!bv)
+		return;
+
+	free(bv->stack);
+	free(bv);
+}
@@ -0,0 +1,52 @@
+#ifndef BRACKET_STREAM_H
+#define BRACKET_STREAM_H
+
+#include <stddef.h>
+
+/*
+ * Validator de paranteze pentru fluxuri primite pe bucati (de exemplu, cate un
+ * buffer de la fiecare read()). Ca is_valid() din paranteze.c, ia in seama
+ * doar caracterele ( ) [ ] { } si le ignora pe celelalte.
+ *
+ * Stiva tine, pentru fiecare paranteza deschisa, doar tipul ei (un octet),
+ * intr-un vector contiguu. Memoria folosita depinde doar de adancimea maxima
+ * de imbricare, nu de dimensiunea intrarii, si este limitata de max_depth.
+ */
+
+#define BV_OK 0
+#define BV_MISMATCH 1   /* inchidere care nu corespunde ultimei deschideri */
+#define BV_UNDERFLOW 2  /* inchidere fara deschidere */
+#define BV_TOO_DEEP 3   /* imbricare mai adanca decat max_depth */
+#define BV_UNCLOSED 4   /* paranteze ramase deschise la final */
+
+typedef struct bracket_validator_t bracket_validator_t;
+struct bracket_validator_t
+{
+	/* Tipul fiecarei paranteze deschise: 0 = (, 1 = [, 2 = { */
+	unsigned char *stack;
+	size_t depth;
+	size_t capacity;
+	size_t max_depth;
+	/* Numarul de octeti procesati pana acum */
+	unsigned long long offset;
+	/* Codul erorii si pozitia in flux la care a aparut */
+	int error;
+	unsigned long long error_offset;
+};
+
+bracket_validator_t *
+bv_create(size_t max_depth);
+
+int
+bv_feed(bracket_validator_t *bv, const char *buf, size_t len);
+
+int
+bv_finish(bracket_validator_t *bv);
+
+void
+bv_reset(bracket_validator_t *bv);
+
+void
+bv_free(bracket_validator_t *bv);
+
+#endif
@@ -0,0 +1,45 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include "stack_stream.h"
+
+#define CHUNK_SIZE (1 << 20)
+
+/*
+ * Varianta pentru fluxuri mari a lui duplicates_stack.c: citeste k si sirul
+ * de la intrarea standard, pe bucati, si scrie sirul ramas dupa eliminarea
+ * repetata a secventelor de k caractere identice alaturate.
+ */
+int main()
+{
+	static char buf[CHUNK_SIZE];
+	static out_buf_t out;
+	unsigned long long k;
+	size_t off, len;
+	ssize_t n;
+
+	if (!stream_read_k(STDIN_FILENO, &k, buf, sizeof(buf), &off, &len)) {
+		fprintf(stderr, "Expected k at the start of the input\n");
+		return 1;
+	}
+
+	ob_init(&out, STDOUT_FILENO);
+	rdup_stream_t *r = rdup_create(k, &out);
+	rdup_feed(r, buf + off, len);
+
+	while ((n = read(STDIN_FILENO, buf, sizeof(buf))) != 0) {
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n < 0) {
+			perror("read() failed");
+			break;
+		}
+		rdup_feed(r, buf, n);
+	}
+
+	rdup_finish(r);
+	rdup_free(r);
+	return 0;
+}
@@ -0,0 +1,219 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include "ring_queue.h"
+#include "lockfree_queue.h"
+
+/*
+ * Masoara debitul (milioane de elemente pe secunda) pentru o coada protejata
+ * de mutex, coada SPSC si coada MPMC, variind numarul de producatori si de
+ * consumatori. Rezultatul este afisat in format CSV.
+ *
+ * Utilizare: ./lockfree_bench [elemente] [max_threaduri] [batch]
+ */
+
+#define QUEUE_CAPACITY 4096
+
+enum { Q_MUTEX, Q_SPSC, Q_MPMC };
+
+typedef struct {
+	ring_queue_t *q;
+	pthread_mutex_t lock;
+} mutex_queue_t;
+
+typedef struct bench_t bench_t;
+struct bench_t {
+	int kind;
+	unsigned int batch;
+	unsigned long items_per_producer;
+	unsigned long total;
+	atomic_ulong consumed;
+	atomic_ulong checksum;
+	mutex_queue_t mq;
+	spsc_queue_t *spsc;
+	mpmc_queue_t *mpmc;
+};
+
+typedef struct {
+	bench_t *b;
+	unsigned long first;
+} producer_arg_t;
+
+static double
+now_sec(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static unsigned int
+bench_push(bench_t *b, const unsigned long *items, unsigned int n)
+{
+	unsigned int done;
+
+	switch (b->kind) {
+	case Q_MUTEX:
+		pthread_mutex_lock(&b->mq.lock);
+		done = rq_enqueue_n(b->mq.q, items, n);
+		pthread_mutex_unlock(&b->mq.lock);
+		return done;
+	case Q_SPSC:
+		return spsc_enqueue_n(b->spsc, items, n);
+	default:
+		return mpmc_enqueue_n(b->mpmc, items, n);
+	}
+}
+
+static unsigned int
+bench_pop(bench_t *b, unsigned long *items, unsigned int n)
+{
+	unsigned int done;
+
+	switch (b->kind) {
+	case Q_MUTEX:
+		pthread_mutex_lock(&b->mq.lock);
+		done = rq_dequeue_n(b->mq.q, items, n);
+		pthread_mutex_unlock(&b->mq.lock);
+		return done;
+	case Q_SPSC:
+		return spsc_dequeue_n(b->spsc, items, n);
+	default:
+		return mpmc_dequeue_n(b->mpmc, items, n);
+	}
+}
+
+static void *
+producer(void *arg)
+{
+	producer_arg_t *pa = arg;
+	bench_t *b = pa->b;
+	unsigned long items[b->batch];
+	unsigned long next = pa->first, end = pa->first + b->items_per_producer;
+
+	while (next < end) {
+		unsigned int n = 0;
+		while (n < b->batch && next + n < end) {
+			items[n] = next + n;
+			n++;
+		}
+
+		unsigned int pushed = 0;
+		while (pushed < n) {
+			unsigned int k = bench_push(b, items + pushed, n - pushed);
+			if (!k)
+				sched_yield();
+			pushed += k;
+		}
+		next += n;
+	}
+
+	return NULL;
+}
+
+static void *
+consumer(void *arg)
+{
+	bench_t *b = arg;
+	unsigned long items[b->batch];
+	unsigned long sum = 0;
+
+	while (atomic_load_explicit(&b->consumed, memory_order_relaxed)
+		   < b->total) {
+		unsigned int k = bench_pop(b, items, b->batch);
+		if (!k) {
+			sched_yield();
+			continue;
+		}
+		for (unsigned int i = 0; i < k; i++)
+			sum += items[i];
+		atomic_fetch_add_explicit(&b->consumed, k, memory_order_relaxed);
+	}
+
+	atomic_fetch_add(&b->checksum, sum);
+	return NULL;
+}
+
+static void
+run(int kind, const char *name, int producers, int consumers,
+	unsigned long items, unsigned int batch)
+{
+	bench_t b;
+	pthread_t threads[producers + consumers];
+	producer_arg_t pargs[producers];
+
+	memset(&b, 0, sizeof(b));
+	b.kind = kind;
+	b.batch = batch;
+	b.items_per_producer = items / producers;
+	b.total = b.items_per_producer * producers;
+	atomic_init(&b.consumed, 0);
+	atomic_init(&b.checksum, 0);
+
+	if (kind == Q_MUTEX) {
+		b.mq.q = rq_create(sizeof(unsigned long), QUEUE_CAPACITY, 0);
+		pthread_mutex_init(&b.mq.lock, NULL);
+	} else if (kind == Q_SPSC) {
+		b.spsc = spsc_create(sizeof(unsigned long), QUEUE_CAPACITY);
+	} else {
+		b.mpmc = mpmc_create(sizeof(unsigned long), QUEUE_CAPACITY);
+	}
+
+	double start = now_sec();
+
+	for (int i = 0; i < producers; i++) {
+		pargs[i].b = &b;
+		pargs[i].first = i * b.items_per_producer;
+		pthread_create(&threads[i], NULL, producer, &pargs[i]);
+	}
+	for (int i = 0; i < consumers; i++)
+		pthread_create(&threads[producers + i], NULL, consumer, &b);
+	for (int i = 0; i < producers + consumers; i++)
+		pthread_join(threads[i], NULL);
+
+	double elapsed = now_sec() - start;
+
+	unsigned long expected = b.total * (b.total - 1) / 2;
+	printf("%s,%d,%d,%u,%lu,%.4f,%.2f,%s\n", name, producers, consumers,
+		   batch, b.total, elapsed, b.total / elapsed / 1e6,
+		   atomic_load(&b.checksum) == expected ? "ok" : "BAD");
+
+	if (kind == Q_MUTEX) {
+		pthread_mutex_destroy(&b.mq.lock);
+		rq_free(b.mq.q);
+	} else if (kind == Q_SPSC) {
+		spsc_free(b.spsc);
+	} else {
+		mpmc_free(b.mpmc);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned long items = argc > 1 ? strtoul(argv[1], NULL, 10) : 10000000;
+	int max_threads = argc > 2 ? atoi(argv[2]) : 4;
+	unsigned int batch = argc > 3 ? strtoul(argv[3], NULL, 10) : 1;
+
+	if (max_threads < 1)
+		max_threads = 1;
+	if (!batch)
+		batch = 1;
+
+	printf("queue,producers,consumers,batch,items,seconds,mops,check\n");
+
+	run(Q_SPSC, "spsc", 1, 1, items, batch);
+
+	for (int p = 1; p <= max_threads; p *= 2)
+		for (int c = 1; c <= max_threads; c *= 2) {
+			run(Q_MUTEX, "mutex", p, c, items, batch);
+			run(Q_MPMC, "mpmc", p, c, items, batch);
+		}
+
+	return 0;
+}
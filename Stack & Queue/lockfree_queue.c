@@ -0,0 +1,348 @@
+#include "lockfree_queue.h"
+
+static unsigned int
+next_pow2(unsigned int n)
+{
+	unsigned int p = 1;
+
+	while (p < n) {
+		DIE(p > (~0u >> 1), "lock-free queue capacity overflow\n");
+		p <<= 1;
+	}
+
+	return p;
+}
+
+/* --- SPSC --- */
+
+/*
+ * Creeaza o coada SPSC cu capacitatea cel putin min_capacity, rotunjita la
+ * urmatoarea putere a lui 2.
+ */
+spsc_queue_t *
+spsc_create(unsigned int data_size, unsigned int min_capacity)
+{
+	spsc_queue_t *q = aligned_alloc(CACHE_LINE_SIZE, sizeof(*q));
+	DIE(!q, "aligned_alloc() failed for spsc queue\n");
+	memset(q, 0, sizeof(*q));
+
+	q->capacity = next_pow2(min_capacity);
+	q->mask = q->capacity - 1;
+	q->data_size = data_size;
+	q->buff = malloc((size_t)q->capacity * data_size);
+	DIE(!q->buff, "malloc() failed for spsc buffer\n");
+
+	atomic_init(&q->head, 0);
+	atomic_init(&q->tail, 0);
+
+	return q;
+}
+
+/*
+ * Apelata doar de producator. Intoarce 1 daca elementul a fost introdus si 0
+ * daca coada este plina.
+ */
+int
+spsc_enqueue(spsc_queue_t *q, const void *new_data)
+{
+	return spsc_enqueue_n(q, new_data, 1) == 1;
+}
+
+/*
+ * Apelata doar de producator. Introduce cat mai multe din cele n elemente si
+ * le publica pe toate cu o singura scriere a lui tail. Intoarce cate au
+ * incaput.
+ */
+unsigned int
+spsc_enqueue_n(spsc_queue_t *q, const void *data, unsigned int n)
+{
+	const char *src = data;
+	size_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+
+	if (q->capacity - (tail - q->cached_head) < n)
+		q->cached_head = atomic_load_explicit(&q->head,
+											  memory_order_acquire);
+
+	size_t free_slots = q->capacity - (tail - q->cached_head);
+	if (n > free_slots)
+		n = free_slots;
+	if (!n)
+		return 0;
+
+	unsigned int idx = tail & q->mask;
+	unsigned int first = q->capacity - idx;
+	if (first > n)
+		first = n;
+
+	memcpy(q->buff + (size_t)idx * q->data_size, src,
+		   (size_t)first * q->data_size);
+	memcpy(q->buff, src + (size_t)first * q->data_size,
+		   (size_t)(n - first) * q->data_size);
+
+	atomic_store_explicit(&q->tail, tail + n, memory_order_release);
+	return n;
+}
+
+/*
+ * Apelata doar de consumator. Intoarce un pointer spre primul element, fara
+ * sa il elimine, sau NULL daca coada este goala.
+ */
+void *
+spsc_front(spsc_queue_t *q)
+{
+	size_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+
+	if (head == q->cached_tail) {
+		q->cached_tail = atomic_load_explicit(&q->tail,
+											  memory_order_acquire);
+		if (head == q->cached_tail)
+			return NULL;
+	}
+
+	return q->buff + (size_t)(head & q->mask) * q->data_size;
+}
+
+/*
+ * Apelata doar de consumator. Intoarce 1 daca un element a fost eliminat si 0
+ * daca coada este goala.
+ */
+int
+spsc_dequeue(spsc_queue_t *q)
+{
+	return spsc_dequeue_n(q, NULL, 1) == 1;
+}
+
+/*
+ * Apelata doar de consumator. Scoate cel mult n elemente, copiindu-le in out
+ * daca acesta nu este NULL. Intoarce numarul de elemente scoase.
+ */
+unsigned int
+spsc_dequeue_n(spsc_queue_t *q, void *out, unsigned int n)
+{
+	char *dst = out;
+	size_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+
+	if (q->cached_tail - head < n)
+		q->cached_tail = atomic_load_explicit(&q->tail,
+											  memory_order_acquire);
+
+	size_t avail = q->cached_tail - head;
+	if (n > avail)
+		n = avail;
+	if (!n)
+		return 0;
+
+	if (dst) {
+		unsigned int idx = head & q->mask;
+		unsigned int first = q->capacity - idx;
+		if (first > n)
+			first = n;
+
+		memcpy(dst, q->buff + (size_t)idx * q->data_size,
+			   (size_t)first * q->data_size);
+		memcpy(dst + (size_t)first * q->data_size, q->buff,
+			   (size_t)(n - first) * q->data_size);
+	}
+
+	atomic_store_explicit(&q->head, head + n, memory_order_release);
+	return n;
+}
+
+/*
+ * Numarul de elemente din coada. Daca celalalt thread lucreaza in paralel,
+ * valoarea este doar o aproximare.
+ */
+unsigned int
+spsc_get_size(spsc_queue_t *q)
+{
+	size_t tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+	size_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+
+	return tail - head;
+}
+
+void
+spsc_free(spsc_queue_t *q)
+{
+	if (!q)
+		return;
+
+	free(q->buff);
+	free(q);
+}
+
+/* --- MPMC --- */
+
+static inline atomic_size_t *
+cell_seq(mpmc_queue_t *q, size_t pos)
+{
+	return (atomic_size_t *)(q->cells + (pos & q->mask) * q->cell_size);
+}
+
+static inline void *
+cell_data(mpmc_queue_t *q, size_t pos)
+{
+	return q->cells + (pos & q->mask) * q->cell_size + sizeof(atomic_size_t);
+}
+
+/*
+ * Creeaza o coada MPMC cu capacitatea cel putin min_capacity (minim 2),
+ * rotunjita la urmatoarea putere a lui 2.
+ */
+mpmc_queue_t *
+mpmc_create(unsigned int data_size, unsigned int min_capacity)
+{
+	mpmc_queue_t *q = aligned_alloc(CACHE_LINE_SIZE, sizeof(*q));
+	DIE(!q, "aligned_alloc() failed for mpmc queue\n");
+	memset(q, 0, sizeof(*q));
+
+	q->capacity = next_pow2(min_capacity < 2 ? 2 : min_capacity);
+	q->mask = q->capacity - 1;
+	q->data_size = data_size;
+
+	q->cell_size = sizeof(atomic_size_t) + data_size;
+	q->cell_size = (q->cell_size + _Alignof(atomic_size_t) - 1)
+				   & ~(size_t)(_Alignof(atomic_size_t) - 1);
+
+	q->cells = aligned_alloc(CACHE_LINE_SIZE,
+		((q->capacity * q->cell_size + CACHE_LINE_SIZE - 1)
+		 / CACHE_LINE_SIZE) * CACHE_LINE_SIZE);
+	DIE(!q->cells, "aligned_alloc() failed for mpmc cells\n");
+
+	for (size_t i = 0; i < q->capacity; i++)
+		atomic_init(cell_seq(q, i), i);
+
+	atomic_init(&q->enqueue_pos, 0);
+	atomic_init(&q->dequeue_pos, 0);
+
+	return q;
+}
+
+/*
+ * Rezerva cel mult n pozitii consecutive pentru producator. O pozitie pos este
+ * libera cand secventa celulei ei este pos. Intoarce numarul de pozitii
+ * rezervate, incepand de la *start.
+ */
+static unsigned int
+mpmc_claim(mpmc_queue_t *q, atomic_size_t *pos_var, size_t expect_off,
+		   unsigned int n, size_t *start)
+{
+	size_t pos = atomic_load_explicit(pos_var, memory_order_relaxed);
+
+	for (;;) {
+		unsigned int k = 0;
+
+		while (k < n) {
+			size_t seq = atomic_load_explicit(cell_seq(q, pos + k),
+											  memory_order_acquire);
+			if (seq != pos + k + expect_off)
+				break;
+			k++;
+		}
+
+		if (!k) {
+			size_t seq = atomic_load_explicit(cell_seq(q, pos),
+											  memory_order_acquire);
+			/* Celula inca apartine rundei anterioare: coada e plina/goala */
+			if ((ptrdiff_t)(seq - (pos + expect_off)) < 0)
+				return 0;
+			pos = atomic_load_explicit(pos_var, memory_order_relaxed);
+			continue;
+		}
+
+		if (atomic_compare_exchange_weak_explicit(pos_var, &pos, pos + k,
+												  memory_order_relaxed,
+												  memory_order_relaxed)) {
+			*start = pos;
+			return k;
+		}
+	}
+}
+
+/*
+ * Intoarce 1 daca elementul a fost introdus si 0 daca coada este plina.
+ */
+int
+mpmc_enqueue(mpmc_queue_t *q, const void *new_data)
+{
+	return mpmc_enqueue_n(q, new_data, 1) == 1;
+}
+
+/*
+ * Introduce cel mult n elemente consecutive rezervand toate pozitiile cu un
+ * singur CAS. Intoarce numarul de elemente introduse.
+ */
+unsigned int
+mpmc_enqueue_n(mpmc_queue_t *q, const void *data, unsigned int n)
+{
+	const char *src = data;
+	size_t start;
+
+	n = mpmc_claim(q, &q->enqueue_pos, 0, n, &start);
+
+	for (unsigned int i = 0; i < n; i++) {
+		memcpy(cell_data(q, start + i), src + (size_t)i * q->data_size,
+			   q->data_size);
+		atomic_store_explicit(cell_seq(q, start + i), start + i + 1,
+							  memory_order_release);
+	}
+
+	return n;
+}
+
+/*
+ * Echivalentul lui q_front urmat de q_dequeue: cu mai multi consumatori
+ * primul element nu poate fi citit separat de eliminarea lui, asa ca este
+ * copiat in out (daca out nu este NULL). Intoarce 1 in caz de succes si 0
+ * daca coada este goala.
+ */
+int
+mpmc_dequeue(mpmc_queue_t *q, void *out)
+{
+	return mpmc_dequeue_n(q, out, 1) == 1;
+}
+
+/*
+ * Scoate cel mult n elemente cu un singur CAS si le copiaza in out. Intoarce
+ * numarul de elemente scoase.
+ */
+unsigned int
+mpmc_dequeue_n(mpmc_queue_t *q, void *out, unsigned int n)
+{
+	char *dst = out;
+	size_t start;
+
+	n = mpmc_claim(q, &q->dequeue_pos, 1, n, &start);
+
+	for (unsigned int i = 0; i < n; i++) {
+		if (dst)
+			memcpy(dst + (size_t)i * q->data_size, cell_data(q, start + i),
+				   q->data_size);
+		atomic_store_explicit(cell_seq(q, start + i),
+							  start + i + q->capacity, memory_order_release);
+	}
+
+	return n;
+}
+
+/*
+ * Numarul aproximativ de elemente din coada.
+ */
+unsigned int
+mpmc_get_size(mpmc_queue_t *q)
+{
+	size_t enq = atomic_load_explicit(&q->enqueue_pos, memory_order_relaxed);
+	size_t deq = atomic_load_explicit(&q->dequeue_pos, memory_order_relaxed);
+
+	return (ptrdiff_t)(enq - deq) > 0 ? enq - deq : 0;
+}
+
+void
+mpmc_free(mpmc_queue_t *q)
+{
+	if (!q)
+		return;
+
+	free(q->cells);
+	free(q);
+}
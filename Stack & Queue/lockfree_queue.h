@@ -0,0 +1,121 @@
+#ifndef LOCKFREE_QUEUE_H
+#define LOCKFREE_QUEUE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <errno.h>
+
+#ifndef DIE
+#define DIE(assertion, call_description)				\
+	do {								\
+		if (assertion) {					\
+			fprintf(stderr, "(%s, %d): ",			\
+					__FILE__, __LINE__);		\
+			perror(call_description);			\
+			exit(errno);				        \
+		}							\
+	} while (0)
+#endif
+
+#define CACHE_LINE_SIZE 64
+
+/*
+ * Coada circulara pentru un singur producator si un singur consumator. Nu
+ * foloseste nici lock-uri, nici CAS: fiecare capat este scris de un singur
+ * thread. head si tail stau pe linii de cache separate, iar fiecare parte
+ * tine o copie locala a indexului celeilalte ca sa nu il citeasca la fiecare
+ * operatie.
+ */
+typedef struct spsc_queue_t spsc_queue_t;
+struct spsc_queue_t
+{
+	/* Capacitatea cozii (putere a lui 2) si masca pentru indecsi */
+	unsigned int capacity;
+	unsigned int mask;
+	/* Dimensiunea in octeti a tipului de date stocat in coada */
+	unsigned int data_size;
+	char *buff;
+
+	/* Partea consumatorului */
+	_Alignas(CACHE_LINE_SIZE) atomic_size_t head;
+	size_t cached_tail;
+
+	/* Partea producatorului */
+	_Alignas(CACHE_LINE_SIZE) atomic_size_t tail;
+	size_t cached_head;
+
+	char pad[CACHE_LINE_SIZE - sizeof(atomic_size_t) - sizeof(size_t)];
+};
+
+spsc_queue_t *
+spsc_create(unsigned int data_size, unsigned int min_capacity);
+
+int
+spsc_enqueue(spsc_queue_t *q, const void *new_data);
+
+unsigned int
+spsc_enqueue_n(spsc_queue_t *q, const void *data, unsigned int n);
+
+void *
+spsc_front(spsc_queue_t *q);
+
+int
+spsc_dequeue(spsc_queue_t *q);
+
+unsigned int
+spsc_dequeue_n(spsc_queue_t *q, void *out, unsigned int n);
+
+unsigned int
+spsc_get_size(spsc_queue_t *q);
+
+void
+spsc_free(spsc_queue_t *q);
+
+/*
+ * Coada circulara marginita pentru mai multi producatori si mai multi
+ * consumatori (algoritmul lui Vyukov). Fiecare celula are un numar de
+ * secventa care spune daca e libera pentru runda curenta de enqueue sau
+ * plina pentru runda curenta de dequeue, asa ca un thread face un singur CAS
+ * pe pozitie.
+ */
+typedef struct mpmc_queue_t mpmc_queue_t;
+struct mpmc_queue_t
+{
+	unsigned int capacity;
+	unsigned int mask;
+	unsigned int data_size;
+	/* Distanta in octeti intre doua celule (secventa + date) */
+	size_t cell_size;
+	char *cells;
+
+	_Alignas(CACHE_LINE_SIZE) atomic_size_t enqueue_pos;
+	_Alignas(CACHE_LINE_SIZE) atomic_size_t dequeue_pos;
+
+	char pad[CACHE_LINE_SIZE - sizeof(atomic_size_t)];
+};
+
+mpmc_queue_t *
+mpmc_create(unsigned int data_size, unsigned int min_capacity);
+
+int
+mpmc_enqueue(mpmc_queue_t *q, const void *new_data);
+
+unsigned int
+mpmc_enqueue_n(mpmc_queue_t *q, const void *data, unsigned int n);
+
+int
+mpmc_dequeue(mpmc_queue_t *q, void *out);
+
+unsigned int
+mpmc_dequeue_n(mpmc_queue_t *q, void *out, unsigned int n);
+
+unsigned int
+mpmc_get_size(mpmc_queue_t *q);
+
+void
+mpmc_free(mpmc_queue_t *q);
+
+#endif
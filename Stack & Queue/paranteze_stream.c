@@ -0,0 +1,54 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include "bracket_stream.h"
+
+#define CHUNK_SIZE (1 << 20)
+
+/*
+ * Varianta pentru fluxuri mari a lui paranteze.c: citeste intrarea standard
+ * pe bucati de CHUNK_SIZE octeti si o valideaza pe masura ce o primeste, deci
+ * memoria folosita nu depinde de dimensiunea intrarii.
+ *
+ * Utilizare: ./paranteze_stream [adancime_maxima] < fisier
+ */
+
+static const char *error_names[] = {
+	"ok", "mismatched closer", "closer without opener",
+	"nesting too deep", "unclosed opener",
+};
+
+int main(int argc, char *argv[])
+{
+	static char buf[CHUNK_SIZE];
+	size_t max_depth = argc > 1 ? strtoull(argv[1], NULL, 10) : 0;
+	bracket_validator_t *bv = bv_create(max_depth);
+	ssize_t n;
+
+	while ((n = read(STDIN_FILENO, buf, sizeof(buf))) != 0) {
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			perror("read() failed");
+			bv_free(bv);
+			return 1;
+		}
+
+		/* Dupa prima eroare nu mai are rost sa citim restul */
+		if (!bv_feed(bv, buf, n))
+			break;
+	}
+
+	if (bv_finish(bv)) {
+		printf("balanced\n");
+	} else {
+		printf("not balanced\n");
+		fprintf(stderr, "%s at byte %llu\n", error_names[bv->error],
+				bv->error_offset);
+	}
+
+	bv_free(bv);
+	return 0;
+}
@@ -0,0 +1,231 @@
+#include "ring_queue.h"
+
+/*
+ * Intoarce cea mai mica putere a lui 2 mai mare sau egala cu n (minim 1).
+ */
+static unsigned int
+next_pow2(unsigned int n)
+{
+	unsigned int p = 1;
+
+	while (p < n) {
+		DIE(p > (~0u >> 1), "ring queue capacity overflow\n");
+		p <<= 1;
+	}
+
+	return p;
+}
+
+static inline char *
+slot(ring_queue_t *q, unsigned int idx)
+{
+	return q->buff + (size_t)idx * q->data_size;
+}
+
+/*
+ * Dubleaza capacitatea cozii. Elementele sunt mutate la inceputul noului
+ * buffer, in ordine, cu cel mult doua memcpy-uri.
+ */
+static void
+rq_grow(ring_queue_t *q)
+{
+	unsigned int new_capacity = next_pow2(q->capacity + 1);
+	char *new_buff = malloc((size_t)new_capacity * q->data_size);
+	DIE(!new_buff, "malloc() failed for ring queue growth\n");
+
+	unsigned int first = q->capacity - q->read_idx;
+	if (first > q->size)
+		first = q->size;
+
+	memcpy(new_buff, slot(q, q->read_idx), (size_t)first * q->data_size);
+	memcpy(new_buff + (size_t)first * q->data_size, q->buff,
+		   (size_t)(q->size - first) * q->data_size);
+
+	free(q->buff);
+	q->buff = new_buff;
+	q->capacity = new_capacity;
+	q->mask = new_capacity - 1;
+	q->read_idx = 0;
+	q->write_idx = q->size & q->mask;
+}
+
+/*
+ * Creeaza o coada cu capacitatea cel putin min_capacity, rotunjita la
+ * urmatoarea putere a lui 2. Daca can_grow este nenul, enqueue pe o coada
+ * plina dubleaza capacitatea in loc sa esueze.
+ */
+ring_queue_t *
+rq_create(unsigned int data_size, unsigned int min_capacity, int can_grow)
+{
+	ring_queue_t *q = calloc(1, sizeof(*q));
+	DIE(!q, "calloc() failed for ring queue structure allocation\n");
+
+	q->data_size = data_size;
+	q->capacity = next_pow2(min_capacity);
+	q->mask = q->capacity - 1;
+	q->can_grow = can_grow;
+
+	q->buff = malloc((size_t)q->capacity * data_size);
+	DIE(!q->buff, "malloc() failed for ring queue buffer allocation\n");
+
+	return q;
+}
+
+/*
+ * Functia intoarce numarul de elemente din coada.
+ */
+unsigned int
+rq_get_size(ring_queue_t *q)
+{
+	return !q ? 0 : q->size;
+}
+
+/*
+ * Functia intoarce 1 daca coada este goala si 0 in caz contrar.
+ */
+unsigned int
+rq_is_empty(ring_queue_t *q)
+{
+	return !q ? 1 : !q->size;
+}
+
+/*
+ * Functia intoarce un pointer spre primul element din coada, fara sa il
+ * elimine, sau NULL daca coada este goala. Pointerul ramane valid pana la
+ * urmatorul enqueue.
+ */
+void *
+rq_front(ring_queue_t *q)
+{
+	if (!q || !q->size)
+		return NULL;
+
+	return slot(q, q->read_idx);
+}
+
+/*
+ * Functia scoate un element din coada. Intoarce 1 in caz de succes si 0 daca
+ * coada este goala.
+ */
+int
+rq_dequeue(ring_queue_t *q)
+{
+	if (!q || !q->size)
+		return 0;
+
+	q->read_idx = (q->read_idx + 1) & q->mask;
+	q->size--;
+	return 1;
+}
+
+/*
+ * Functia introduce un nou element in coada. Intoarce 1 in caz de succes si 0
+ * daca coada este plina si nu are voie sa creasca.
+ */
+int
+rq_enqueue(ring_queue_t *q, const void *new_data)
+{
+	if (!q)
+		return 0;
+
+	if (q->size == q->capacity) {
+		if (!q->can_grow)
+			return 0;
+		rq_grow(q);
+	}
+
+	memcpy(slot(q, q->write_idx), new_data, q->data_size);
+	q->write_idx = (q->write_idx + 1) & q->mask;
+	q->size++;
+	return 1;
+}
+
+/*
+ * Introduce n elemente consecutive din data. Copierea se face pe bucati
+ * contigue (cel mult doua memcpy-uri pe buffer). Intoarce numarul de elemente
+ * introduse, care poate fi mai mic decat n doar daca coada nu poate creste.
+ */
+unsigned int
+rq_enqueue_n(ring_queue_t *q, const void *data, unsigned int n)
+{
+	const char *src = data;
+
+	if (!q)
+		return 0;
+
+	if (q->can_grow)
+		while (q->capacity - q->size < n)
+			rq_grow(q);
+
+	if (n > q->capacity - q->size)
+		n = q->capacity - q->size;
+
+	unsigned int first = q->capacity - q->write_idx;
+	if (first > n)
+		first = n;
+
+	memcpy(slot(q, q->write_idx), src, (size_t)first * q->data_size);
+	memcpy(q->buff, src + (size_t)first * q->data_size,
+		   (size_t)(n - first) * q->data_size);
+
+	q->write_idx = (q->write_idx + n) & q->mask;
+	q->size += n;
+	return n;
+}
+
+/*
+ * Scoate cel mult n elemente din coada si le copiaza, in ordine, in out
+ * (daca out nu este NULL). Intoarce numarul de elemente scoase.
+ */
+unsigned int
+rq_dequeue_n(ring_queue_t *q, void *out, unsigned int n)
+{
+	char *dst = out;
+
+	if (!q)
+		return 0;
+
+	if (n > q->size)
+		n = q->size;
+
+	if (dst) {
+		unsigned int first = q->capacity - q->read_idx;
+		if (first > n)
+			first = n;
+
+		memcpy(dst, slot(q, q->read_idx), (size_t)first * q->data_size);
+		memcpy(dst + (size_t)first * q->data_size, q->buff,
+			   (size_t)(n - first) * q->data_size);
+	}
+
+	q->read_idx = (q->read_idx + n) & q->mask;
+	q->size -= n;
+	return n;
+}
+
+/*
+ * Functia elimina toate elementele din coada. Capacitatea ramane neschimbata.
+ */
+void
+rq_clear(ring_queue_t *q)
+{
+	if (!q)
+		return;
+
+	q->read_idx = 0;
+	q->write_idx = 0;
+	q->size = 0;
+}
+
+/*
+ * Functia elibereaza toata memoria ocupata de coada.
+ */
+void
+rq_free(ring_queue_t *q)
+{
+	if (!q)
+		return;
+
+	free(q->buff);
+	free(q);
+}
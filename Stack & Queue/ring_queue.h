@@ -0,0 +1,78 @@
+#ifndef RING_QUEUE_H
+#define RING_QUEUE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#ifndef DIE
+#define DIE(assertion, call_description)				\
+	do {								\
+		if (assertion) {					\
+			fprintf(stderr, "(%s, %d): ",			\
+					__FILE__, __LINE__);		\
+			perror(call_description);			\
+			exit(errno);				        \
+		}							\
+	} while (0)
+#endif
+
+/*
+ * Coada circulara cu stocare contigua: elementele stau unul dupa altul intr-un
+ * singur buffer de data_size * capacity octeti. Capacitatea este intotdeauna
+ * o putere a lui 2, asa ca trecerea de la finalul bufferului la inceput se
+ * face cu o masca in loc de modulo.
+ */
+typedef struct ring_queue_t ring_queue_t;
+struct ring_queue_t
+{
+	/* Capacitatea curenta a cozii (putere a lui 2) */
+	unsigned int capacity;
+	/* capacity - 1, folosit pentru a calcula indecsii */
+	unsigned int mask;
+	/* Dimensiunea cozii */
+	unsigned int size;
+	/* Dimensiunea in octeti a tipului de date stocat in coada */
+	unsigned int data_size;
+	/* Indexul de la care se vor efectua operatiile de front si dequeue */
+	unsigned int read_idx;
+	/* Indexul de la care se vor efectua operatiile de enqueue */
+	unsigned int write_idx;
+	/* 1 daca la umplere coada isi dubleaza capacitatea, 0 altfel */
+	int can_grow;
+	/* Bufferul contiguu ce stocheaza elementele cozii */
+	char *buff;
+};
+
+ring_queue_t *
+rq_create(unsigned int data_size, unsigned int min_capacity, int can_grow);
+
+unsigned int
+rq_get_size(ring_queue_t *q);
+
+unsigned int
+rq_is_empty(ring_queue_t *q);
+
+void *
+rq_front(ring_queue_t *q);
+
+int
+rq_dequeue(ring_queue_t *q);
+
+int
+rq_enqueue(ring_queue_t *q, const void *new_data);
+
+unsigned int
+rq_enqueue_n(ring_queue_t *q, const void *data, unsigned int n);
+
+unsigned int
+rq_dequeue_n(ring_queue_t *q, void *out, unsigned int n);
+
+void
+rq_clear(ring_queue_t *q);
+
+void
+rq_free(ring_queue_t *q);
+
+#endif
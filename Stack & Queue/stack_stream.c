@@ -0,0 +1,278 @@
+#include <string.h>
+#include <unistd.h>
+
+#include "stack_stream.h"
+
+#define RKD_MIN_CAPACITY (1 << 16)
+
+/* --- Buffer de iesire --- */
+
+void
+ob_init(out_buf_t *ob, int fd)
+{
+	ob->fd = fd;
+	ob->len = 0;
+}
+
+void
+ob_flush(out_buf_t *ob)
+{
+	size_t done = 0;
+
+	while (done < ob->len) {
+		ssize_t n = write(ob->fd, ob->buf + done, ob->len - done);
+		if (n < 0 && errno == EINTR)
+			continue;
+		DIE(n < 0, "write() failed\n");
+		done += n;
+	}
+
+	ob->len = 0;
+}
+
+void
+ob_write(out_buf_t *ob, const char *data, size_t len)
+{
+	while (len) {
+		if (ob->len == OUT_BUF_SIZE)
+			ob_flush(ob);
+
+		size_t n = OUT_BUF_SIZE - ob->len;
+		if (n > len)
+			n = len;
+		memcpy(ob->buf + ob->len, data, n);
+		ob->len += n;
+		data += n;
+		len -= n;
+	}
+}
+
+/* --- remove_k_digits --- */
+
+rkd_stream_t *
+rkd_create(unsigned long long k, out_buf_t *out)
+{
+	rkd_stream_t *r = calloc(1, sizeof(*r));
+	DIE(!r, "calloc() failed\n");
+
+	r->k = k;
+	r->out = out;
+	r->capacity = RKD_MIN_CAPACITY;
+	r->stack = malloc(r->capacity);
+	DIE(!r->stack, "malloc() failed\n");
+
+	return r;
+}
+
+/*
+ * Stiva s-a umplut. Daca peste jumatate din ea sunt cifre definitive (sub
+ * ultimele k), le scriem si mutam ultimele k la inceput. Altfel stiva isi
+ * dubleaza capacitatea, deci memoria ramane O(k).
+ */
+static void
+rkd_make_room(rkd_stream_t *r)
+{
+	size_t pending = r->top - r->base;
+
+	if (pending > r->k && pending - r->k >= r->capacity / 2) {
+		size_t final_end = r->top - r->k;
+
+		ob_write(r->out, r->stack + r->base, final_end - r->base);
+		r->emitted = 1;
+		memmove(r->stack, r->stack + final_end, r->k);
+		r->base = 0;
+		r->top = r->k;
+		return;
+	}
+
+	memmove(r->stack, r->stack + r->base, pending);
+	r->base = 0;
+	r->top = pending;
+
+	r->capacity *= 2;
+	r->stack = realloc(r->stack, r->capacity);
+	DIE(!r->stack, "realloc() failed\n");
+}
+
+/*
+ * Proceseaza urmatoarea bucata din numar. Caracterele care nu sunt cifre
+ * (spatii, newline) sunt ignorate.
+ */
+void
+rkd_feed(rkd_stream_t *r, const char *buf, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		char c = buf[i];
+
+		if (c < '0' || c > '9')
+			continue;
+
+		while (r->k && r->top > r->base && r->stack[r->top - 1] > c) {
+			r->top--;
+			r->k--;
+		}
+
+		/* Zerourile de la inceputul rezultatului nu se scriu */
+		if (c == '0' && r->top == r->base && !r->emitted)
+			continue;
+
+		if (r->top == r->capacity)
+			rkd_make_room(r);
+		r->stack[r->top++] = c;
+	}
+}
+
+/*
+ * Elimina cifrele ramase de eliminat din varful stivei si scrie restul,
+ * urmat de newline. Ca in rem_k_digits.c, daca nu ramane nicio cifra se
+ * scrie doar newline-ul.
+ */
+void
+rkd_finish(rkd_stream_t *r)
+{
+	size_t pending = r->top - r->base;
+
+	pending = r->k < pending ? pending - r->k : 0;
+	r->k = 0;
+
+	ob_write(r->out, r->stack + r->base, pending);
+	ob_write(r->out, "\n", 1);
+	ob_flush(r->out);
+
+	r->base = r->top = 0;
+}
+
+void
+rkd_free(rkd_stream_t *r)
+{
+	if (!r)
+		return;
+
+	free(r->stack);
+	free(r);
+}
+
+/* --- removeDuplicates --- */
+
+rdup_stream_t *
+rdup_create(unsigned long long k, out_buf_t *out)
+{
+	rdup_stream_t *r = calloc(1, sizeof(*r));
+	DIE(!r, "calloc() failed\n");
+
+	r->k = k;
+	r->out = out;
+	r->capacity = 1024;
+	r->runs = malloc(r->capacity * sizeof(*r->runs));
+	DIE(!r->runs, "malloc() failed\n");
+
+	return r;
+}
+
+/*
+ * Proceseaza urmatoarea bucata din sir. Spatiile albe sunt ignorate. Cand
+ * secventa din varf ajunge la k caractere, este scoasa de pe stiva. Pentru
+ * k = 0 nu se elimina nimic.
+ */
+void
+rdup_feed(rdup_stream_t *r, const char *buf, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		char c = buf[i];
+
+		if ((unsigned char)c <= ' ')
+			continue;
+
+		if (r->size && r->runs[r->size - 1].ch == c) {
+			if (++r->runs[r->size - 1].count == r->k)
+				r->size--;
+			continue;
+		}
+
+		if (r->size == r->capacity) {
+			r->capacity *= 2;
+			r->runs = realloc(r->runs, r->capacity * sizeof(*r->runs));
+			DIE(!r->runs, "realloc() failed\n");
+		}
+
+		r->runs[r->size].ch = c;
+		r->runs[r->size].count = 1;
+		if (r->k == 1)
+			continue;
+		r->size++;
+	}
+}
+
+/*
+ * Scrie secventele ramase, de la baza stivei spre varf, urmate de newline.
+ */
+void
+rdup_finish(rdup_stream_t *r)
+{
+	char run[256];
+
+	for (size_t i = 0; i < r->size; i++) {
+		unsigned long long count = r->runs[i].count;
+
+		memset(run, r->runs[i].ch, count < sizeof(run) ? count : sizeof(run));
+		while (count) {
+			size_t n = count < sizeof(run) ? count : sizeof(run);
+			ob_write(r->out, run, n);
+			count -= n;
+		}
+	}
+
+	ob_write(r->out, "\n", 1);
+	ob_flush(r->out);
+	r->size = 0;
+}
+
+void
+rdup_free(rdup_stream_t *r)
+{
+	if (!r)
+		return;
+
+	free(r->runs);
+	free(r);
+}
+
+/*
+ * Citeste din fd numarul k de la inceputul intrarii (formatul programelor
+ * originale: k, apoi sirul). Octetii cititi dupa k raman in
+ * buf[*rest_off .. *rest_off + *rest_len) si trebuie dati motorului. Intoarce
+ * 1 daca k a fost citit si 0 altfel.
+ */
+int
+stream_read_k(int fd, unsigned long long *k, char *buf, size_t cap,
+			  size_t *rest_off, size_t *rest_len)
+{
+	int in_number = 0;
+
+	*k = 0;
+	*rest_off = 0;
+	*rest_len = 0;
+	for (;;) {
+		ssize_t n = read(fd, buf, cap);
+		if (n < 0 && errno == EINTR)
+			continue;
+		DIE(n < 0, "read() failed\n");
+		if (n == 0)
+			return in_number;
+
+		for (ssize_t i = 0; i < n; i++) {
+			char c = buf[i];
+
+			if (c >= '0' && c <= '9') {
+				*k = *k * 10 + (c - '0');
+				in_number = 1;
+			} else if (in_number) {
+				*rest_off = i;
+				*rest_len = n - i;
+				return 1;
+			} else if ((unsigned char)c > ' ') {
+				return 0;
+			}
+		}
+	}
+}
@@ -0,0 +1,120 @@
+#ifndef STACK_STREAM_H
+#define STACK_STREAM_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <errno.h>
+
+#ifndef DIE
+#define DIE(assertion, call_description)				\
+	do {								\
+		if (assertion) {					\
+			fprintf(stderr, "(%s, %d): ",			\
+					__FILE__, __LINE__);		\
+			perror(call_description);			\
+			exit(errno);				        \
+		}							\
+	} while (0)
+#endif
+
+/*
+ * Variante pentru fluxuri mari ale lui remove_k_digits (rem_k_digits.c) si
+ * removeDuplicates (duplicates_stack.c). Intrarea se da pe bucati (*_feed),
+ * stiva este un vector contiguu, iar rezultatul se scrie direct intr-un
+ * file descriptor printr-un buffer de iesire, fara sa se construiasca un sir
+ * intermediar. Fiecare caracter este pus si scos de pe stiva cel mult o
+ * data, deci timpul total este O(n).
+ */
+
+#define OUT_BUF_SIZE (1 << 16)
+
+typedef struct out_buf_t out_buf_t;
+struct out_buf_t
+{
+	int fd;
+	size_t len;
+	char buf[OUT_BUF_SIZE];
+};
+
+void
+ob_init(out_buf_t *ob, int fd);
+
+void
+ob_write(out_buf_t *ob, const char *data, size_t len);
+
+void
+ob_flush(out_buf_t *ob);
+
+/*
+ * Stiva monotona pentru remove_k_digits. Cum mai pot urma cel mult k
+ * eliminari, doar ultimele k cifre de pe stiva se mai pot schimba; cele de
+ * sub ele sunt definitive si se scriu imediat. Memoria este O(k), nu O(n).
+ */
+typedef struct rkd_stream_t rkd_stream_t;
+struct rkd_stream_t
+{
+	/* Cate cifre mai pot fi eliminate */
+	unsigned long long k;
+	/* Cifrele in asteptare sunt stack[base..top) */
+	char *stack;
+	size_t base;
+	size_t top;
+	size_t capacity;
+	/* 1 dupa prima cifra scrisa (de aici zerourile nu mai sunt initiale) */
+	int emitted;
+	out_buf_t *out;
+};
+
+rkd_stream_t *
+rkd_create(unsigned long long k, out_buf_t *out);
+
+void
+rkd_feed(rkd_stream_t *r, const char *buf, size_t len);
+
+void
+rkd_finish(rkd_stream_t *r);
+
+void
+rkd_free(rkd_stream_t *r);
+
+/*
+ * Stiva de secvente (caracter, numar de aparitii consecutive) pentru
+ * removeDuplicates. O secventa de sub varful stivei poate redeveni varf si
+ * se poate uni cu caractere care vin mai tarziu, asa ca rezultatul se scrie
+ * abia la final; stiva are insa cate un element pe secventa, nu pe caracter.
+ */
+typedef struct dup_run_t dup_run_t;
+struct dup_run_t
+{
+	unsigned long long count;
+	char ch;
+};
+
+typedef struct rdup_stream_t rdup_stream_t;
+struct rdup_stream_t
+{
+	unsigned long long k;
+	dup_run_t *runs;
+	size_t size;
+	size_t capacity;
+	out_buf_t *out;
+};
+
+rdup_stream_t *
+rdup_create(unsigned long long k, out_buf_t *out);
+
+void
+rdup_feed(rdup_stream_t *r, const char *buf, size_t len);
+
+void
+rdup_finish(rdup_stream_t *r);
+
+void
+rdup_free(rdup_stream_t *r);
+
+int
+stream_read_k(int fd, unsigned long long *k, char *buf, size_t cap,
+			  size_t *rest_off, size_t *rest_len);
+
+#endif
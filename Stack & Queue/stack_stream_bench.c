@@ -0,0 +1,73 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "stack_stream.h"
+
+/*
+ * Masoara motoarele din stack_stream.c pe un sir generat de n caractere
+ * (implicit 10^8), dat pe bucati de CHUNK_SIZE octeti, cu iesirea in
+ * /dev/null.
+ *
+ * Utilizare: ./stack_stream_bench [n] [k_cifre] [k_duplicate]
+ */
+
+#define CHUNK_SIZE (1 << 20)
+
+static double
+now_sec(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char *argv[])
+{
+	static out_buf_t out;
+	size_t n = argc > 1 ? strtoull(argv[1], NULL, 10) : 100000000;
+	unsigned long long k_digits = argc > 2 ? strtoull(argv[2], NULL, 10)
+										   : n / 2;
+	unsigned long long k_dups = argc > 3 ? strtoull(argv[3], NULL, 10) : 3;
+
+	char *input = malloc(n);
+	DIE(!input, "malloc() failed\n");
+	int null_fd = open("/dev/null", O_WRONLY);
+	DIE(null_fd < 0, "open() failed\n");
+	ob_init(&out, null_fd);
+
+	srand(42);
+	for (size_t i = 0; i < n; i++)
+		input[i] = '0' + rand() % 10;
+
+	double start = now_sec();
+	rkd_stream_t *rkd = rkd_create(k_digits, &out);
+	for (size_t off = 0; off < n; off += CHUNK_SIZE)
+		rkd_feed(rkd, input + off, n - off < CHUNK_SIZE ? n - off : CHUNK_SIZE);
+	rkd_finish(rkd);
+	double elapsed = now_sec() - start;
+	printf("remove_k_digits: n=%zu k=%llu %.3f s (%.1f MB/s), stack %zu B\n",
+		   n, k_digits, elapsed, n / elapsed / 1e6, rkd->capacity);
+	rkd_free(rkd);
+
+	for (size_t i = 0; i < n; i++)
+		input[i] = 'a' + rand() % 3;
+
+	start = now_sec();
+	rdup_stream_t *rdup = rdup_create(k_dups, &out);
+	for (size_t off = 0; off < n; off += CHUNK_SIZE)
+		rdup_feed(rdup, input + off, n - off < CHUNK_SIZE ? n - off : CHUNK_SIZE);
+	size_t runs_left = rdup->size;
+	rdup_finish(rdup);
+	elapsed = now_sec() - start;
+	printf("removeDuplicates: n=%zu k=%llu %.3f s (%.1f MB/s), %zu runs left\n",
+		   n, k_dups, elapsed, n / elapsed / 1e6, runs_left);
+	rdup_free(rdup);
+
+	close(null_fd);
+	free(input);
+	return 0;
+}
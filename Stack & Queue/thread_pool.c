@@ -0,0 +1,348 @@
+#define _GNU_SOURCE
+#include <unistd.h>
+
+#include "thread_pool.h"
+
+typedef struct tp_task_t tp_task_t;
+struct tp_task_t
+{
+	tp_task_fn fn;
+	void *arg;
+	tp_group_t *group;
+};
+
+typedef struct tp_range_t tp_range_t;
+struct tp_range_t
+{
+	thread_pool_t *pool;
+	tp_group_t *group;
+	tp_range_fn body;
+	void *arg;
+	long lo, hi, grain;
+};
+
+/* Worker-ul care ruleaza pe thread-ul curent (NULL in afara pool-urilor) */
+static __thread tp_worker_t *current_worker;
+
+static tp_worker_t *
+self_in(thread_pool_t *tp)
+{
+	return current_worker && current_worker->pool == tp ? current_worker
+														: NULL;
+}
+
+/*
+ * Anunta thread-urile adormite ca s-a schimbat ceva (task nou, grup terminat,
+ * oprire). Incrementarea lui epoch si citirea lui sleepers se combina cu
+ * ordinea inversa din sleep_until_epoch_changes, asa ca nicio trezire nu se
+ * pierde.
+ */
+static void
+notify(thread_pool_t *tp, int all)
+{
+	atomic_fetch_add(&tp->epoch, 1);
+
+	if (atomic_load(&tp->sleepers)) {
+		pthread_mutex_lock(&tp->lock);
+		if (all)
+			pthread_cond_broadcast(&tp->wake);
+		else
+			pthread_cond_signal(&tp->wake);
+		pthread_mutex_unlock(&tp->lock);
+	}
+}
+
+static void
+sleep_until_epoch_changes(thread_pool_t *tp, unsigned long epoch,
+						  tp_group_t *g)
+{
+	pthread_mutex_lock(&tp->lock);
+	atomic_fetch_add(&tp->sleepers, 1);
+	while (atomic_load(&tp->epoch) == epoch && !atomic_load(&tp->shutdown)
+		   && (!g || atomic_load(&g->pending) > 0))
+		pthread_cond_wait(&tp->wake, &tp->lock);
+	atomic_fetch_sub(&tp->sleepers, 1);
+	pthread_mutex_unlock(&tp->lock);
+}
+
+/*
+ * Cauta un task: intai in deque-ul propriu, apoi in coada comuna, apoi fura
+ * de la ceilalti workeri, incepand cu o victima aleatoare.
+ */
+static tp_task_t *
+find_task(thread_pool_t *tp, tp_worker_t *self)
+{
+	tp_task_t *task = NULL;
+
+	if (self && (task = wsd_pop(self->deque)))
+		return task;
+
+	if (atomic_load_explicit(&tp->inject_size, memory_order_relaxed)) {
+		pthread_mutex_lock(&tp->inject_lock);
+		if (!rq_is_empty(tp->inject)) {
+			task = *(tp_task_t **)rq_front(tp->inject);
+			rq_dequeue(tp->inject);
+			atomic_fetch_sub(&tp->inject_size, 1);
+		}
+		pthread_mutex_unlock(&tp->inject_lock);
+		if (task)
+			return task;
+	}
+
+	unsigned int start = self ? rand_r(&self->seed) : 0;
+	for (int i = 0; i < tp->nthreads; i++) {
+		tp_worker_t *victim = &tp->workers[(start + i) % tp->nthreads];
+		if (victim == self)
+			continue;
+		if ((task = wsd_steal(victim->deque)))
+			return task;
+	}
+
+	return NULL;
+}
+
+static void
+run_task(thread_pool_t *tp, tp_task_t *task)
+{
+	tp_group_t *g = task->group;
+
+	task->fn(task->arg);
+	free(task);
+
+	if (atomic_fetch_sub(&g->pending, 1) == 1)
+		notify(tp, 1);
+}
+
+static void *
+worker_main(void *arg)
+{
+	tp_worker_t *self = arg;
+	thread_pool_t *tp = self->pool;
+
+	current_worker = self;
+
+	while (!atomic_load(&tp->shutdown)) {
+		tp_task_t *task = find_task(tp, self);
+		if (task) {
+			run_task(tp, task);
+			continue;
+		}
+
+		unsigned long epoch = atomic_load(&tp->epoch);
+		task = find_task(tp, self);
+		if (task) {
+			run_task(tp, task);
+			continue;
+		}
+
+		sleep_until_epoch_changes(tp, epoch, NULL);
+	}
+
+	return NULL;
+}
+
+/*
+ * Porneste nthreads workeri (daca nthreads <= 0, cate un worker pe fiecare
+ * procesor disponibil).
+ */
+thread_pool_t *
+tp_create(int nthreads)
+{
+	if (nthreads <= 0)
+		nthreads = sysconf(_SC_NPROCESSORS_ONLN);
+	if (nthreads <= 0)
+		nthreads = 1;
+
+	thread_pool_t *tp = calloc(1, sizeof(*tp));
+	DIE(!tp, "calloc() failed for thread pool\n");
+
+	tp->nthreads = nthreads;
+	tp->inject = rq_create(sizeof(tp_task_t *), 64, 1);
+	pthread_mutex_init(&tp->inject_lock, NULL);
+	pthread_mutex_init(&tp->lock, NULL);
+	pthread_cond_init(&tp->wake, NULL);
+	atomic_init(&tp->inject_size, 0);
+	atomic_init(&tp->epoch, 0);
+	atomic_init(&tp->sleepers, 0);
+	atomic_init(&tp->shutdown, 0);
+
+	tp->workers = calloc(nthreads, sizeof(*tp->workers));
+	DIE(!tp->workers, "calloc() failed for workers\n");
+
+	for (int i = 0; i < nthreads; i++) {
+		tp->workers[i].pool = tp;
+		tp->workers[i].deque = wsd_create(256);
+		tp->workers[i].seed = 0x9e3779b9u * (i + 1);
+		tp->workers[i].id = i;
+	}
+
+	for (int i = 0; i < nthreads; i++)
+		DIE(pthread_create(&tp->workers[i].tid, NULL, worker_main,
+						   &tp->workers[i]),
+			"pthread_create() failed\n");
+
+	return tp;
+}
+
+int
+tp_get_threads(thread_pool_t *tp)
+{
+	return tp->nthreads;
+}
+
+/*
+ * Intoarce indexul workerului curent, intre 0 si nthreads - 1, sau nthreads
+ * daca apelantul nu face parte din pool (thread-ul care a trimis lucrul si
+ * il asteapta). Util pentru buffere alocate per thread, de nthreads + 1.
+ */
+int
+tp_worker_id(thread_pool_t *tp)
+{
+	tp_worker_t *self = self_in(tp);
+
+	return self ? self->id : tp->nthreads;
+}
+
+void
+tp_group_init(tp_group_t *g)
+{
+	atomic_init(&g->pending, 0);
+}
+
+/*
+ * Programeaza fn(arg) ca parte din grupul g.
+ */
+void
+tp_spawn(thread_pool_t *tp, tp_group_t *g, tp_task_fn fn, void *arg)
+{
+	tp_worker_t *self = self_in(tp);
+	tp_task_t *task = malloc(sizeof(*task));
+	DIE(!task, "malloc() failed for task\n");
+
+	task->fn = fn;
+	task->arg = arg;
+	task->group = g;
+	atomic_fetch_add(&g->pending, 1);
+
+	if (self) {
+		wsd_push(self->deque, task);
+	} else {
+		pthread_mutex_lock(&tp->inject_lock);
+		rq_enqueue(tp->inject, &task);
+		atomic_fetch_add(&tp->inject_size, 1);
+		pthread_mutex_unlock(&tp->inject_lock);
+	}
+
+	notify(tp, 0);
+}
+
+/*
+ * Asteapta terminarea tuturor task-urilor din g, executand intre timp
+ * task-uri disponibile. Poate fi apelata si din interiorul unui task.
+ */
+void
+tp_group_wait(thread_pool_t *tp, tp_group_t *g)
+{
+	tp_worker_t *self = self_in(tp);
+
+	while (atomic_load(&g->pending) > 0) {
+		tp_task_t *task = find_task(tp, self);
+		if (task) {
+			run_task(tp, task);
+			continue;
+		}
+
+		unsigned long epoch = atomic_load(&tp->epoch);
+		if (atomic_load(&g->pending) == 0)
+			break;
+		task = find_task(tp, self);
+		if (task) {
+			run_task(tp, task);
+			continue;
+		}
+
+		sleep_until_epoch_changes(tp, epoch, g);
+	}
+}
+
+/*
+ * Imparte intervalul in doua cat timp e mai mare decat grain; jumatatea din
+ * dreapta devine un task nou (care poate fi furat), iar cea din stanga se
+ * continua pe loc.
+ */
+static void
+range_task(void *p)
+{
+	tp_range_t *r = p;
+
+	while (r->hi - r->lo > r->grain) {
+		long mid = r->lo + (r->hi - r->lo) / 2;
+		tp_range_t *right = malloc(sizeof(*right));
+		DIE(!right, "malloc() failed for range task\n");
+
+		*right = *r;
+		right->lo = mid;
+		r->hi = mid;
+		tp_spawn(r->pool, r->group, range_task, right);
+	}
+
+	r->body(r->arg, r->lo, r->hi);
+	free(r);
+}
+
+/*
+ * Apeleaza body(arg, lo, hi) pe bucati disjuncte care acopera [begin, end),
+ * fiecare de cel mult grain elemente, si asteapta sa se termine toate.
+ */
+void
+tp_parallel_for(thread_pool_t *tp, long begin, long end, long grain,
+				tp_range_fn body, void *arg)
+{
+	tp_group_t g;
+
+	if (begin >= end)
+		return;
+	if (grain < 1)
+		grain = 1;
+
+	tp_range_t *r = malloc(sizeof(*r));
+	DIE(!r, "malloc() failed for range task\n");
+	r->pool = tp;
+	r->group = &g;
+	r->body = body;
+	r->arg = arg;
+	r->lo = begin;
+	r->hi = end;
+	r->grain = grain;
+
+	tp_group_init(&g);
+	tp_spawn(tp, &g, range_task, r);
+	tp_group_wait(tp, &g);
+}
+
+/*
+ * Opreste workerii si elibereaza pool-ul. Toate grupurile trebuie sa fi fost
+ * asteptate inainte.
+ */
+void
+tp_free(thread_pool_t *tp)
+{
+	if (!tp)
+		return;
+
+	atomic_store(&tp->shutdown, 1);
+	notify(tp, 1);
+
+	for (int i = 0; i < tp->nthreads; i++)
+		pthread_join(tp->workers[i].tid, NULL);
+
+	for (int i = 0; i < tp->nthreads; i++)
+		wsd_free(tp->workers[i].deque);
+	free(tp->workers);
+
+	rq_free(tp->inject);
+	pthread_mutex_destroy(&tp->inject_lock);
+	pthread_mutex_destroy(&tp->lock);
+	pthread_cond_destroy(&tp->wake);
+	free(tp);
+}
@@ -0,0 +1,87 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "ring_queue.h"
+#include "ws_deque.h"
+
+/*
+ * Pool de thread-uri cu work stealing. Fiecare worker are un deque Chase-Lev:
+ * task-urile create de un worker ajung in deque-ul lui si sunt executate
+ * LIFO, iar un worker fara treaba fura task-uri vechi (FIFO) de la ceilalti.
+ * Task-urile trimise din afara pool-ului trec printr-o coada comuna.
+ *
+ * Task-urile se grupeaza in tp_group_t; tp_group_wait asteapta terminarea
+ * tuturor task-urilor unui grup si, intre timp, executa si el task-uri, asa
+ * ca un task poate crea si astepta sub-task-uri (DFS/BFS paralel, parcurgeri
+ * de arbori).
+ */
+
+typedef void (*tp_task_fn)(void *arg);
+typedef void (*tp_range_fn)(void *arg, long lo, long hi);
+
+typedef struct tp_group_t tp_group_t;
+struct tp_group_t
+{
+	/* Numarul de task-uri din grup care nu s-au terminat inca */
+	atomic_long pending;
+};
+
+typedef struct thread_pool_t thread_pool_t;
+
+typedef struct tp_worker_t tp_worker_t;
+struct tp_worker_t
+{
+	thread_pool_t *pool;
+	ws_deque_t *deque;
+	pthread_t tid;
+	unsigned int seed;
+	int id;
+};
+
+struct thread_pool_t
+{
+	int nthreads;
+	tp_worker_t *workers;
+
+	/* Coada pentru task-urile trimise din afara pool-ului */
+	ring_queue_t *inject;
+	pthread_mutex_t inject_lock;
+	atomic_uint inject_size;
+
+	/* Adormirea si trezirea thread-urilor fara treaba */
+	pthread_mutex_t lock;
+	pthread_cond_t wake;
+	atomic_ulong epoch;
+	atomic_int sleepers;
+	atomic_int shutdown;
+};
+
+thread_pool_t *
+tp_create(int nthreads);
+
+int
+tp_get_threads(thread_pool_t *tp);
+
+int
+tp_worker_id(thread_pool_t *tp);
+
+void
+tp_group_init(tp_group_t *g);
+
+void
+tp_spawn(thread_pool_t *tp, tp_group_t *g, tp_task_fn fn, void *arg);
+
+void
+tp_group_wait(thread_pool_t *tp, tp_group_t *g);
+
+void
+tp_parallel_for(thread_pool_t *tp, long begin, long end, long grain,
+				tp_range_fn body, void *arg);
+
+void
+tp_free(thread_pool_t *tp);
+
+#endif
@@ -0,0 +1,117 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "thread_pool.h"
+
+/*
+ * Doua exemple pentru pool-ul cu work stealing:
+ *  - o recursie binara (ca parcurgerea unui arbore binar), in care fiecare
+ *    nod isi creeaza subarborele stang ca task si il parcurge pe cel drept
+ *    pe loc, apoi asteapta;
+ *  - o suma pe un vector mare, impartita cu tp_parallel_for.
+ *
+ * Utilizare: ./thread_pool_demo [thread-uri] [adancime] [n]
+ */
+
+#define SEQ_DEPTH 10
+
+typedef struct {
+	thread_pool_t *tp;
+	int depth;
+	long count;
+} subtree_t;
+
+static long
+count_seq(int depth)
+{
+	return depth <= 0 ? 1 : 1 + count_seq(depth - 1) + count_seq(depth - 1);
+}
+
+/* Numara nodurile unui arbore binar complet de adancimea data */
+static void
+count_nodes(void *arg)
+{
+	subtree_t *st = arg;
+
+	if (st->depth <= SEQ_DEPTH) {
+		st->count = count_seq(st->depth);
+		return;
+	}
+
+	tp_group_t g;
+	subtree_t left = { st->tp, st->depth - 1, 0 };
+	subtree_t right = { st->tp, st->depth - 1, 0 };
+
+	tp_group_init(&g);
+	tp_spawn(st->tp, &g, count_nodes, &left);
+	count_nodes(&right);
+	tp_group_wait(st->tp, &g);
+
+	st->count = 1 + left.count + right.count;
+}
+
+typedef struct {
+	const int *v;
+	atomic_long sum;
+} sum_arg_t;
+
+static void
+sum_range(void *arg, long lo, long hi)
+{
+	sum_arg_t *sa = arg;
+	long s = 0;
+
+	for (long i = lo; i < hi; i++)
+		s += sa->v[i];
+
+	atomic_fetch_add(&sa->sum, s);
+}
+
+static double
+now_sec(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char *argv[])
+{
+	int threads = argc > 1 ? atoi(argv[1]) : 0;
+	int depth = argc > 2 ? atoi(argv[2]) : 22;
+	long n = argc > 3 ? atol(argv[3]) : 10000000;
+
+	thread_pool_t *tp = tp_create(threads);
+
+	double start = now_sec();
+	subtree_t root = { tp, depth, 0 };
+	tp_group_t g;
+	tp_group_init(&g);
+	tp_spawn(tp, &g, count_nodes, &root);
+	tp_group_wait(tp, &g);
+	printf("tree nodes: %ld (expected %ld), %.3f s on %d threads\n",
+		   root.count, (1L << (depth + 1)) - 1, now_sec() - start,
+		   tp_get_threads(tp));
+
+	int *v = malloc(n * sizeof(*v));
+	DIE(!v, "malloc() failed\n");
+	for (long i = 0; i < n; i++)
+		v[i] = i % 7;
+
+	sum_arg_t sa = { .v = v };
+	atomic_init(&sa.sum, 0);
+	start = now_sec();
+	tp_parallel_for(tp, 0, n, 1 << 16, sum_range, &sa);
+
+	long expected = 0;
+	for (long i = 0; i < n; i++)
+		expected += v[i];
+	printf("sum: %ld (expected %ld), %.3f s\n", atomic_load(&sa.sum),
+		   expected, now_sec() - start);
+
+	free(v);
+	tp_free(tp);
+	return 0;
+}
@@ -0,0 +1,164 @@
+#include "ws_deque.h"
+
+static ws_array_t *
+ws_array_create(long size)
+{
+	ws_array_t *a = malloc(sizeof(*a) + size * sizeof(a->buff[0]));
+	DIE(!a, "malloc() failed for work-stealing array\n");
+
+	a->size = size;
+	a->mask = size - 1;
+	a->prev = NULL;
+
+	return a;
+}
+
+/*
+ * Creeaza un deque gol cu capacitatea initiala cel putin min_capacity,
+ * rotunjita la o putere a lui 2.
+ */
+ws_deque_t *
+wsd_create(long min_capacity)
+{
+	long size = 2;
+
+	while (size < min_capacity)
+		size <<= 1;
+
+	ws_deque_t *d = aligned_alloc(CACHE_LINE_SIZE, sizeof(*d));
+	DIE(!d, "aligned_alloc() failed for work-stealing deque\n");
+	memset(d, 0, sizeof(*d));
+
+	atomic_init(&d->top, 0);
+	atomic_init(&d->bottom, 0);
+	atomic_init(&d->array, ws_array_create(size));
+
+	return d;
+}
+
+/*
+ * Dubleaza bufferul, copiind elementele din intervalul [top, bottom).
+ */
+static ws_array_t *
+wsd_grow(ws_deque_t *d, ws_array_t *a, long top, long bottom)
+{
+	ws_array_t *bigger = ws_array_create(a->size * 2);
+
+	for (long i = top; i < bottom; i++)
+		atomic_store_explicit(&bigger->buff[i & bigger->mask],
+			atomic_load_explicit(&a->buff[i & a->mask], memory_order_relaxed),
+			memory_order_relaxed);
+
+	bigger->prev = a;
+	atomic_store_explicit(&d->array, bigger, memory_order_release);
+
+	return bigger;
+}
+
+/*
+ * Apelata doar de proprietar: adauga item la capatul bottom.
+ */
+void
+wsd_push(ws_deque_t *d, void *item)
+{
+	long b = atomic_load_explicit(&d->bottom, memory_order_relaxed);
+	long t = atomic_load_explicit(&d->top, memory_order_acquire);
+	ws_array_t *a = atomic_load_explicit(&d->array, memory_order_relaxed);
+
+	if (b - t > a->size - 1)
+		a = wsd_grow(d, a, t, b);
+
+	atomic_store_explicit(&a->buff[b & a->mask], item, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+}
+
+/*
+ * Apelata doar de proprietar: scoate elementul de la capatul bottom (ultimul
+ * adaugat) sau intoarce NULL daca deque-ul este gol. Doar cand a ramas un
+ * singur element proprietarul concureaza cu hotii printr-un CAS pe top.
+ */
+void *
+wsd_pop(ws_deque_t *d)
+{
+	long b = atomic_load_explicit(&d->bottom, memory_order_relaxed) - 1;
+	ws_array_t *a = atomic_load_explicit(&d->array, memory_order_relaxed);
+	void *item = NULL;
+
+	atomic_store_explicit(&d->bottom, b, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+	long t = atomic_load_explicit(&d->top, memory_order_relaxed);
+
+	if (t <= b) {
+		item = atomic_load_explicit(&a->buff[b & a->mask],
+									memory_order_relaxed);
+		if (t == b) {
+			if (!atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1,
+					memory_order_seq_cst, memory_order_relaxed))
+				item = NULL;
+			atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+		}
+	} else {
+		atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+	}
+
+	return item;
+}
+
+/*
+ * Poate fi apelata de orice thread: fura elementul de la capatul top (cel mai
+ * vechi). Intoarce NULL daca deque-ul este gol sau daca alt thread a luat
+ * elementul intre timp; apelantul poate incerca alta victima.
+ */
+void *
+wsd_steal(ws_deque_t *d)
+{
+	long t = atomic_load_explicit(&d->top, memory_order_acquire);
+	atomic_thread_fence(memory_order_seq_cst);
+	long b = atomic_load_explicit(&d->bottom, memory_order_acquire);
+
+	if (t >= b)
+		return NULL;
+
+	ws_array_t *a = atomic_load_explicit(&d->array, memory_order_acquire);
+	void *item = atomic_load_explicit(&a->buff[t & a->mask],
+									  memory_order_relaxed);
+
+	if (!atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1,
+			memory_order_seq_cst, memory_order_relaxed))
+		return NULL;
+
+	return item;
+}
+
+/*
+ * Numarul aproximativ de elemente din deque.
+ */
+long
+wsd_get_size(ws_deque_t *d)
+{
+	long b = atomic_load_explicit(&d->bottom, memory_order_relaxed);
+	long t = atomic_load_explicit(&d->top, memory_order_relaxed);
+
+	return b > t ? b - t : 0;
+}
+
+/*
+ * Elibereaza deque-ul si toate bufferele alocate de-a lungul timpului.
+ * Niciun thread nu mai are voie sa il foloseasca.
+ */
+void
+wsd_free(ws_deque_t *d)
+{
+	if (!d)
+		return;
+
+	ws_array_t *a = atomic_load(&d->array);
+	while (a) {
+		ws_array_t *prev = a->prev;
+		free(a);
+		a = prev;
+	}
+
+	free(d);
+}
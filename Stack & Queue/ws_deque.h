@@ -0,0 +1,72 @@
+#ifndef WS_DEQUE_H
+#define WS_DEQUE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <errno.h>
+
+#ifndef DIE
+#define DIE(assertion, call_description)				\
+	do {								\
+		if (assertion) {					\
+			fprintf(stderr, "(%s, %d): ",			\
+					__FILE__, __LINE__);		\
+			perror(call_description);			\
+			exit(errno);				        \
+		}							\
+	} while (0)
+#endif
+
+#ifndef CACHE_LINE_SIZE
+#define CACHE_LINE_SIZE 64
+#endif
+
+/*
+ * Bufferul circular al deque-ului. Cand se umple, proprietarul aloca unul de
+ * doua ori mai mare; cel vechi ramane legat prin prev pana la wsd_free,
+ * pentru ca un thread care fura poate inca sa citeasca din el.
+ */
+typedef struct ws_array_t ws_array_t;
+struct ws_array_t
+{
+	long size;
+	long mask;
+	ws_array_t *prev;
+	_Atomic(void *) buff[];
+};
+
+/*
+ * Deque Chase-Lev pentru work stealing. Proprietarul (un singur thread) face
+ * push si pop la capatul bottom, fara CAS in cazul obisnuit, iar orice alt
+ * thread poate fura de la capatul top. Elementele sunt pointeri nenuli.
+ */
+typedef struct ws_deque_t ws_deque_t;
+struct ws_deque_t
+{
+	_Alignas(CACHE_LINE_SIZE) atomic_long top;
+	_Alignas(CACHE_LINE_SIZE) atomic_long bottom;
+	_Atomic(ws_array_t *) array;
+	char pad[CACHE_LINE_SIZE - sizeof(atomic_long) - sizeof(void *)];
+};
+
+ws_deque_t *
+wsd_create(long min_capacity);
+
+void
+wsd_push(ws_deque_t *d, void *item);
+
+void *
+wsd_pop(ws_deque_t *d);
+
+void *
+wsd_steal(ws_deque_t *d);
+
+long
+wsd_get_size(ws_deque_t *d);
+
+void
+wsd_free(ws_deque_t *d);
+
+#endif